@@ -0,0 +1,163 @@
+// Compile with:
+// clang++ -o demoAccessorAllocationBenchmark demoAccessorAllocationBenchmark.cpp -L../build/ -I ../include/ -l diamonds -stdlib=libc++ -std=c++11 -Wno-deprecated-register
+//
+// Counts the heap allocations done when accessing the results of the nesting process.
+// A short nested sampling of a single 2D Gaussian is run first. Then the number of allocations
+// is measured for the per-iteration path of the live points reducer, for the post-processing
+// of the Results class, and for a copy of the posterior sample compared to a constant reference to it.
+// Allocations are counted by intercepting malloc, which is only possible with the GNU C library.
+// On other systems only the computational times are meaningful.
+//
+
+#include <cstdlib>
+#include <iostream>
+#include <iomanip>
+#include <ctime>
+#include "MultiEllipsoidSampler.h"
+#include "KmeansClusterer.h"
+#include "EuclideanMetric.h"
+#include "UniformPrior.h"
+#include "Results.h"
+#include "ZeroModel.h"
+#include "FerozReducer.h"
+#include "PowerlawReducer.h"
+#include "demoSingle2DGaussian.h"
+#include "PrincipalComponentProjector.h"
+
+using namespace std;
+
+
+// Count the allocations by wrapping the allocation functions of the C library, which are also the
+// ones used by Eigen and by the default operator new.
+
+static unsigned long Nallocations = 0;
+
+#ifdef __GLIBC__
+extern "C"
+{
+    void *__libc_malloc(size_t size);
+    void *__libc_calloc(size_t Nelements, size_t size);
+    void *__libc_realloc(void *pointer, size_t size);
+
+    void *malloc(size_t size)
+    {
+        ++Nallocations;
+        return __libc_malloc(size);
+    }
+
+    void *calloc(size_t Nelements, size_t size)
+    {
+        ++Nallocations;
+        return __libc_calloc(Nelements, size);
+    }
+
+    void *realloc(void *pointer, size_t size)
+    {
+        ++Nallocations;
+        return __libc_realloc(pointer, size);
+    }
+}
+#endif
+
+
+void printMeasurement(const string label, const unsigned long NallocationsAtStart, const clock_t startTime, const int Nrepetitions)
+{
+    double time = (clock() - startTime)/double(CLOCKS_PER_SEC);
+    cerr << setw(40) << left << label << right
+         << setw(16) << (Nallocations - NallocationsAtStart)/double(Nrepetitions)
+         << setw(16) << 1.e6*time/Nrepetitions << endl;
+}
+
+
+int main()
+{
+    // Run a short nested sampling to fill the live and the posterior samples
+
+    ArrayXd covariates;
+    ArrayXd observations;
+    ZeroModel model(covariates);
+
+    int Ndimensions = 2;
+    vector<Prior*> ptrPriors(1);
+    ArrayXd parametersMinima(Ndimensions);
+    ArrayXd parametersMaxima(Ndimensions);
+    parametersMinima <<  0.0, 10.0;
+    parametersMaxima << 20.0, 30.0;
+    UniformPrior uniformPrior(parametersMinima, parametersMaxima);
+    ptrPriors[0] = &uniformPrior;
+
+    Single2DGaussianLikelihood likelihood(observations, model);
+    EuclideanMetric myMetric;
+    PrincipalComponentProjector projector(false);
+    KmeansClusterer kmeans(myMetric, projector, true, 1, 3, 10, 0.01);
+
+    MultiEllipsoidSampler nestedSampler(false, ptrPriors, likelihood, myMetric, kmeans, 500, 500, 1.5, 0.2);
+    PowerlawReducer livePointsReducer(nestedSampler, 1.e2, 0.4, 0.05);
+    nestedSampler.run(livePointsReducer, 100, 10, 100, 0.05, 0, "demoAccessorAllocationBenchmark_");
+    nestedSampler.outputFile.close();
+
+    cerr << "Posterior sample size: " << nestedSampler.getPosteriorSample().cols() << "   "
+         << "Live points: " << nestedSampler.getNlivePoints() << endl << endl;
+    cerr << setw(40) << left << "Operation" << right << setw(16) << "allocations" << setw(16) << "time (us)" << endl;
+
+
+    // Per-iteration path of the live points reducer, which accesses the log-likelihood of the live points
+
+    FerozReducer ferozReducer(nestedSampler, 1.e2);
+    int Nrepetitions = 10000;
+    unsigned long NallocationsAtStart = Nallocations;
+    clock_t startTime = clock();
+
+    for (int n = 0; n < Nrepetitions; ++n)
+        ferozReducer.updateNlivePoints();
+
+    printMeasurement("FerozReducer::updateNlivePoints()", NallocationsAtStart, startTime, Nrepetitions);
+
+
+    // Copy of the posterior sample compared to a constant reference to it
+
+    Nrepetitions = 1000;
+    volatile double element = 0.0;
+    NallocationsAtStart = Nallocations;
+    startTime = clock();
+
+    for (int n = 0; n < Nrepetitions; ++n)
+    {
+        ArrayXXd posteriorSample = nestedSampler.getPosteriorSample();
+        element = posteriorSample(0, n % posteriorSample.cols());
+    }
+
+    printMeasurement("Copy of getPosteriorSample()", NallocationsAtStart, startTime, Nrepetitions);
+
+    NallocationsAtStart = Nallocations;
+    startTime = clock();
+
+    for (int n = 0; n < Nrepetitions; ++n)
+    {
+        const ArrayXXd &posteriorSample = nestedSampler.getPosteriorSample();
+        element = posteriorSample(0, n % posteriorSample.cols());
+    }
+
+    printMeasurement("Reference to getPosteriorSample()", NallocationsAtStart, startTime, Nrepetitions);
+
+
+    // Post-processing of the results
+
+    Results results(nestedSampler);
+    Nrepetitions = 1;
+
+    NallocationsAtStart = Nallocations;
+    startTime = clock();
+    results.writeParametersToFile("parameter");
+    results.writeLogLikelihoodToFile("logLikelihood.txt");
+    results.writeLogWeightsToFile("logWeights.txt");
+    results.writePosteriorProbabilityToFile("posteriorDistribution.txt");
+    printMeasurement("Results, sample files", NallocationsAtStart, startTime, Nrepetitions);
+
+    NallocationsAtStart = Nallocations;
+    startTime = clock();
+    results.writeParametersSummaryToFile("parameterSummary.txt", 68.3, true);
+    printMeasurement("Results::writeParametersSummaryToFile()", NallocationsAtStart, startTime, Nrepetitions);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,113 @@
+// Compile with:
+// clang++ -o demoCoresetClusterer demoCoresetClusterer.cpp -L../build/ -I ../include/ -l diamonds -stdlib=libc++ -std=c++11 -Wno-deprecated-register
+//
+// Compares the clustering of a large sample of points with k-means applied to the whole 
+// sample, and with k-means applied to a coreset of the sample.
+//
+
+#include <cstdlib>
+#include <iostream>
+#include <iomanip>
+#include <ctime>
+#include <random>
+#include <vector>
+#include <algorithm>
+#include <Eigen/Core>
+#include "EuclideanMetric.h"
+#include "KmeansClusterer.h"
+#include "CoresetClusterer.h"
+#include "PrincipalComponentProjector.h"
+
+using namespace std;
+using namespace Eigen;
+
+
+int main()
+{
+    // Generate a sample of points from 5 spherical Gaussians of different sizes and widths
+
+    const int Ndimensions = 5;
+    const int NinputClusters = 5;
+    int NpointsPerCluster[] = {16000, 8000, 8000, 4000, 4000};
+    int Npoints = 40000;
+
+    mt19937 engine(12345);
+    normal_distribution<double> normal(0.0, 1.0);
+    uniform_real_distribution<double> uniform(-10.0, 10.0);
+    ArrayXXd sample(Ndimensions, Npoints);
+    vector<int> inputClusterIndices(Npoints);
+    int n = 0;
+
+    for (int k = 0; k < NinputClusters; ++k)
+    {
+        ArrayXd center(Ndimensions);
+        for (int i = 0; i < Ndimensions; ++i) center(i) = uniform(engine);
+        double sigma = 0.5 + 0.25 * k;
+
+        for (int m = 0; m < NpointsPerCluster[k]; ++m, ++n)
+        {
+            for (int i = 0; i < Ndimensions; ++i) sample(i,n) = center(i) + sigma * normal(engine);
+            inputClusterIndices[n] = k;
+        }
+    }
+
+
+    // Set up the clusterers using a Euclidean metric
+
+    EuclideanMetric myMetric;
+    int minNclusters = 1;
+    int maxNclusters = 8;
+    int Ntrials = 10;
+    double relTolerance = 0.01;
+
+    bool printNdimensions = false;
+    PrincipalComponentProjector projector(printNdimensions);
+    bool featureProjectionActivated = false;
+
+    KmeansClusterer kmeans(myMetric, projector, featureProjectionActivated, 
+                           minNclusters, maxNclusters, Ntrials, relTolerance); 
+
+    unsigned int coresetSize = 1000;
+    CoresetClusterer coresetKmeans(myMetric, projector, featureProjectionActivated, kmeans, coresetSize);
+
+
+    // Cluster the whole sample and its coreset
+
+    vector<int> clusterIndices(Npoints);
+    vector<int> clusterSizes;
+    vector<int> coresetClusterIndices(Npoints);
+    vector<int> coresetClusterSizes;
+
+    clock_t start = clock();
+    int Nclusters = kmeans.cluster(sample, clusterIndices, clusterSizes);
+    double fullTime = double(clock() - start) / CLOCKS_PER_SEC;
+
+    start = clock();
+    int coresetNclusters = coresetKmeans.cluster(sample, coresetClusterIndices, coresetClusterSizes);
+    double coresetTime = double(clock() - start) / CLOCKS_PER_SEC;
+
+
+    // Measure the agreement of the two partitions as the fraction of points that belong 
+    // to the cluster of the coreset partition that overlaps most with their cluster of the full partition
+
+    ArrayXXi contingencyTable = ArrayXXi::Zero(Nclusters, coresetNclusters);
+
+    for (int n = 0; n < Npoints; ++n)
+    {
+        contingencyTable(clusterIndices[n], coresetClusterIndices[n])++;
+    }
+
+    double agreement = double(contingencyTable.rowwise().maxCoeff().sum()) / Npoints;
+
+
+    // Output the results 
+
+    cerr << "Input number of clusters: " << NinputClusters << endl; 
+    cerr << "Full sample:  " << Nclusters << " clusters in " << fullTime << " s" << endl;
+    cerr << "Coreset:      " << coresetNclusters << " clusters in " << coresetTime << " s" << endl;
+    cerr << "Fraction of points in matching clusters: " << agreement << endl;
+
+    // That's it!
+ 
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,81 @@
+// Compile with:
+// clang++ -o demoDensityClusterer2D demoDensityClusterer2D.cpp -L../build/ -I ../include/ -l diamonds -stdlib=libc++ -std=c++11 -Wno-deprecated-register
+//
+
+#include <cstdlib>
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <Eigen/Core>
+#include "File.h"
+#include "EuclideanMetric.h"
+#include "DensityClusterer.h"
+#include "PrincipalComponentProjector.h"
+
+using namespace std;
+using namespace Eigen;
+
+
+int main()
+{
+    // Open the input file and read the data (synthetic sampling of a 2D parameter space)
+    
+    ifstream inputFile;
+    File::openInputFile(inputFile, "kmeans_testsample2D.txt");
+    unsigned long Nrows;
+    int Ncols;
+
+    File::sniffFile(inputFile, Nrows, Ncols);
+    ArrayXXd data = File::arrayXXdFromFile(inputFile, Nrows, Ncols);
+    ArrayXXd sample = data.transpose();
+    inputFile.close();
+
+
+    // Set up the density clusterer using a Euclidean metric. The minimum number of neighbours
+    // of a core point and the radius of the neighbourhood are chosen automatically.
+
+    EuclideanMetric myMetric;
+    unsigned int minNneighbours = 0;
+    double neighbourhoodRadius = 0.0;
+
+    bool printNdimensions = true;
+    PrincipalComponentProjector projector(printNdimensions);
+    bool featureProjectionActivated = false;
+
+    DensityClusterer dbscan(myMetric, projector, featureProjectionActivated, 
+                            minNneighbours, neighbourhoodRadius); 
+
+ 
+    // Do the clustering, and get for each point the index of the cluster it belongs to
+
+    int optimalNclusters;
+    vector<int> clusterIndices(Nrows);
+    vector<int> clusterSizes;
+
+    optimalNclusters = dbscan.cluster(sample, clusterIndices, clusterSizes);
+    
+    
+    // Output the results 
+    
+    cerr << "Input number of clusters: 5" << endl; 
+    cerr << "Number of clusters found: " << optimalNclusters << endl;
+    cerr << "Radius of the neighbourhoods: " << dbscan.getNeighbourhoodRadius() << endl << endl;
+    
+    ArrayXXd finalSample(Nrows,Ncols+1);
+    finalSample.block(0,0,Nrows,Ncols) = data;
+    
+    for (unsigned long n = 0; n < Nrows; ++n)
+    {
+        finalSample(n,Ncols) = clusterIndices[n];
+    }
+
+    ofstream outputFile;
+    File::openOutputFile(outputFile, "clusterMembershipFromDensityClusterer2D.txt");
+    outputFile << scientific << setprecision(4);
+    File::arrayXXdToFile(outputFile, finalSample);
+    outputFile.close();
+
+    // That's it!
+ 
+    return EXIT_SUCCESS;
+}
@@ -134,8 +134,13 @@ int main(int argc, char *argv[])
     Results results(nestedSampler);
     results.writeParametersToFile("parameter");
     results.writeLogLikelihoodToFile("logLikelihood.txt");
+    results.writeNlivePointsPerIterationToFile("NlivePointsPerIteration.txt");
     results.writeEvidenceInformationToFile("evidenceInformation.txt");
     results.writePosteriorProbabilityToFile("posteriorDistribution.txt");
+    results.writePosteriorToBinaryFile("posterior.bin");
+    results.writeEqualWeightPosteriorToFile("equalWeightPosterior.txt");
+    results.writeJointMarginalDistributionsToFile("jointMarginalDistributions.bin");
+    results.writeEvidenceUncertaintyToFile("evidenceUncertainty.txt");
 
     double credibleLevel = 68.3;
     bool writeMarginalDistributionToFile = true;
@@ -0,0 +1,188 @@
+// Compile with:
+// clang++ -o demoFusedLikelihoodThroughput demoFusedLikelihoodThroughput.cpp -L../build/ -I ../include/ -l diamonds -stdlib=libc++ -std=c++11 -Wno-deprecated-register
+//
+// Benchmark of the throughput, in data points per second, of the fused likelihoods compared to the
+// two-pass likelihoods, in which the model first writes a full array of predictions that the likelihood
+// then reads back. The data sets range from 10^3 points, which fit in the caches, to 10^8 points,
+// for which the evaluation is bound by the memory bandwidth. The two-pass likelihoods are not
+// evaluated for 10^8 points, since their arrays would not fit in the memory of most machines.
+// The largest size can be lowered with an argument, e.g. './demoFusedLikelihoodThroughput 7'.
+//
+
+#include <cstdlib>
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <chrono>
+#include <Eigen/Core>
+#include "FusedLikelihood.h"
+#include "NormalLikelihood.h"
+#include "ExponentialLikelihood.h"
+#include "MultiLinearModel.h"
+#include "PolynomialModel.h"
+#include "GaussianModel.h"
+
+using namespace std;
+using namespace Eigen;
+
+
+// Evaluate the likelihood on at least 10^8 points in total, and return the number of points per second
+
+double measureThroughput(Likelihood &likelihood, RefArrayXd modelParameters, const long Npoints)
+{
+    long Nrepetitions = max(3L, 100000000L / Npoints);
+    volatile double logValue = likelihood.logValue(modelParameters);
+
+    auto startTime = chrono::steady_clock::now();
+
+    for (long n = 0; n < Nrepetitions; ++n)
+        logValue = likelihood.logValue(modelParameters);
+
+    chrono::duration<double> elapsedTime = chrono::steady_clock::now() - startTime;
+    (void)logValue;
+
+    return Npoints * Nrepetitions / elapsedTime.count();
+}
+
+
+// Print the throughput of the fused and, if available, of the two-pass likelihood, and their relative difference
+
+void printThroughput(const string label, const long Npoints, Likelihood &fusedLikelihood, Likelihood *twoPassLikelihood,
+                     RefArrayXd modelParameters)
+{
+    double fusedThroughput = measureThroughput(fusedLikelihood, modelParameters, Npoints);
+
+    cerr << setw(26) << left << label << right << setw(12) << Npoints << scientific << setprecision(2);
+
+    if (twoPassLikelihood != nullptr)
+    {
+        double twoPassThroughput = measureThroughput(*twoPassLikelihood, modelParameters, Npoints);
+        double twoPassLogValue = twoPassLikelihood->logValue(modelParameters);
+        double relativeDifference = fabs(fusedLikelihood.logValue(modelParameters) - twoPassLogValue) / fabs(twoPassLogValue);
+
+        cerr << setw(16) << twoPassThroughput << setw(16) << fusedThroughput
+             << fixed << setw(12) << fusedThroughput/twoPassThroughput
+             << scientific << setw(14) << relativeDifference << endl;
+    }
+    else
+    {
+        cerr << setw(16) << "-" << setw(16) << fusedThroughput << setw(12) << "-" << setw(14) << "-" << endl;
+    }
+}
+
+
+// Benchmark a model with a normal likelihood of constant uncertainties. Without the two-pass likelihood,
+// the input arrays are released as soon as the fused likelihood has its own copy, to keep the memory
+// of the largest data sets low.
+
+template <class ModelType>
+void benchmarkNormalLikelihood(const string label, ModelType &model, ArrayXd &observations, RefArrayXd modelParameters,
+                               const bool evaluateTwoPass)
+{
+    long Npoints = observations.size();
+    ArrayXd uncertainties = ArrayXd::Constant(Npoints, 0.3);
+    NormalNoise *noise = new NormalNoise(uncertainties);
+    FusedLikelihood<NormalNoise, ModelType> fusedLikelihood(observations, *noise, model);
+    delete noise;
+
+    if (evaluateTwoPass)
+    {
+        NormalLikelihood twoPassLikelihood(observations, uncertainties, model);
+        printThroughput(label, Npoints, fusedLikelihood, &twoPassLikelihood, modelParameters);
+    }
+    else
+    {
+        uncertainties.resize(0);
+        observations.resize(0);
+        printThroughput(label, Npoints, fusedLikelihood, nullptr, modelParameters);
+    }
+}
+
+
+// Same as above, with an exponential likelihood, as for power spectra
+
+template <class ModelType>
+void benchmarkExponentialLikelihood(const string label, ModelType &model, ArrayXd &observations, RefArrayXd modelParameters,
+                                    const bool evaluateTwoPass)
+{
+    long Npoints = observations.size();
+    FusedLikelihood<ExponentialNoise, ModelType> fusedLikelihood(observations, ExponentialNoise(Npoints), model);
+
+    if (evaluateTwoPass)
+    {
+        ExponentialLikelihood twoPassLikelihood(observations, model);
+        printThroughput(label, Npoints, fusedLikelihood, &twoPassLikelihood, modelParameters);
+    }
+    else
+    {
+        observations.resize(0);
+        printThroughput(label, Npoints, fusedLikelihood, nullptr, modelParameters);
+    }
+}
+
+
+int main(int argc, char *argv[])
+{
+    int maxExponent = 8;
+    int maxTwoPassExponent = 7;
+
+    if (argc > 1)
+        maxExponent = atoi(argv[1]);
+
+    cerr << setw(26) << left << "Likelihood + model" << right << setw(12) << "Npoints"
+         << setw(16) << "Two-pass (pt/s)" << setw(16) << "Fused (pt/s)" << setw(12) << "Speed-up" << setw(14) << "Rel. diff." << endl;
+
+    long Npoints = 1000;
+
+    for (int exponent = 3; exponent <= maxExponent; ++exponent, Npoints *= 10)
+    {
+        bool evaluateTwoPass = (exponent <= maxTwoPassExponent);
+
+
+        // Straight line with normal noise, the cheapest model, bound by the memory bandwidth
+
+        {
+            ArrayXd covariates = ArrayXd::LinSpaced(Npoints, 0.1, 10.0);
+            ArrayXd observations = 1.0 + 0.3*covariates + 0.1*sin(7.0*covariates);
+            MultiLinearModel model(covariates, 1);
+            covariates.resize(0);
+
+            ArrayXd modelParameters(2);
+            modelParameters << 0.3, 1.0;
+            benchmarkNormalLikelihood("Normal + MultiLinear", model, observations, modelParameters, evaluateTwoPass);
+        }
+
+
+        // Polynomial of degree two with normal noise
+
+        {
+            ArrayXd covariates = ArrayXd::LinSpaced(Npoints, 0.1, 10.0);
+            ArrayXd observations = 1.0 + 0.3*covariates + 0.02*covariates.square() + 0.1*sin(7.0*covariates);
+            PolynomialModel model(covariates, 2);
+            covariates.resize(0);
+
+            ArrayXd modelParameters(3);
+            modelParameters << 0.3, 0.02, 1.0;
+            benchmarkNormalLikelihood("Normal + Polynomial", model, observations, modelParameters, evaluateTwoPass);
+        }
+
+
+        // Gaussian profile with exponential noise, bound by the evaluation of exp and log
+
+        {
+            ArrayXd covariates = ArrayXd::LinSpaced(Npoints, 0.1, 10.0);
+            ArrayXd observations = 0.2*exp(-0.125*(covariates - 5.0).square()) + 0.01;
+            GaussianModel model(covariates, 1);
+            covariates.resize(0);
+
+            ArrayXd modelParameters(2);
+            modelParameters << 5.0, 2.0;
+            benchmarkExponentialLikelihood("Exponential + Gaussian", model, observations, modelParameters, evaluateTwoPass);
+        }
+    }
+
+
+    // That's it!
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,105 @@
+// Compile with:
+// clang++ -o demoGaussianMixtureCovarianceTypes demoGaussianMixtureCovarianceTypes.cpp -L../build/ -I ../include/ -l diamonds -stdlib=libc++ -std=c++11 -Wno-deprecated-register
+//
+// Benchmark of the Gaussian Mixture Model clusterer for the four available types of covariance
+// matrices (full, diagonal, spherical, tied). The sample is made of well separated Gaussian 
+// clusters in a higher dimensional space, so that the cost of the full covariance matrices matters.
+// Build the library with 'cmake -D USE_OPENMP=ON ..' to also parallelize the EM steps.
+//
+
+#include <cstdlib>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <Eigen/Core>
+#include "EuclideanMetric.h"
+#include "GaussianMixtureClusterer.h"
+#include "PrincipalComponentProjector.h"
+
+using namespace std;
+using namespace Eigen;
+
+
+int main()
+{
+    // Generate a synthetic sample of Nclusters Gaussian clusters in Ndimensions
+
+    int Ndimensions = 20;
+    int NtrueClusters = 4;
+    int NpointsPerCluster = 1000;
+    int Npoints = NtrueClusters * NpointsPerCluster;
+
+    mt19937 engine(42);
+    normal_distribution<double> normal(0.0, 1.0);
+    uniform_real_distribution<double> uniform(-20.0, 20.0);
+
+    ArrayXXd sample(Ndimensions, Npoints);
+
+    for (int k = 0; k < NtrueClusters; ++k)
+    {
+        ArrayXd center(Ndimensions);
+        ArrayXd sigma(Ndimensions);
+
+        for (int d = 0; d < Ndimensions; ++d)
+        {
+            center(d) = uniform(engine);
+            sigma(d) = 0.5 + 0.05 * (d + k);
+        }
+
+        for (int n = 0; n < NpointsPerCluster; ++n)
+        {
+            for (int d = 0; d < Ndimensions; ++d)
+            {
+                sample(d, k*NpointsPerCluster + n) = center(d) + sigma(d) * normal(engine);
+            }
+        }
+    }
+
+
+    // Set up the clusterers and run them one after the other
+
+    EuclideanMetric myMetric;
+    int minNclusters = 2;
+    int maxNclusters = 6;
+    int Ntrials = 5;
+    double relTolerance = 1.e-3;
+    unsigned int maxNiterations = 50;
+    bool warmStartActivated = false;
+    double maxRelativeBICdegradation = 0.05;
+    unsigned int maxNconsecutiveWarmStarts = 10;
+
+    bool printNdimensions = false;
+    PrincipalComponentProjector projector(printNdimensions);
+    bool featureProjectionActivated = false;
+
+    GaussianMixtureClusterer::CovarianceType covarianceTypes[4] = {GaussianMixtureClusterer::FULL, GaussianMixtureClusterer::DIAGONAL, 
+                                                                   GaussianMixtureClusterer::SPHERICAL, GaussianMixtureClusterer::TIED};
+    string covarianceTypeNames[4] = {"full", "diagonal", "spherical", "tied"};
+
+    cerr << "Sample of " << Npoints << " points in " << Ndimensions << " dimensions, with " << NtrueClusters << " clusters" << endl << endl;
+    cerr << setw(12) << "Covariance" << setw(12) << "Nclusters" << setw(14) << "Time (s)" << endl;
+
+    for (int t = 0; t < 4; ++t)
+    {
+        GaussianMixtureClusterer gaussianMixtureClusterer(myMetric, projector, featureProjectionActivated, 
+                                                          minNclusters, maxNclusters, Ntrials, relTolerance,
+                                                          warmStartActivated, maxRelativeBICdegradation, maxNconsecutiveWarmStarts,
+                                                          covarianceTypes[t], maxNiterations); 
+        vector<int> clusterIndices(Npoints);
+        vector<int> clusterSizes;
+
+        auto startTime = chrono::steady_clock::now();
+        int optimalNclusters = gaussianMixtureClusterer.cluster(sample, clusterIndices, clusterSizes);
+        chrono::duration<double> elapsedTime = chrono::steady_clock::now() - startTime;
+
+        cerr << setw(12) << covarianceTypeNames[t] << setw(12) << optimalNclusters 
+             << setw(14) << fixed << setprecision(3) << elapsedTime.count() << endl;
+    }
+
+
+    // That's it!
+ 
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,171 @@
+// Compile with:
+// clang++ -o demoLikelihoodAllocationBenchmark demoLikelihoodAllocationBenchmark.cpp -L../build/ -I ../include/ -l diamonds -stdlib=libc++ -std=c++11 -Wno-deprecated-register
+//
+// Counts the heap allocations done by a single evaluation of the likelihoods of the library,
+// NormalLikelihood, MeanNormalLikelihood, ExponentialLikelihood and MultiLinearNormalLikelihood,
+// through both logValue() overloads: the one using the workspace of the calling thread, and the one
+// taking an explicit EvaluationWorkspace. Once the workspace is sized by the first evaluation,
+// neither of them is expected to allocate. Both overloads must also give the same value.
+// Allocations are counted by intercepting malloc, which is only possible with the GNU C library.
+// On other systems only the computational times are meaningful.
+//
+
+#include <cstdlib>
+#include <iostream>
+#include <iomanip>
+#include <ctime>
+#include "NormalLikelihood.h"
+#include "MeanNormalLikelihood.h"
+#include "ExponentialLikelihood.h"
+#include "MultiLinearNormalLikelihood.h"
+#include "GaussianModel.h"
+#include "MultiLinearModel.h"
+#include "EvaluationWorkspace.h"
+
+using namespace std;
+
+
+// Count the allocations by wrapping the allocation functions of the C library, which are also the
+// ones used by Eigen and by the default operator new.
+
+static unsigned long Nallocations = 0;
+
+#ifdef __GLIBC__
+extern "C"
+{
+    void *__libc_malloc(size_t size);
+    void *__libc_calloc(size_t Nelements, size_t size);
+    void *__libc_realloc(void *pointer, size_t size);
+
+    void *malloc(size_t size)
+    {
+        ++Nallocations;
+        return __libc_malloc(size);
+    }
+
+    void *calloc(size_t Nelements, size_t size)
+    {
+        ++Nallocations;
+        return __libc_calloc(Nelements, size);
+    }
+
+    void *realloc(void *pointer, size_t size)
+    {
+        ++Nallocations;
+        return __libc_realloc(pointer, size);
+    }
+}
+#endif
+
+
+// Measure both logValue() overloads of a likelihood, after a first evaluation that sizes the workspaces.
+// Returns the total number of allocations of the two measurements.
+
+unsigned long measureLikelihood(const string label, Likelihood &likelihood, RefArrayXd modelParameters, const int Nrepetitions)
+{
+    EvaluationWorkspace workspace;
+    double logValueOfThreadWorkspace = likelihood.logValue(modelParameters);
+    double logValueOfWorkspace = likelihood.logValue(modelParameters, workspace);
+    volatile double logValue = 0.0;
+    (void)logValue;
+
+
+    // Overload using the workspace of the calling thread
+
+    unsigned long NallocationsAtStart = Nallocations;
+    clock_t startTime = clock();
+
+    for (int n = 0; n < Nrepetitions; ++n)
+        logValue = likelihood.logValue(modelParameters);
+
+    double time = (clock() - startTime)/double(CLOCKS_PER_SEC);
+    unsigned long NallocationsOfThreadWorkspace = Nallocations - NallocationsAtStart;
+
+    cerr << setw(50) << left << label + "::logValue()" << right
+         << setw(16) << NallocationsOfThreadWorkspace/double(Nrepetitions)
+         << setw(16) << 1.e6*time/Nrepetitions << endl;
+
+
+    // Overload taking an explicit workspace
+
+    NallocationsAtStart = Nallocations;
+    startTime = clock();
+
+    for (int n = 0; n < Nrepetitions; ++n)
+        logValue = likelihood.logValue(modelParameters, workspace);
+
+    time = (clock() - startTime)/double(CLOCKS_PER_SEC);
+    unsigned long NallocationsOfWorkspace = Nallocations - NallocationsAtStart;
+
+    cerr << setw(50) << left << label + "::logValue(workspace)" << right
+         << setw(16) << NallocationsOfWorkspace/double(Nrepetitions)
+         << setw(16) << 1.e6*time/Nrepetitions << endl;
+
+    if (logValueOfThreadWorkspace != logValueOfWorkspace)
+    {
+        cerr << "The two overloads of " << label << "::logValue() give different values: "
+             << setprecision(17) << logValueOfThreadWorkspace << " and " << logValueOfWorkspace << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    return NallocationsOfThreadWorkspace + NallocationsOfWorkspace;
+}
+
+
+int main()
+{
+    // Build a data set of Npoints values around a Gaussian profile, and its uncertainties
+
+    int Npoints = 10000;
+    int Nrepetitions = 2000;
+    ArrayXd covariates = ArrayXd::LinSpaced(Npoints, -5.0, 5.0);
+    ArrayXd observations = 0.4*exp(-0.5*covariates.square()) + 0.01*(1.0 + sin(7.0*covariates));
+    ArrayXd uncertainties = ArrayXd::Constant(Npoints, 0.02);
+
+    GaussianModel gaussianModel(covariates, 1);
+    ArrayXd gaussianParameters(2);
+    gaussianParameters << 0.1, 1.1;
+
+
+    // A multilinear relation of two observables, with uncertainties on both the covariates and the observations
+
+    int Nobservables = 2;
+    ArrayXd multiCovariates(Nobservables*Npoints);
+    multiCovariates << ArrayXd::LinSpaced(Npoints, 0.0, 1.0), cos(ArrayXd::LinSpaced(Npoints, 0.0, 3.0));
+    ArrayXd multiObservations = 1.5*multiCovariates.head(Npoints) - 0.5*multiCovariates.tail(Npoints) + 0.2;
+    ArrayXd covariatesUncertainties = ArrayXd::Constant(Nobservables*Npoints, 0.01);
+
+    MultiLinearModel multiLinearModel(multiCovariates, Nobservables);
+    ArrayXd multiLinearParameters(Nobservables + 1);
+    multiLinearParameters << 1.4, -0.6, 0.25;
+
+
+    // Measure the allocations of each likelihood
+
+    NormalLikelihood normalLikelihood(observations, uncertainties, gaussianModel);
+    MeanNormalLikelihood meanNormalLikelihood(observations, uncertainties, gaussianModel);
+    ExponentialLikelihood exponentialLikelihood(observations, gaussianModel);
+    MultiLinearNormalLikelihood multiLinearNormalLikelihood(multiObservations, covariatesUncertainties, uncertainties, multiLinearModel);
+
+    cerr << "Data points: " << Npoints << "   Evaluations: " << Nrepetitions << endl << endl;
+    cerr << setw(50) << left << "Operation" << right << setw(16) << "allocations" << setw(16) << "time (us)" << endl;
+
+    unsigned long NallocationsOfLikelihoods = 0;
+    NallocationsOfLikelihoods += measureLikelihood("NormalLikelihood", normalLikelihood, gaussianParameters, Nrepetitions);
+    NallocationsOfLikelihoods += measureLikelihood("MeanNormalLikelihood", meanNormalLikelihood, gaussianParameters, Nrepetitions);
+    NallocationsOfLikelihoods += measureLikelihood("ExponentialLikelihood", exponentialLikelihood, gaussianParameters, Nrepetitions);
+    NallocationsOfLikelihoods += measureLikelihood("MultiLinearNormalLikelihood", multiLinearNormalLikelihood,
+                                                   multiLinearParameters, Nrepetitions);
+
+#ifdef __GLIBC__
+    if (NallocationsOfLikelihoods > 0)
+    {
+        cerr << endl << "The likelihood evaluations allocated memory " << NallocationsOfLikelihoods << " times." << endl;
+        return EXIT_FAILURE;
+    }
+
+    cerr << endl << "No memory allocated by the likelihood evaluations." << endl;
+#endif
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,144 @@
+// Compile with:
+// clang++ -o demoLivePointIndexBenchmark demoLivePointIndexBenchmark.cpp -L../build/ -I ../include/ -l diamonds -stdlib=libc++ -std=c++11 -Wno-deprecated-register
+//
+// Compares the cost of the neighbour queries of the LivePointIndex to a brute force 
+// search over all the live points, for an increasing number of live points. Between the
+// queries, the live points are replaced as in the nesting process, so that the cost 
+// includes the buffered updates and the periodic rebuilds of the index.
+//
+
+#include <cstdlib>
+#include <iostream>
+#include <iomanip>
+#include <ctime>
+#include <random>
+#include <vector>
+#include <algorithm>
+#include <Eigen/Core>
+#include "EuclideanMetric.h"
+#include "LivePointIndex.h"
+
+using namespace std;
+using namespace Eigen;
+
+
+int main()
+{
+    const int Ndimensions = 5;
+    const int Nneighbours = 10;
+    const int Nqueries = 2000;
+    const double radius = 0.1;
+    int NlivePointsList[] = {500, 1000, 2000, 5000, 10000, 20000};
+
+    mt19937 engine(12345);
+    uniform_real_distribution<double> uniform(0.0, 1.0);
+    EuclideanMetric myMetric;
+
+    cerr << "Ndimensions: " << Ndimensions << "   Nneighbours: " << Nneighbours << "   Radius: " << radius << endl << endl;
+    cerr << setw(10) << "Npoints" << setw(16) << "kNN index (us)" << setw(16) << "kNN brute (us)" 
+         << setw(19) << "radius index (us)" << setw(19) << "radius brute (us)" << setw(10) << "builds" << endl;
+
+    for (int i = 0; i < 6; ++i)
+    {
+        int NlivePoints = NlivePointsList[i];
+        ArrayXXd livePoints(Ndimensions, NlivePoints);
+        
+        for (int n = 0; n < NlivePoints; ++n)
+            for (int j = 0; j < Ndimensions; ++j)
+                livePoints(j,n) = uniform(engine);
+
+        LivePointIndex index(myMetric);
+        index.build(livePoints);
+
+        ArrayXXd queryPoints(Ndimensions, Nqueries);
+        ArrayXXd newPoints(Ndimensions, Nqueries);
+        vector<int> replacedIndices(Nqueries);
+
+        for (int q = 0; q < Nqueries; ++q)
+        {
+            for (int j = 0; j < Ndimensions; ++j)
+            {
+                queryPoints(j,q) = uniform(engine);
+                newPoints(j,q) = uniform(engine);
+            }
+            replacedIndices[q] = int(uniform(engine) * NlivePoints) % NlivePoints;
+        }
+
+
+        // Queries through the index, with one live point replaced before each query
+
+        vector<int> neighbourIndices;
+        vector<double> neighbourDistances;
+        long checksumIndex = 0;
+        ArrayXXd indexedLivePoints = livePoints;
+
+        clock_t start = clock();
+        
+        for (int q = 0; q < Nqueries; ++q)
+        {
+            index.replacePoint(replacedIndices[q], newPoints.col(q));
+            index.nearestNeighbours(queryPoints.col(q), Nneighbours, neighbourIndices, neighbourDistances);
+            checksumIndex += neighbourIndices[0];
+        }
+        
+        double kNNindexTime = double(clock() - start) / CLOCKS_PER_SEC;
+        
+        start = clock();
+
+        for (int q = 0; q < Nqueries; ++q)
+        {
+            index.radiusSearch(queryPoints.col(q), radius, neighbourIndices);
+            checksumIndex += neighbourIndices.size();
+        }
+
+        double radiusIndexTime = double(clock() - start) / CLOCKS_PER_SEC;
+
+
+        // Same queries by brute force
+
+        ArrayXd distances(NlivePoints);
+        vector<pair<double, int> > candidates(NlivePoints);
+        long checksumBrute = 0;
+
+        start = clock();
+        
+        for (int q = 0; q < Nqueries; ++q)
+        {
+            livePoints.col(replacedIndices[q]) = newPoints.col(q);
+            myMetric.pointToCentersDistances(queryPoints.col(q), livePoints, distances);
+            
+            for (int n = 0; n < NlivePoints; ++n)
+                candidates[n] = make_pair(distances(n), n);
+            
+            partial_sort(candidates.begin(), candidates.begin() + Nneighbours, candidates.end());
+            checksumBrute += candidates[0].second;
+        }
+        
+        double kNNbruteTime = double(clock() - start) / CLOCKS_PER_SEC;
+
+        start = clock();
+
+        for (int q = 0; q < Nqueries; ++q)
+        {
+            myMetric.pointToCentersDistances(queryPoints.col(q), livePoints, distances);
+            checksumBrute += (distances <= radius).count();
+        }
+
+        double radiusBruteTime = double(clock() - start) / CLOCKS_PER_SEC;
+
+        if (checksumIndex != checksumBrute)
+        {
+            cerr << "Mismatch between the index and the brute force results for Npoints = " << NlivePoints << endl;
+            return EXIT_FAILURE;
+        }
+
+        cerr << setw(10) << NlivePoints << fixed << setprecision(2)
+             << setw(16) << 1.e6 * kNNindexTime / Nqueries << setw(16) << 1.e6 * kNNbruteTime / Nqueries 
+             << setw(19) << 1.e6 * radiusIndexTime / Nqueries << setw(19) << 1.e6 * radiusBruteTime / Nqueries 
+             << setw(10) << index.getNbuilds() << endl;
+    }
+
+    // That's it!
+ 
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,125 @@
+// Compile with:
+// clang++ -o demoParallelLikelihoodThreads demoParallelLikelihoodThreads.cpp -L../build/ -I ../include/ -l diamonds -stdlib=libc++ -std=c++11 -Wno-deprecated-register -fopenmp
+//
+// Shows how the number of threads of a parallel likelihood evaluation is chosen, for data sets
+// from 10^4 to 10^7 points and several limits on the number of threads. Each thread is given at least
+// minNblocksPerThread blocks of blockSize points, so that small data sets are evaluated by a single thread.
+// Two fused likelihoods are shown, whose models predict one block at a time: a polynomial with normal
+// noise, and a WindowedModeProfileModel with exponential noise, as for the power spectra of peak bagging.
+// For each case the demo prints the number of threads, the time per evaluation and whether log(Likelihood) 
+// is the same as with a single thread, as expected. For the windowed model, the demo also checks that
+// the block predictions give the same log(Likelihood) as the ExponentialLikelihood of the full predictions.
+// Build the library with 'cmake -D USE_OPENMP=ON ..', and compile this demo with OpenMP as above,
+// for the threads to be actually created.
+//
+
+#include <cstdlib>
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <chrono>
+#include <thread>
+#include <Eigen/Core>
+#include "FusedLikelihood.h"
+#include "ExponentialLikelihood.h"
+#include "PolynomialModel.h"
+#include "WindowedModeProfileModel.h"
+
+using namespace std;
+using namespace Eigen;
+
+
+// Evaluate the likelihood with a single thread, and then with at most maxNthreads threads for each limit,
+// printing the number of threads chosen, the time per evaluation and the difference with the single thread.
+
+template <class LikelihoodType>
+void printThreadSelection(const string label, LikelihoodType &likelihood, RefArrayXd modelParameters,
+                          const int Npoints, const vector<int> &maxNthreads)
+{
+    likelihood.disableParallelEvaluation();
+    double serialLogLikelihood = likelihood.logValue(modelParameters);
+    int Nrepetitions = max(3, 10000000 / Npoints);
+
+    for (size_t n = 0; n < maxNthreads.size(); ++n)
+    {
+        likelihood.enableParallelEvaluation(maxNthreads[n]);
+        double logLikelihood = likelihood.logValue(modelParameters);
+
+        auto startTime = chrono::steady_clock::now();
+
+        for (int r = 0; r < Nrepetitions; ++r)
+            likelihood.logValue(modelParameters);
+
+        chrono::duration<double> elapsedTime = chrono::steady_clock::now() - startTime;
+
+        cerr << setw(30) << left << label << right << setw(12) << Npoints
+             << setw(14) << (maxNthreads[n] == 0 ? string("all") : to_string(maxNthreads[n]))
+             << setw(10) << likelihood.getNthreads()
+             << setw(14) << fixed << setprecision(3) << 1.e3*elapsedTime.count()/Nrepetitions
+             << setw(14) << (logLikelihood == serialLogLikelihood ? "yes" : "no") << endl;
+    }
+
+    likelihood.disableParallelEvaluation();
+}
+
+
+int main()
+{
+    vector<int> maxNthreads = {1, 2, 4, 8, 0};
+    int Nmodes = 50;
+
+    cerr << "Cores of this machine: " << thread::hardware_concurrency() << endl;
+    cerr << "Points per block: " << FusedLikelihood<NormalNoise, PolynomialModel>::blockSize
+         << "   Minimum blocks per thread: " << FusedLikelihood<NormalNoise, PolynomialModel>::minNblocksPerThread << endl << endl;
+    cerr << setw(30) << left << "Likelihood" << right << setw(12) << "Npoints" << setw(14) << "maxNthreads"
+         << setw(10) << "Nthreads" << setw(14) << "Time (ms)" << setw(14) << "Same log(L)" << endl;
+
+    for (int Npoints = 10000; Npoints <= 10000000; Npoints *= 10)
+    {
+        // A polynomial of degree two with normal noise
+
+        ArrayXd covariates = ArrayXd::LinSpaced(Npoints, 1.0, 300.0);
+        ArrayXd observations = 1.0 + 0.3*covariates + 0.002*covariates.square() + 0.1*sin(7.0*covariates);
+        ArrayXd uncertainties = ArrayXd::Constant(Npoints, 0.3);
+        PolynomialModel polynomialModel(covariates, 2);
+        FusedLikelihood<NormalNoise, PolynomialModel> fusedLikelihood(observations, NormalNoise(uncertainties), polynomialModel);
+
+        ArrayXd polynomialParameters(3);
+        polynomialParameters << 0.3, 0.002, 1.0;
+        printThreadSelection("Fused Normal + Polynomial", fusedLikelihood, polynomialParameters, Npoints, maxNthreads);
+
+
+        // A power spectrum of Nmodes Lorentzian profiles over a flat background
+
+        ArrayXd modelParameters(3*Nmodes + 1);
+
+        for (int mode = 0; mode < Nmodes; ++mode)
+        {
+            modelParameters(3*mode) = 20.0 + 5.0*mode;
+            modelParameters(3*mode + 1) = 10.0;
+            modelParameters(3*mode + 2) = 0.2;
+        }
+
+        modelParameters(3*Nmodes) = 1.0;
+
+        WindowedModeProfileModel windowedModel(covariates, Nmodes);
+        ArrayXd spectrum(Npoints);
+        windowedModel.predict(spectrum, modelParameters);
+        FusedLikelihood<ExponentialNoise, WindowedModeProfileModel> windowedLikelihood(spectrum, ExponentialNoise(Npoints), windowedModel);
+        ExponentialLikelihood exponentialLikelihood(spectrum, windowedModel);
+
+        if (windowedLikelihood.logValue(modelParameters) != exponentialLikelihood.logValue(modelParameters))
+        {
+            cerr << "The block predictions of the windowed model give a different log(Likelihood) than predict()." << endl;
+            return EXIT_FAILURE;
+        }
+
+        printThreadSelection("Fused Exponential + Windowed", windowedLikelihood, modelParameters, Npoints, maxNthreads);
+        cerr << endl;
+    }
+
+
+    // That's it!
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,66 @@
+// Compile with:
+// clang++ -o demoReadBinaryPosterior demoReadBinaryPosterior.cpp -L../build/ -I ../include/ -l diamonds -stdlib=libc++ -std=c++11 -Wno-deprecated-register
+//
+// Usage: ./demoReadBinaryPosterior demoFive2DGaussians_posterior.bin [equalWeightPosterior.txt]
+//
+// Opens a binary posterior file written by Results::writePosteriorToBinaryFile() and prints 
+// the summary of the run together with the mean of each free parameter. The file is
+// memory-mapped, so that no parsing is needed, whatever the size of the posterior sample.
+// If an output file is given, an equal-weight posterior sample is also drawn and saved in it.
+//
+
+#include <cstdlib>
+#include <iostream>
+#include <iomanip>
+#include <Eigen/Core>
+#include "BinaryPosteriorFile.h"
+#include "Results.h"
+
+using namespace std;
+using namespace Eigen;
+
+
+int main(int argc, char *argv[])
+{
+    if (argc != 2 && argc != 3)
+    {
+        cerr << "Usage: " << argv[0] << " <binary posterior file> [<equal-weight posterior file>]" << endl;
+        return EXIT_FAILURE;
+    }
+
+    BinaryPosteriorFile posteriorFile(argv[1]);
+    const BinaryPosteriorHeader &header = posteriorFile.getHeader();
+
+    cerr << "Ndimensions: " << header.Ndimensions << "   Nsamples: " << header.Nsamples << endl;
+    cerr << "Niterations: " << header.Niterations << "   Initial Nlive: " << header.initialNlivePoints 
+         << "   Minimum Nlive: " << header.minNlivePoints << "   Final Nlive: " << header.NfinalLivePoints << endl;
+    cerr << "log(E): " << header.logEvidence << " +/- " << header.logEvidenceError 
+         << "   IG: " << header.informationGain << endl << endl;
+
+
+    // Compute the posterior probability of each sampling point and the mean of each parameter
+
+    Map<const ArrayXd> logLikelihood = posteriorFile.getLogLikelihood();
+    Map<const ArrayXd> logWeight = posteriorFile.getLogWeight();
+    ArrayXd posteriorProbability = (logWeight + logLikelihood - header.logEvidence).exp();
+    posteriorProbability /= posteriorProbability.sum();
+
+    Map<const ArrayXXd> posteriorSample = posteriorFile.getPosteriorSample();
+
+    for (int i = 0; i < posteriorFile.getNdimensions(); ++i)
+    {
+        double parameterMean = (posteriorSample.row(i).transpose() * posteriorProbability).sum();
+        cerr << "Parameter " << setw(3) << i << "   Mean: " << scientific << setprecision(9) << parameterMean << endl;
+    }
+
+
+
+    // Draw an equal-weight sample, with as many points as the effective sample size
+
+    if (argc == 3)
+    {
+        Results::writeEqualWeightPosteriorToFile(posteriorFile, argv[2]);
+    }
+
+    return EXIT_SUCCESS;
+}
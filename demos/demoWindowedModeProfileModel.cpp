@@ -0,0 +1,127 @@
+// Compile with:
+// clang++ -o demoWindowedModeProfileModel demoWindowedModeProfileModel.cpp -L../build/ -I ../include/ -l diamonds -stdlib=libc++ -std=c++11 -Wno-deprecated-register
+//
+// Validation of the WindowedModeProfileModel against the direct sum of the Lorentzian profiles
+// computed by Functions::modeProfile(), for spectra of many modes over a flat background.
+// For each spectrum the demo prints the speed-up, the largest relative error of the predictions,
+// the ratio of the total powers and the difference of the log(Likelihood) of a simulated spectrum.
+// The last spectra contain modes so narrow that the coarse grid of the broad parts reaches its
+// largest size, and the windows of these modes are widened.
+//
+
+#include <cstdlib>
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <chrono>
+#include <Eigen/Core>
+#include "Functions.h"
+#include "WindowedModeProfileModel.h"
+
+using namespace std;
+using namespace Eigen;
+
+
+// Sum of the profiles computed over the whole frequency grid, used as reference
+
+void predictDirectly(RefArrayXd predictions, RefArrayXd frequencies, RefArrayXd modelParameters, const int Nmodes)
+{
+    ArrayXd profile(frequencies.size());
+    predictions.setConstant(modelParameters(3*Nmodes));
+
+    for (int mode = 0; mode < Nmodes; ++mode)
+    {
+        Functions::modeProfile(profile, frequencies, modelParameters(3*mode), modelParameters(3*mode + 1), modelParameters(3*mode + 2));
+        predictions += profile;
+    }
+}
+
+
+// Compare the windowed model with the direct sum for a spectrum of Nbins bins and Nmodes modes,
+// a fraction of which have a very narrow linewidth
+
+void compareModels(const int Nbins, const int Nmodes, const double fractionOfNarrowModes, const double narrowLinewidth,
+                   const double NlinewidthsInWindow, mt19937 &engine)
+{
+    ArrayXd frequencies = ArrayXd::LinSpaced(Nbins, 1.0, 300.0);
+    ArrayXd modelParameters(3*Nmodes + 1);
+    uniform_real_distribution<double> uniform(0.0, 1.0);
+
+    for (int mode = 0; mode < Nmodes; ++mode)
+    {
+        modelParameters(3*mode) = 20.0 + 260.0*uniform(engine);
+        modelParameters(3*mode + 1) = 5.0 + 20.0*uniform(engine);
+        modelParameters(3*mode + 2) = (mode < fractionOfNarrowModes*Nmodes) ? narrowLinewidth : 0.05 + 0.5*uniform(engine);
+    }
+
+    modelParameters(3*Nmodes) = 1.0;
+
+
+    // Time both models, repeating the faster one to have a measurable time
+
+    ArrayXd directPredictions(Nbins);
+    ArrayXd windowedPredictions(Nbins);
+    WindowedModeProfileModel model(frequencies, Nmodes, NlinewidthsInWindow);
+    int Nrepetitions = 10;
+
+    auto startTime = chrono::steady_clock::now();
+    predictDirectly(directPredictions, frequencies, modelParameters, Nmodes);
+    chrono::duration<double> directTime = chrono::steady_clock::now() - startTime;
+
+    startTime = chrono::steady_clock::now();
+
+    for (int n = 0; n < Nrepetitions; ++n)
+        model.predict(windowedPredictions, modelParameters);
+
+    chrono::duration<double> windowedTime = (chrono::steady_clock::now() - startTime)/Nrepetitions;
+
+
+    // Simulate a power spectrum, with the chi-square noise of 2 d.o.f. of the direct model,
+    // and compare the exponential log(Likelihood) of the two models
+
+    exponential_distribution<double> exponential(1.0);
+    ArrayXd observations(Nbins);
+
+    for (int i = 0; i < Nbins; ++i)
+        observations(i) = directPredictions(i)*exponential(engine);
+
+    double directLogLikelihood = -(directPredictions.log() + observations/directPredictions).sum();
+    double windowedLogLikelihood = -(windowedPredictions.log() + observations/windowedPredictions).sum();
+    double maxRelativeError = ((windowedPredictions - directPredictions).abs()/directPredictions).maxCoeff();
+
+    cerr << setw(10) << Nbins << setw(8) << Nmodes << setw(10) << setprecision(0) << fixed << fractionOfNarrowModes*Nmodes
+         << setw(10) << setprecision(1) << directTime.count()/windowedTime.count()
+         << setw(14) << setprecision(2) << scientific << maxRelativeError
+         << setw(14) << setprecision(6) << fixed << windowedPredictions.sum()/directPredictions.sum()
+         << setw(12) << setprecision(4) << windowedLogLikelihood - directLogLikelihood << endl;
+}
+
+
+int main()
+{
+    mt19937 engine(3);
+    double NlinewidthsInWindow = 10.0;
+
+    cerr << "Window half width: " << NlinewidthsInWindow << " linewidths" << endl << endl;
+    cerr << setw(10) << "Nbins" << setw(8) << "Nmodes" << setw(10) << "Nnarrow" << setw(10) << "Speed-up"
+         << setw(14) << "Max rel. err." << setw(14) << "Power ratio" << setw(12) << "dlog(L)" << endl;
+
+
+    // Typical spectra, with linewidths of a few bins or more
+
+    compareModels(100000, 10, 0.0, 0.0, NlinewidthsInWindow, engine);
+    compareModels(100000, 100, 0.0, 0.0, NlinewidthsInWindow, engine);
+    compareModels(1000000, 100, 0.0, 0.0, NlinewidthsInWindow, engine);
+    compareModels(1000000, 300, 0.0, 0.0, NlinewidthsInWindow, engine);
+
+
+    // Spectra with unresolved modes, for which the coarse grid reaches its largest size
+
+    compareModels(1000000, 100, 0.1, 1.e-4, NlinewidthsInWindow, engine);
+    compareModels(10000, 100, 0.1, 1.e-3, NlinewidthsInWindow, engine);
+
+
+    // That's it!
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,51 @@
+// Derived class for reading a nested sampling run from the ASCII files written by
+// NestedSampler and Results: computationParameters.txt, logLikelihood.txt,
+// NlivePointsPerIteration.txt and one parameterXXX.txt file per free parameter, 
+// all sharing the same path prefix.
+// The files are read line by line, so that the run is never loaded as a whole.
+// Header file "AsciiMergeableRun.h"
+// Implementations contained in "AsciiMergeableRun.cpp"
+
+
+#ifndef ASCIIMERGEABLERUN_H
+#define ASCIIMERGEABLERUN_H
+
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include "MergeableRun.h"
+#include "File.h"
+
+
+using namespace std;
+
+
+class AsciiMergeableRun : public MergeableRun
+{
+    public:
+
+        AsciiMergeableRun(const string pathPrefix);
+        ~AsciiMergeableRun();
+
+
+    protected:
+
+        virtual void readNextSample(double &logLikelihood, double *parameters) override;
+        virtual int readNextNlivePoints() override;
+
+
+    private:
+
+        ifstream logLikelihoodFile;
+        ifstream NlivePointsFile;
+        bool NlivePointsAreStored;                  // False if the run has no file of the numbers of live points
+        vector<ifstream*> parameterFiles;           // One input stream per free parameter
+        string line;                                // Buffer for the line being read
+
+        double readNextValue(ifstream &inputFile);
+
+}; // END class AsciiMergeableRun
+
+
+#endif
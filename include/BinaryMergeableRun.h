@@ -0,0 +1,41 @@
+// Derived class for reading a nested sampling run from a binary posterior file,
+// written by Results::writePosteriorToBinaryFile(). The points are read in place
+// from the memory-mapped file.
+// Header file "BinaryMergeableRun.h"
+// Implementations contained in "BinaryMergeableRun.cpp"
+
+
+#ifndef BINARYMERGEABLERUN_H
+#define BINARYMERGEABLERUN_H
+
+#include "MergeableRun.h"
+#include "BinaryPosteriorFile.h"
+
+
+using namespace std;
+
+
+class BinaryMergeableRun : public MergeableRun
+{
+    public:
+
+        BinaryMergeableRun(const string fileName);
+        ~BinaryMergeableRun(){};
+
+
+    protected:
+
+        virtual void readNextSample(double &logLikelihood, double *parameters) override;
+        virtual int readNextNlivePoints() override;
+
+
+    private:
+
+        BinaryPosteriorFile posteriorFile;
+        long Nread;                         // Number of points read from the file, in the order of the file
+        long NreadNlivePoints;              // Number of values read from the block of the numbers of live points
+
+}; // END class BinaryMergeableRun
+
+
+#endif
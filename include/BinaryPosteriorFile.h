@@ -0,0 +1,90 @@
+// Class for reading the binary posterior files written by Results::writePosteriorToBinaryFile().
+// The file is memory-mapped, so that the posterior sample is accessed in place without
+// reading or parsing it, independently of its size.
+// Header file "BinaryPosteriorFile.h"
+// Implementations contained in "BinaryPosteriorFile.cpp"
+//
+// File layout (native byte order, checked through the byte order mark):
+//      - a BinaryPosteriorHeader, with the sizes of the sample and a summary of the run
+//      - the parameter values, as a column-major block of Ndimensions x Nsamples doubles
+//        (one column per sampling point, as in NestedSampler::getPosteriorSample())
+//      - the log(Likelihood) values, as a block of Nsamples doubles
+//      - the log(Weight) values, as a block of Nsamples doubles
+//      - the number of live points at the iteration of each dead point, as a block of
+//        Nsamples - NfinalLivePoints doubles. The final live points, appended at the end
+//        of the sample, are not included.
+
+
+#ifndef BINARYPOSTERIORFILE_H
+#define BINARYPOSTERIORFILE_H
+
+#include <cstdlib>
+#include <cstring>
+#include <stdint.h>
+#include <string>
+#include <limits>
+#include <iostream>
+#include <Eigen/Core>
+#include "MemoryMappedFile.h"
+
+
+using namespace std;
+using namespace Eigen;
+
+
+// The header of the file only contains fields of 8 bytes, or pairs of fields of 4 bytes,
+// so that its layout does not depend on the padding added by the compiler.
+
+struct BinaryPosteriorHeader
+{
+    char magicNumber[8];            // Identifier of the file format, "DIAMONDS"
+    uint32_t version;               // Version of the file format
+    uint32_t byteOrderMark;         // Written as 0x01020304, to detect files written with a different byte order
+    uint64_t dataOffset;            // Position of the first data block from the beginning of the file, in bytes
+    uint64_t Ndimensions;           // Number of free parameters of the inference
+    uint64_t Nsamples;              // Number of points of the posterior sample
+    double logEvidence;             // Skilling's log(Evidence)
+    double logEvidenceError;        // Skilling's error on log(Evidence)
+    double informationGain;         // Skilling's information gain
+    uint64_t Niterations;           // Total number of nested iterations
+    uint64_t initialNlivePoints;    // Initial number of live points
+    uint64_t minNlivePoints;        // Minimum number of live points allowed
+    double terminationFactor;       // Final value of the stopping condition of the nesting process
+    double computationalTime;       // Computational time of the nesting process, in seconds
+    uint64_t NfinalLivePoints;      // Number of live points appended at the end of the sample
+};
+
+
+class BinaryPosteriorFile
+{
+    public:
+
+        static const char magicNumber[8];
+        static const uint32_t version = 2;
+        static const uint32_t byteOrderMark = 0x01020304;
+
+        BinaryPosteriorFile(const string fileName);
+        ~BinaryPosteriorFile(){};
+
+        const BinaryPosteriorHeader &getHeader();
+        int getNdimensions();
+        int getNsamples();
+        int getNfinalLivePoints();
+        Map<const ArrayXXd> getPosteriorSample();
+        Map<const ArrayXd> getLogLikelihood();
+        Map<const ArrayXd> getLogWeight();
+        Map<const ArrayXd> getNlivePointsPerIteration();
+
+
+    private:
+
+        MemoryMappedFile mappedFile;
+        BinaryPosteriorHeader header;
+        const double *posteriorSample;              // Beginning of the block of parameter values
+        const double *logLikelihood;                // Beginning of the block of log(Likelihood) values
+        const double *logWeight;                    // Beginning of the block of log(Weight) values
+        const double *NlivePointsPerIteration;      // Beginning of the block of the numbers of live points
+};
+
+
+#endif
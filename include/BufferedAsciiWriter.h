@@ -0,0 +1,48 @@
+// Class for writing large amounts of numbers to an ASCII output stream.
+// The numbers are formatted with snprintf into a large buffer, which is written
+// to the stream in a single call when full, instead of formatting every number
+// through the locale-aware operator<< of the stream.
+// Header file "BufferedAsciiWriter.h"
+// Implementations contained in "BufferedAsciiWriter.cpp"
+
+
+#ifndef BUFFEREDASCIIWRITER_H
+#define BUFFEREDASCIIWRITER_H
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <locale>
+#include <ostream>
+
+
+using namespace std;
+
+
+class BufferedAsciiWriter
+{
+    public:
+
+        BufferedAsciiWriter(ostream &outputStream, const size_t bufferSize = 1048576);
+        ~BufferedAsciiWriter();
+
+        void write(const double value);
+        void write(const string &text);
+        void flush();
+
+
+    private:
+
+        ostream &outputStream;          // The stream to write to, already opened
+        vector<char> buffer;            // The buffer of formatted characters not yet written to the stream
+        size_t Ncharacters;             // Number of characters currently in the buffer
+        bool formatIsSupported;         // False if the state of the stream cannot be reproduced with snprintf
+        char format[8];                 // The snprintf format equivalent to the state of the stream
+        int precision;                  // The precision of the stream
+
+        void setFormatFromStream();
+};
+
+
+#endif
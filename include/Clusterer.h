@@ -29,6 +29,7 @@ class Clusterer
         ~Clusterer(){};
     
         virtual int cluster(RefArrayXXd sample, vector<int> &optimalClusterIndices, vector<int> &optimalClusterSizes) = 0;
+        virtual int clusterWithWarmStart(RefArrayXXd sample, vector<int> &clusterIndices, vector<int> &clusterSizes);
         unsigned int getReducedNdimensions();
 
 
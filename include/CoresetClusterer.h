@@ -0,0 +1,49 @@
+// Derived class for clustering large samples through a coreset, i.e. a small 
+// subsample of the points that is clustered by any of the other clustering algorithms.
+// Header file "CoresetClusterer.h"
+// Implementations contained in "CoresetClusterer.cpp"
+
+
+#ifndef CORESETCLUSTERER_H
+#define CORESETCLUSTERER_H
+
+#include <ctime>
+#include <cmath>
+#include <random>
+#include <limits>
+#include <vector>
+#include <algorithm>
+#include <iostream>
+#include "Clusterer.h"
+
+
+using namespace std;
+
+
+class CoresetClusterer : public Clusterer
+{
+    public:
+    
+        CoresetClusterer(Metric &metric, Projector &featureProjector, bool featureProjectionActivated,
+                         Clusterer &clusterer, unsigned int coresetSize = 1000, unsigned int NrefinementIterations = 1);
+        ~CoresetClusterer();
+    
+        virtual int cluster(RefArrayXXd sample, vector<int> &optimalClusterIndices, vector<int> &optimalClusterSizes);
+
+
+    protected:
+
+        Clusterer &clusterer;                   // The clustering algorithm applied to the coreset
+        unsigned int coresetSize;               // Number of points of the coreset
+        unsigned int NrefinementIterations;     // Number of k-means iterations on the whole sample after the assignment
+        mt19937 engine;
+
+    private:
+
+        void chooseCoreset(RefArrayXXd sample, vector<int> &coresetIndices);
+        int assignPointsToClusters(RefArrayXXd sample, RefArrayXXd centers, vector<int> &clusterIndices, 
+                                   vector<int> &clusterSizes);
+};
+
+
+#endif
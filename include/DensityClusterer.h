@@ -0,0 +1,51 @@
+// Derived class for density-based clustering (DBSCAN) algorithm,
+// using a k-d tree for the neighbour queries.
+// Header file "DensityClusterer.h"
+// Implementations contained in "DensityClusterer.cpp"
+
+
+#ifndef DENSITYCLUSTERER_H
+#define DENSITYCLUSTERER_H
+
+#include <cmath>
+#include <limits>
+#include <vector>
+#include <algorithm>
+#include <iostream>
+#include "Clusterer.h"
+#include "KdTree.h"
+
+
+using namespace std;
+
+
+class DensityClusterer : public Clusterer
+{
+    public:
+    
+        DensityClusterer(Metric &metric, Projector &featureProjector, bool featureProjectionActivated,
+                         unsigned int minNneighbours = 0, double neighbourhoodRadius = 0.0);
+        ~DensityClusterer();
+    
+        virtual int cluster(RefArrayXXd sample, vector<int> &optimalClusterIndices, vector<int> &optimalClusterSizes);
+        double getNeighbourhoodRadius();
+
+
+    protected:
+
+        KdTree tree;
+        double neighbourhoodRadius;         // Radius (eps) of the neighbourhood used in the last clustering
+
+    private:
+
+        double chooseNeighbourhoodRadius(RefArrayXXd sample, const unsigned int Nneighbours);
+        void assignNoisePointsToClusters(RefArrayXXd sample, vector<int> &clusterIndices);
+
+        unsigned int minNneighbours;        // User-specified minimum number of neighbours of a core point (0 = automatic)
+        double userNeighbourhoodRadius;     // User-specified radius of the neighbourhood (0 = automatic)
+        unsigned int Ndimensions;
+        unsigned int Npoints;
+};
+
+
+#endif
@@ -0,0 +1,47 @@
+// Class for holding the scratch arrays used in the evaluation of likelihoods and models,
+// so that the evaluation does not allocate any memory on the heap at each call.
+// The arrays are sized at their first use and then reused. A workspace must not be shared
+// among threads: each thread evaluating a likelihood should use a workspace of its own.
+// Header file "EvaluationWorkspace.h"
+// Implementations contained in "EvaluationWorkspace.cpp"
+
+
+#ifndef EVALUATIONWORKSPACE_H
+#define EVALUATIONWORKSPACE_H
+
+#include <cassert>
+#include <Eigen/Core>
+
+
+using namespace std;
+using Eigen::ArrayXd;
+
+
+class EvaluationWorkspace
+{
+    public:
+
+        static const int NmodelArrays = 4;          // Number of scratch arrays available to the models
+
+        EvaluationWorkspace();
+        ~EvaluationWorkspace();
+
+        ArrayXd &getPredictions(const int Npoints);
+        ArrayXd &getLikelihoodArray(const int Npoints);
+        ArrayXd &getModelArray(const int index, const int Npoints);
+
+        static EvaluationWorkspace &getThreadWorkspace();
+
+
+    private:
+
+        ArrayXd predictions;                        // Predictions of the model, filled by the likelihood
+        ArrayXd likelihoodArray;                    // Scratch array for the likelihood
+        ArrayXd modelArrays[NmodelArrays];          // Scratch arrays for the model
+
+        static ArrayXd &prepareArray(ArrayXd &array, const int Npoints);
+
+}; // END class EvaluationWorkspace
+
+
+#endif
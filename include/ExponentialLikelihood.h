@@ -12,6 +12,7 @@
 #include <iostream>
 #include <cstdlib>
 #include <cassert>
+#include "Functions.h"
 #include "Likelihood.h"
 
 
@@ -25,10 +26,13 @@ class ExponentialLikelihood : public Likelihood
 
     public:
 
+        static const int blockSize = 1024;          // Number of points whose terms are summed together
+
         ExponentialLikelihood(const RefArrayXd observations, Model &model);
         ~ExponentialLikelihood();
 
         virtual double logValue(RefArrayXd const modelParameters);
+        virtual double logValue(RefArrayXd const modelParameters, EvaluationWorkspace &workspace);
 
 
     private:
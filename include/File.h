@@ -10,6 +10,7 @@
 
 
 #include <cstdlib>
+#include <cstring>
 #include <string>
 #include <vector>
 #include <iostream>
@@ -17,12 +18,16 @@
 #include <fstream>
 #include <sstream>
 #include <Eigen/Core>
+#include "BufferedAsciiWriter.h"
+#include "MemoryMappedFile.h"
 
 
 using namespace std;
 using namespace Eigen;
 typedef Eigen::Ref<Eigen::ArrayXd> RefArrayXd;
 typedef Eigen::Ref<Eigen::ArrayXXd> RefArrayXXd;
+typedef Eigen::Ref<const Eigen::ArrayXd> ConstRefArrayXd;
+typedef Eigen::Ref<const Eigen::ArrayXXd> ConstRefArrayXXd;
 
 
 namespace File
@@ -31,12 +36,13 @@ namespace File
     void openOutputFile(ofstream &outputFile, string outputFileName);
     
     ArrayXXd arrayXXdFromFile(ifstream &inputFile, const unsigned long Nrows, const int Ncols, char separator = ' ', char commentChar = '#');
+    ArrayXXd arrayXXdFromFile(const string inputFileName, char separator = ' ', char commentChar = '#');
     vector<string> vectorStringFromFile(ifstream &inputFile, const unsigned long Nrows, char commentChar = '#');
 
-    void arrayXXdToFile(ofstream &outputFile, RefArrayXXd array, string separator = "  ", string terminator = "\n");
-    void twoArrayXdToFile(ofstream &outputFile, RefArrayXd array1, RefArrayXd array2, string separator = "  ", string terminator = "\n");
-    void arrayXdToFile(ofstream &outputFile, RefArrayXd array, string terminator = "\n");
-    void arrayXXdRowsToFiles(RefArrayXXd array, string fullPathPrefix, string fileExtension = ".txt", string terminator = "\n");
+    void arrayXXdToFile(ofstream &outputFile, ConstRefArrayXXd array, string separator = "  ", string terminator = "\n");
+    void twoArrayXdToFile(ofstream &outputFile, ConstRefArrayXd array1, ConstRefArrayXd array2, string separator = "  ", string terminator = "\n");
+    void arrayXdToFile(ofstream &outputFile, ConstRefArrayXd array, string terminator = "\n");
+    void arrayXXdRowsToFiles(ConstRefArrayXXd array, string fullPathPrefix, string fileExtension = ".txt", string terminator = "\n");
     void sniffFile(ifstream &inputFile, unsigned long &Nrows, int &Ncols, char separator = ' ', char commentChar = '#');
 
 }
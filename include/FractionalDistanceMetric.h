@@ -25,6 +25,9 @@ class FractionalDistanceMetric : public Metric
         ~FractionalDistanceMetric(){};
 
         virtual double distance(RefArrayXd point1, RefArrayXd point2);
+        virtual void pointToCentersDistances(RefArrayXd point, RefArrayXXd centers, RefArrayXd distances, bool reduced = false);
+        virtual void pairwiseDistances(RefArrayXXd sample1, RefArrayXXd sample2, RefArrayXXd distances, bool reduced = false);
+        virtual double reducedDistanceToDistance(double reducedDistance);
 
     protected:
 
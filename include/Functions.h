@@ -10,6 +10,7 @@
 #define FUNCTIONS_H
 
 #include <cmath>
+#include <complex>
 #include <cassert>
 #include <numeric>
 #include <functional>
@@ -75,6 +76,9 @@ namespace Functions
     inline double sum(const vector<double> &vec);
     double logExpSum(const double x, const double y);
     double logExpDifference(const double x, const double y);
+    double pairwiseSumOfRange(RefArrayXd const values,                 // Only used within pairwiseSum
+                              int beginIndex, int endIndex);
+    double pairwiseSum(RefArrayXd const values);
     void topDownMerge(RefArrayXd array1, RefArrayXd arrayCopy1,         // Only used within topDownMergeSort
                       RefArrayXd array2, RefArrayXd arrayCopy2, 
                       int beginIndex, int middleIndex, int endIndex);
@@ -88,10 +92,17 @@ namespace Functions
 
     vector<int> findArrayIndicesWithinBoundaries(RefArrayXd const array, double lowerBound, double upperBound);
     int countArrayIndicesWithinBoundaries(RefArrayXd const array, double lowerBound, double upperBound);
+    int countSortedArrayIndicesWithinBoundaries(RefArrayXd const sortedArray, double lowerBound, double upperBound);
     ArrayXd cubicSplineInterpolation(RefArrayXd const observedAbscissa, RefArrayXd const observedOrdinate, 
                                      RefArrayXd const interpolatedAbscissaUntruncated);
 
 
+    // Fourier transform functions
+
+    void fastFourierTransform(ArrayXcd &data, const bool inverse = false);
+    ArrayXd symmetricConvolution(RefArrayXd const data, RefArrayXd const kernel);
+
+
     // Utility functions
 
     template <typename Type>
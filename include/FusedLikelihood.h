@@ -0,0 +1,364 @@
+// Class template for evaluating a likelihood and its model in a single pass over the data.
+// The model is evaluated one block of points at a time into a small buffer that stays in the
+// L1 cache, and the noise term of the likelihood is cumulated right away from the same block,
+// so that no array of predictions of the size of the data set is written and read back.
+// The model and the noise are combined at compile time, e.g. FusedLikelihood<NormalNoise, PolynomialModel>,
+// while the class derives from Likelihood, so that it can be used by the nested samplers as any other likelihood.
+// The model class is required to implement the non-virtual function
+//      void predictBlock(double *predictions, const int begin, const int size, const RefArrayXd modelParameters)
+// which computes the predictions for the points begin, ..., begin + size - 1 of the covariates.
+// For very large data sets, the blocks can be distributed among threads (see enableParallelEvaluation()),
+// in which case predictBlock() is called concurrently for different blocks.
+// Header file "FusedLikelihood.h"
+// Implementations of the noise classes contained in "FusedLikelihood.cpp"
+
+
+#ifndef FUSEDLIKELIHOOD_H
+#define FUSEDLIKELIHOOD_H
+
+#include <cmath>
+#include <iostream>
+#include <cstdlib>
+#include <cassert>
+#include <algorithm>
+#include <thread>
+#include <Eigen/Core>
+#include "Functions.h"
+#include "Likelihood.h"
+#include "EvaluationWorkspace.h"
+
+
+using namespace std;
+using Eigen::ArrayXd;
+typedef Eigen::Ref<Eigen::ArrayXd> RefArrayXd;
+
+
+// Noise term of a normal likelihood with known uncertainties
+
+class NormalNoise
+{
+    public:
+
+        NormalNoise(const RefArrayXd uncertainties);
+        ~NormalNoise();
+
+        int getNpoints() const;
+        double getLogNormalization() const;
+        double reduceBlock(const double *observations, const double *predictions, const int begin, const int size) const;
+
+
+    private:
+
+        ArrayXd inverseVariances;           // 1/sigma^2 of each observation
+        double logNormalization;            // -0.5*N*log(2*pi) - sum(log(sigma))
+
+}; // END class NormalNoise
+
+
+
+
+// Noise term of an exponential likelihood, i.e. a chi-square distribution with 2 d.o.f., as for power spectra
+
+class ExponentialNoise
+{
+    public:
+
+        ExponentialNoise(const int Npoints);
+        ~ExponentialNoise();
+
+        int getNpoints() const;
+        double getLogNormalization() const;
+        double reduceBlock(const double *observations, const double *predictions, const int begin, const int size) const;
+
+
+    private:
+
+        int Npoints;                        // Number of observations
+
+}; // END class ExponentialNoise
+
+
+
+
+template <class Noise, class ModelType>
+class FusedLikelihood : public Likelihood
+{
+    public:
+
+        static const int blockSize = 1024;          // Number of points predicted at a time (8 kB of predictions)
+        static const int minNblocksPerThread = 64;  // Smallest number of blocks worth giving to an extra thread
+
+        FusedLikelihood(const RefArrayXd observations, const Noise &noise, ModelType &model);
+        ~FusedLikelihood();
+
+        void enableParallelEvaluation(const int maxNthreads = 0);
+        void disableParallelEvaluation();
+        int getNthreads();
+
+        virtual double logValue(RefArrayXd const modelParameters);
+        virtual double logValue(RefArrayXd const modelParameters, EvaluationWorkspace &workspace);
+
+
+    private:
+
+        Noise noise;
+        ModelType &fusedModel;                      // The same model as in the base class, with its actual type
+        bool parallelEvaluation;                    // If true, the blocks are evaluated by several threads
+        int maxNthreads;                            // Largest number of threads used in a parallel evaluation
+
+}; // END class FusedLikelihood
+
+
+
+
+
+
+
+
+
+
+// FusedLikelihood::FusedLikelihood()
+//
+// PURPOSE:
+//      Derived class constructor.
+//
+// INPUT:
+//      observations:   array containing the dependent variable values
+//      noise:          object specifying the noise term of the likelihood, e.g. NormalNoise
+//      model:          object specifying the model to be used, e.g. PolynomialModel
+//
+// REMARKS:
+//      Because of the template, this function needs to be in the header file.
+//
+
+template <class Noise, class ModelType>
+FusedLikelihood<Noise, ModelType>::FusedLikelihood(const RefArrayXd observations, const Noise &noise, ModelType &model)
+: Likelihood(observations, model),
+  noise(noise),
+  fusedModel(model),
+  parallelEvaluation(false),
+  maxNthreads(1)
+{
+    if (noise.getNpoints() != observations.size())
+    {
+        cerr << "Error: the noise term and the observations have different numbers of points." << endl;
+        exit(EXIT_FAILURE);
+    }
+}
+
+
+
+
+
+
+
+
+
+
+// FusedLikelihood::~FusedLikelihood()
+//
+// PURPOSE:
+//      Derived class destructor.
+//
+
+template <class Noise, class ModelType>
+FusedLikelihood<Noise, ModelType>::~FusedLikelihood()
+{
+
+}
+
+
+
+
+
+
+
+
+
+
+// FusedLikelihood::enableParallelEvaluation()
+//
+// PURPOSE:
+//      Makes each evaluation of the likelihood distribute its blocks of points among several threads.
+//      The noise term of each block is stored and the partial sums are added pairwise at the end, so that 
+//      the result does not depend on the number of threads, nor on the order in which the blocks are done.
+//
+// INPUT:
+//      maxNthreads: the largest number of threads to be used. If 0, the number of cores of the machine.
+//
+// OUTPUT:
+//      void
+//
+// REMARKS:
+//      Because of the template, this function needs to be in the header file.
+//      The threads are only created if the code is compiled with OpenMP (USE_OPENMP). 
+//      Within an enclosing parallel region, e.g. the initial sampling of the nested sampler,
+//      the evaluation is done by the calling thread alone, since nested parallelism is disabled by default.
+//
+
+template <class Noise, class ModelType>
+void FusedLikelihood<Noise, ModelType>::enableParallelEvaluation(const int maxNthreads)
+{
+    assert(maxNthreads >= 0);
+
+    parallelEvaluation = true;
+
+    if (maxNthreads > 0)
+        this->maxNthreads = maxNthreads;
+    else
+        this->maxNthreads = max(1, static_cast<int>(thread::hardware_concurrency()));
+}
+
+
+
+
+
+
+
+
+
+
+// FusedLikelihood::disableParallelEvaluation()
+//
+// PURPOSE:
+//      Reverts to the evaluation of all the blocks by the calling thread.
+//
+// OUTPUT:
+//      void
+//
+// REMARKS:
+//      Because of the template, this function needs to be in the header file.
+//
+
+template <class Noise, class ModelType>
+void FusedLikelihood<Noise, ModelType>::disableParallelEvaluation()
+{
+    parallelEvaluation = false;
+    maxNthreads = 1;
+}
+
+
+
+
+
+
+
+
+
+
+// FusedLikelihood::getNthreads()
+//
+// PURPOSE:
+//      Gets the number of threads used by an evaluation of the likelihood. Each thread is 
+//      given at least minNblocksPerThread blocks, i.e. 64k points, so that the cost of starting 
+//      the threads remains small compared to their work. This is always 1 if the parallel 
+//      evaluation is disabled.
+//
+// OUTPUT:
+//      An integer containing the number of threads.
+//
+// REMARKS:
+//      Because of the template, this function needs to be in the header file.
+//
+
+template <class Noise, class ModelType>
+int FusedLikelihood<Noise, ModelType>::getNthreads()
+{
+    if (!parallelEvaluation)
+        return 1;
+
+    const int Nblocks = (observations.size() + blockSize - 1) / blockSize;
+
+    return max(1, min(maxNthreads, Nblocks / minNblocksPerThread));
+}
+
+
+
+
+
+
+
+
+
+
+// FusedLikelihood::logValue()
+//
+// PURPOSE:
+//      Computes the natural logarithm of the likelihood, using the workspace of the calling thread.
+//
+// INPUT:
+//      modelParameters: a one-dimensional array containing the actual
+//      values of the free parameters that describe the model.
+//
+// OUTPUT:
+//      a double number containing the natural logarithm of the likelihood
+//
+// REMARKS:
+//      Because of the template, this function needs to be in the header file.
+//
+
+template <class Noise, class ModelType>
+double FusedLikelihood<Noise, ModelType>::logValue(RefArrayXd const modelParameters)
+{
+    return logValue(modelParameters, EvaluationWorkspace::getThreadWorkspace());
+}
+
+
+
+
+
+
+
+
+
+
+// FusedLikelihood::logValue()
+//
+// PURPOSE:
+//      Computes the natural logarithm of the likelihood, by predicting the model one block
+//      of points at a time and computing the noise term of each block while it is still in the cache.
+//      The observations and the covariates are hence read only once per evaluation, and no memory is allocated.
+//      The noise terms of the blocks are stored in the workspace and then added pairwise, which keeps the 
+//      rounding error small for large data sets. In a parallel evaluation, the blocks are shared among 
+//      the threads, and the result is the same as with a single thread.
+//
+// INPUT:
+//      modelParameters: a one-dimensional array containing the actual
+//      values of the free parameters that describe the model.
+//      workspace: the workspace of the calling thread, for the noise terms of the blocks.
+//
+// OUTPUT:
+//      a double number containing the natural logarithm of the likelihood
+//
+// REMARKS:
+//      Because of the template, this function needs to be in the header file.
+//
+
+template <class Noise, class ModelType>
+double FusedLikelihood<Noise, ModelType>::logValue(RefArrayXd const modelParameters, EvaluationWorkspace &workspace)
+{
+    const int Npoints = observations.size();
+    const int Nblocks = (Npoints + blockSize - 1) / blockSize;
+    ArrayXd &blockLogLikelihoods = workspace.getLikelihoodArray(Nblocks);
+
+
+    // Each thread uses a buffer of predictions of its own, on its stack
+
+    #ifdef _OPENMP
+    #pragma omp parallel for schedule(static) num_threads(getNthreads()) if(getNthreads() > 1)
+    #endif
+    for (int block = 0; block < Nblocks; ++block)
+    {
+        Eigen::Array<double, blockSize, 1> predictions;
+        int begin = block * blockSize;
+        int size = (Npoints - begin < blockSize) ? (Npoints - begin) : blockSize;
+
+        fusedModel.predictBlock(predictions.data(), begin, size, modelParameters);
+        blockLogLikelihoods(block) = noise.reduceBlock(observations.data(), predictions.data(), begin, size);
+    }
+
+    return noise.getLogNormalization() + Functions::pairwiseSum(blockLogLikelihoods);
+}
+
+
+#endif
@@ -14,9 +14,15 @@
 #include <random>
 #include <limits>
 #include <iostream>
+#include <vector>
+#include <Eigen/Cholesky>
 #include "Clusterer.h"
 #include "Functions.h"
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 
 using namespace std;
 
@@ -24,28 +30,34 @@ using namespace std;
 class GaussianMixtureClusterer : public Clusterer
 {
     public:
+
+        enum CovarianceType {FULL, DIAGONAL, SPHERICAL, TIED};
     
         GaussianMixtureClusterer(Metric &metric, Projector &featureProjector, bool featureProjectionActivated,
-        unsigned int minNclusters, unsigned int maxNclusters, unsigned int Ntrials, double relTolerance);
+        unsigned int minNclusters, unsigned int maxNclusters, unsigned int Ntrials, double relTolerance,
+        bool warmStartActivated = false, double maxRelativeBICdegradation = 0.05, unsigned int maxNconsecutiveWarmStarts = 10,
+        CovarianceType covarianceType = FULL, unsigned int maxNiterations = 30);
         ~GaussianMixtureClusterer();
     
         virtual int cluster(RefArrayXXd sample, vector<int> &optimalClusterIndices, vector<int> &optimalClusterSizes);
+        virtual int clusterWithWarmStart(RefArrayXXd sample, vector<int> &clusterIndices, vector<int> &clusterSizes);
         ArrayXXd getCenters();
         ArrayXXd getCovarianceMatrices();
-        ArrayXXd getInverseOfCovarianceMatrices();
-        ArrayXd getDeterminantOfCovarianceMatrices();
+        ArrayXXd getCholeskyFactorsOfCovarianceMatrices();
+        ArrayXd getLogDeterminantOfCovarianceMatrices();
+        ArrayXXd getInverseOfCovarianceMatrices();                // Deprecated: use getCholeskyFactorsOfCovarianceMatrices()
+        ArrayXd getDeterminantOfCovarianceMatrices();             // Deprecated: use getLogDeterminantOfCovarianceMatrices()
 
 
     protected:
   
         ArrayXXd centers;
         ArrayXXd covarianceMatrices;
-        ArrayXXd inverseOfCovarianceMatrices;
-        ArrayXd determinantOfCovarianceMatrices;
-        ArrayXXd differenceFromCenters;
-        ArrayXXd multivariateGaussians;
+        ArrayXXd choleskyFactorsOfCovarianceMatrices;       // Lower triangular factors L of each covariance matrix = L*L^T
+        ArrayXd logDeterminantOfCovarianceMatrices;
+        ArrayXXd logMultivariateGaussians;
         ArrayXd amplitudes;
-        ArrayXd modelProbability;
+        ArrayXd logModelProbability;
         ArrayXXd assignmentProbabilities;
         ArrayXd responsibilities;
 
@@ -54,9 +66,16 @@ class GaussianMixtureClusterer : public Clusterer
 
     private:
     
+        int clusterProjectedSample(RefArrayXXd optimizedSample, vector<int> &optimalClusterIndices, 
+                                   vector<int> &optimalClusterSizes);
         void chooseInitialClusterCenters(RefArrayXXd sample);
-        void chooseInitialClusterCovarianceMatrices(RefArrayXXd sample);
+        bool chooseInitialClusterCovarianceMatrices(RefArrayXXd sample);
+        bool computeCholeskyFactors();
+        bool chooseClusterParametersFromPartition(RefArrayXXd sample, vector<int> &clusterIndices, vector<int> &clusterSizes);
+        void resizeClusterArrays();
+        double evaluateBICvalue(double totalLogOfModelProbability);
         void computeGaussianMixtureModel(RefArrayXXd sample);
+        bool updateClusterParameters(RefArrayXXd sample);
         
         bool updateClustersUntilConverged(RefArrayXXd sample);
         bool searchForEmptyClusters();
@@ -74,6 +93,18 @@ class GaussianMixtureClusterer : public Clusterer
         double relTolerance;
         mt19937 engine;
 
+        CovarianceType covarianceType;
+        unsigned int maxNiterations;                // Maximum number of EM iterations for each trial
+        int NpointsPerChunk;                        // Number of points processed together in the E- and M-steps
+
+        bool warmStartActivated;                    // Refine the previous partition instead of a full search, when possible
+        bool previousPartitionIsAvailable;          // True if a valid partition was found at the previous call
+        unsigned int maxNconsecutiveWarmStarts;     // Maximum number of warm starts before a full search is forced again
+        unsigned int NconsecutiveWarmStarts;        // Number of warm starts accepted since the last full search
+        unsigned int previousNdimensions;           // Dimensionality of the (projected) sample of the previous partition
+        double maxRelativeBICdegradation;           // Maximum relative decrease of the BIC per point accepted for a warm start
+        double previousBICvaluePerPoint;            // BIC value per point of the partition of the last full search
+
 };
 
 
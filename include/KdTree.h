@@ -0,0 +1,71 @@
+// Class for a k-d tree spatial index over a sample of points, 
+// used for fast neighbour queries within the clustering classes.
+// Header file "KdTree.h"
+// Implementations contained in "KdTree.cpp"
+
+
+#ifndef KDTREE_H
+#define KDTREE_H
+
+#include <vector>
+#include <cmath>
+#include <cassert>
+#include <queue>
+#include <limits>
+#include <algorithm>
+#include <Eigen/Core>
+#include "Metric.h"
+
+
+using namespace std;
+using namespace Eigen;
+
+
+class KdTree
+{
+    public:
+    
+        KdTree(Metric &metric, unsigned int maxNpointsPerLeaf = 16);
+        ~KdTree(){};
+
+        void build(RefArrayXXd sample);
+        void radiusSearch(RefArrayXd point, const double radius, vector<int> &neighbourIndices);
+        void nearestNeighbours(RefArrayXd point, const int Nneighbours, vector<int> &neighbourIndices, 
+                               vector<double> &neighbourDistances);
+        unsigned int getNpoints();
+        unsigned int getNdimensions();
+
+
+    protected:
+
+        struct Node
+        {
+            int first;                  // First position (in sortedIndices) of the points of the node
+            int last;                   // Position past the last point of the node
+            int splitDimension;         // Coordinate along which the node is split, -1 for a leaf
+            double splitValue;          // Coordinate value of the splitting hyperplane
+            int leftChild;              // Index of the child node containing coordinates <= splitValue
+            int rightChild;             // Index of the child node containing coordinates >= splitValue
+        };
+
+        Metric &metric;
+        unsigned int maxNpointsPerLeaf;
+        unsigned int Ndimensions;
+        unsigned int Npoints;
+        ArrayXXd sortedPoints;          // The points, reordered such that each node covers a contiguous block of columns
+        vector<int> sortedIndices;      // For each column of sortedPoints, the index of the point in the original sample
+        vector<Node> nodes;             // All the nodes of the tree, the root node being the first one
+        int maxNpointsInLeaves;         // Largest number of points actually contained in a leaf
+
+
+    private:
+
+        int buildNode(RefArrayXXd sample, const int first, const int last);
+        void radiusSearchInNode(const int nodeIndex, RefArrayXd point, const double radius, vector<int> &neighbourIndices,
+                                ArrayXd &leafDistances);
+        void nearestNeighboursInNode(const int nodeIndex, RefArrayXd point, const int Nneighbours, 
+                                     priority_queue<pair<double, int> > &nearestPoints, ArrayXd &leafDistances);
+};
+
+
+#endif
@@ -25,11 +25,14 @@ class KmeansClusterer : public Clusterer
     public:
     
         KmeansClusterer(Metric &metric, Projector &featureProjector, bool featureProjectionActivated, 
-        unsigned int minNclusters, unsigned int maxNclusters, unsigned int Ntrials, double relTolerance);
+        unsigned int minNclusters, unsigned int maxNclusters, unsigned int Ntrials, double relTolerance,
+        bool warmStartActivated = false, double maxRelativeBICdegradation = 0.05, unsigned int maxNconsecutiveWarmStarts = 10,
+        bool hierarchicalSplittingActivated = false);
         
         ~KmeansClusterer();
     
         virtual int cluster(RefArrayXXd sample, vector<int> &optimalClusterIndices, vector<int> &optimalClusterSizes);
+        virtual int clusterWithWarmStart(RefArrayXXd sample, vector<int> &clusterIndices, vector<int> &clusterSizes);
   
 
     protected:
@@ -37,12 +40,18 @@ class KmeansClusterer : public Clusterer
 
     private:
     
+        int clusterProjectedSample(RefArrayXXd optimizedSample, vector<int> &optimalClusterIndices, 
+                                   vector<int> &optimalClusterSizes);
         void chooseInitialClusterCenters(RefArrayXXd sample, RefArrayXXd centers);
         bool updateClusterCentersUntilConverged(RefArrayXXd sample, RefArrayXXd centers, 
                                                 RefArrayXd clusterSizes, vector<int> &clusterIndices,
                                                 double &sumOfDistancesToClosestCenter, double relTolerance);
         double evaluateBICvalue(RefArrayXXd sample, RefArrayXXd centers, RefArrayXd clusterSizes, 
                                 vector<int> &clusterIndices);
+        bool findBestClustering(RefArrayXXd sample, ArrayXXd &bestCenters, ArrayXd &bestClusterSizes, 
+                                vector<int> &bestClusterIndices);
+        bool splitClustersHierarchically(RefArrayXXd sample, vector<int> &optimalClusterIndices, 
+                                         vector<int> &optimalClusterSizes, double &optimalBICvalue);
 
         unsigned int minNclusters;
         unsigned int maxNclusters;
@@ -53,6 +62,16 @@ class KmeansClusterer : public Clusterer
         double relTolerance;
         mt19937 engine;
 
+        bool warmStartActivated;                    // Refine the previous partition instead of a full search, when possible
+        bool previousPartitionIsAvailable;          // True if a valid partition was found at the previous call
+        unsigned int maxNconsecutiveWarmStarts;     // Maximum number of warm starts before a full search is forced again
+        unsigned int NconsecutiveWarmStarts;        // Number of warm starts accepted since the last full search
+        unsigned int previousNdimensions;           // Dimensionality of the (projected) sample of the previous partition
+        double maxRelativeBICdegradation;           // Maximum relative increase of the BIC per point accepted for a warm start
+        double previousBICvaluePerPoint;            // BIC value per point of the partition of the last full search
+
+        bool hierarchicalSplittingActivated;        // Find the number of clusters by splitting clusters in two (X-means) instead of a sweep
+
 };
 
 
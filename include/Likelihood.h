@@ -10,6 +10,7 @@
 #include <Eigen/Core>
 #include "Functions.h"
 #include "Model.h"
+#include "EvaluationWorkspace.h"
 
 
 using namespace std;
@@ -27,6 +28,7 @@ class Likelihood
         ArrayXd getObservations();
 
         virtual double logValue(RefArrayXd const modelParameters) = 0;
+        virtual double logValue(RefArrayXd const modelParameters, EvaluationWorkspace &workspace);
 
 
     protected:
@@ -0,0 +1,64 @@
+// Class for a dynamic spatial index over the set of live points of the nesting process,
+// answering nearest-neighbour and radius queries while the live points are replaced or removed.
+// Header file "LivePointIndex.h"
+// Implementations contained in "LivePointIndex.cpp"
+
+
+#ifndef LIVEPOINTINDEX_H
+#define LIVEPOINTINDEX_H
+
+#include <vector>
+#include <cmath>
+#include <cassert>
+#include <algorithm>
+#include <Eigen/Core>
+#include "Metric.h"
+#include "KdTree.h"
+
+
+using namespace std;
+using namespace Eigen;
+
+
+class LivePointIndex
+{
+    public:
+    
+        LivePointIndex(Metric &metric, double maxRelativeNupdates = 0.1, unsigned int maxNpointsPerLeaf = 16);
+        ~LivePointIndex(){};
+
+        void build(RefArrayXXd livePoints);
+        void replacePoint(const int livePointIndex, RefArrayXd newPoint);
+        void removePoint(const int livePointIndex);
+        void radiusSearch(RefArrayXd point, const double radius, vector<int> &neighbourIndices);
+        void nearestNeighbours(RefArrayXd point, const int Nneighbours, vector<int> &neighbourIndices, 
+                               vector<double> &neighbourDistances);
+        int getNpoints();
+        int getNupdatesSinceLastBuild();
+        int getNbuilds();
+
+
+    protected:
+
+        Metric &metric;
+        KdTree tree;                            // The k-d tree built from the live points at the last (re)build
+        double maxRelativeNupdates;             // Fraction of the number of live points that can be updated before a rebuild
+        int Npoints;                            // Current number of live points
+        int NupdatesSinceLastBuild;             // Number of insertions and deletions accumulated since the last (re)build
+        int NdeletedTreePoints;                 // Number of points of the tree that are no longer live points
+        int Nbuilds;                            // Number of times the tree has been (re)built
+        ArrayXXd livePoints;                    // A copy of the current live points, needed for the points not yet in the tree
+        vector<int> livePointIndexOfTreePoint;  // For each point of the tree, its current live point index, or -1 if deleted
+        vector<int> treePointIndexOfLivePoint;  // For each live point, its index in the tree, or -1 if not in the tree
+        vector<int> bufferedLivePoints;         // Indices of the live points inserted since the last (re)build
+        ArrayXXd bufferedPoints;                // Coordinates of the buffered live points, stored contiguously for the distance computations
+
+
+    private:
+
+        void deletePoint(const int livePointIndex);
+        void rebuildIfNeeded();
+};
+
+
+#endif
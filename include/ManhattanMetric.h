@@ -24,6 +24,8 @@ class ManhattanMetric : public Metric
         ~ManhattanMetric(){};
 
         virtual double distance(RefArrayXd point1, RefArrayXd point2);
+        virtual void pointToCentersDistances(RefArrayXd point, RefArrayXXd centers, RefArrayXd distances, bool reduced = false);
+        virtual void pairwiseDistances(RefArrayXXd sample1, RefArrayXXd sample2, RefArrayXXd distances, bool reduced = false);
 
     protected:
     
@@ -31,12 +31,14 @@ class MeanNormalLikelihood : public Likelihood
         ArrayXd getWeights();
 
         virtual double logValue(RefArrayXd const modelParameters);
+        virtual double logValue(RefArrayXd const modelParameters, EvaluationWorkspace &workspace);
 
     private:
         
         ArrayXd uncertainties;
         ArrayXd normalizedUncertainties;
         ArrayXd weights;
+        double logNormalization;            // Term of log(Likelihood) independent of the free parameters
 
 }; // END class MeanNormalLikelihood
 
@@ -0,0 +1,47 @@
+// Class for a read-only memory mapping of a file, so that large files can be
+// accessed directly from memory without reading or parsing them first.
+// Header file "MemoryMappedFile.h"
+// Implementations contained in "MemoryMappedFile.cpp"
+
+
+#ifndef MEMORYMAPPEDFILE_H
+#define MEMORYMAPPEDFILE_H
+
+#include <cstdlib>
+#include <cstddef>
+#include <string>
+#include <iostream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+
+using namespace std;
+
+
+class MemoryMappedFile
+{
+    public:
+
+        MemoryMappedFile(const string fileName);
+        ~MemoryMappedFile();
+
+        const char *getData();
+        size_t getSize();
+        string getFileName();
+
+
+    private:
+
+        string fileName;            // Full path of the mapped file
+        int fileDescriptor;         // Descriptor of the open file
+        char *data;                 // Beginning of the mapped region, NULL for an empty file
+        size_t size;                // Size of the file in bytes
+
+        MemoryMappedFile(const MemoryMappedFile &);                 // The mapping is owned by a single object, hence
+        MemoryMappedFile &operator=(const MemoryMappedFile &);      // it cannot be copied
+};
+
+
+#endif
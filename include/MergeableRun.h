@@ -0,0 +1,73 @@
+// Abstract base class for reading the posterior sample of a single nested sampling run
+// one point at a time, in order of increasing likelihood, as required by PosteriorMerger.
+// The dead points of a run are already stored in this order, while the final live points,
+// appended at the end of the sample, are not: these are loaded and sorted in memory.
+// The number of live points of each dead point is read together with the point, from
+// the values stored by the nesting process.
+// Header file "MergeableRun.h"
+// Implementations contained in "MergeableRun.cpp"
+
+
+#ifndef MERGEABLERUN_H
+#define MERGEABLERUN_H
+
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <string>
+#include <Eigen/Core>
+
+
+using namespace std;
+using namespace Eigen;
+
+
+class MergeableRun
+{
+    public:
+
+        MergeableRun(const string runName);
+        virtual ~MergeableRun(){};
+
+        string getRunName();
+        int getNdimensions();
+        long getNsamples();
+        int getNlivePoints();
+        int getNfinalLivePoints();
+        int getCurrentNlivePoints();
+        bool isExhausted();
+        double getLogLikelihood();
+        const double *getParameters();
+        void next();
+
+
+    protected:
+
+        string runName;                 // Name of the run, e.g. the path of its input files
+        int Ndimensions;                // Number of free parameters of the run
+        long Nsamples;                  // Total number of points of the posterior sample of the run
+        int NlivePoints;                // Initial number of live points of the nesting process
+        int NfinalLivePoints;           // Number of live points appended at the end of the posterior sample
+
+        void start();
+        virtual void readNextSample(double &logLikelihood, double *parameters) = 0;
+        virtual int readNextNlivePoints() = 0;
+
+
+    private:
+
+        long Nconsumed;                             // Number of points already taken from the run
+        double currentLogLikelihood;                // log(Likelihood) of the current point
+        int currentNlivePoints;                     // Number of live points of the current point, if a dead point
+        vector<double> currentParameters;           // Parameter values of the current point
+        ArrayXXd finalLiveSample;                   // Parameter values of the final live points, one column per point
+        ArrayXd finalLiveLogLikelihood;             // log(Likelihood) values of the final live points
+        vector<int> finalLiveOrder;                 // Indices of the final live points by increasing log(Likelihood)
+
+        void loadCurrentSample();
+
+}; // END class MergeableRun
+
+
+#endif
@@ -13,6 +13,7 @@
 
 using namespace std;
 typedef Eigen::Ref<Eigen::ArrayXd> RefArrayXd;
+typedef Eigen::Ref<Eigen::ArrayXXd> RefArrayXXd;
 
 
 class Metric
@@ -23,6 +24,9 @@ class Metric
         ~Metric(){};
 
         virtual double distance(RefArrayXd point1, RefArrayXd point2) = 0;
+        virtual void pointToCentersDistances(RefArrayXd point, RefArrayXXd centers, RefArrayXd distances, bool reduced = false);
+        virtual void pairwiseDistances(RefArrayXXd sample1, RefArrayXXd sample2, RefArrayXXd distances, bool reduced = false);
+        virtual double reducedDistanceToDistance(double reducedDistance);
 
     protected:
     
@@ -11,6 +11,7 @@
 #include <cstdlib>
 #include <Eigen/Core>
 #include "Functions.h"
+#include "EvaluationWorkspace.h"
 
 
 using namespace std;
@@ -27,6 +28,7 @@ class Model
         ArrayXd getCovariates();
 
         virtual void predict(RefArrayXd predictions, const RefArrayXd modelParameters) = 0;
+        virtual void predict(RefArrayXd predictions, const RefArrayXd modelParameters, EvaluationWorkspace &workspace);
         int getNparameters();
 
 
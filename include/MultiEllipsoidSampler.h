@@ -56,6 +56,7 @@ class MultiEllipsoidSampler : public NestedSampler
     private:
 
         vector<Ellipsoid> ellipsoids;
+        vector<int> clusterIndicesOfEllipsoids; // For each ellipsoid, the index of the cluster it was computed from
         int Nellipsoids;                        // Total number of ellipsoids computed
         double initialEnlargementFraction;      // Initial fraction for enlargement of ellipsoids
         double shrinkingRate;                   // Prior volume shrinkage rate (between 0 and 1)
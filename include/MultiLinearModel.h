@@ -30,6 +30,7 @@ class MultiLinearModel : public Model
         int getNpoints();
 
         virtual void predict(RefArrayXd predictions, const RefArrayXd modelParameters);
+        void predictBlock(double *predictions, const int begin, const int size, const RefArrayXd modelParameters);
 
     protected:
 
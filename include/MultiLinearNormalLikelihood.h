@@ -32,12 +32,15 @@ class MultiLinearNormalLikelihood : public Likelihood
         ArrayXd getObservationsUncertainty();
 
         virtual double logValue(RefArrayXd const modelParameters);
+        virtual double logValue(RefArrayXd const modelParameters, EvaluationWorkspace &workspace);
 
 
     private:
 
         ArrayXd covariatesUncertainties;
         ArrayXd observationsUncertainty;
+        ArrayXd covariatesVariances;            // Squared uncertainties of the covariates
+        ArrayXd observationsVariance;           // Squared uncertainties of the observations
         int Nobservables;
         int Npoints;
 
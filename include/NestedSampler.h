@@ -22,6 +22,7 @@
 #include "Likelihood.h"
 #include "Metric.h"
 #include "Clusterer.h"
+#include "LivePointIndex.h"
 #include "LivePointsReducer.h"
 #include "File.h"
 
@@ -64,9 +65,10 @@ class NestedSampler
         double getLogMaxLikelihoodOfLivePoints();
         double getComputationalTime();
         double getTerminationFactor();
-        vector<int> getNlivePointsPerIteration();
-        ArrayXXd getNestedSample();
-        ArrayXd getLogLikelihood();
+        const vector<int> &getNlivePointsPerIteration();
+        const ArrayXXd &getNestedSample();
+        LivePointIndex &getLivePointIndex();
+        const ArrayXd &getLogLikelihood();
         
         void setLogEvidence(double newLogEvidence);
         double getLogEvidence();
@@ -78,19 +80,23 @@ class NestedSampler
         double getInformationGain();
         
         void setPosteriorSample(ArrayXXd newPosteriorSample);
-        ArrayXXd getPosteriorSample();
+        const ArrayXXd &getPosteriorSample();
         
         void setLogLikelihoodOfPosteriorSample(ArrayXd newLogLikelihoodOfPosteriorSample);
-        ArrayXd getLogLikelihoodOfPosteriorSample();
+        const ArrayXd &getLogLikelihoodOfPosteriorSample();
         
         void setLogWeightOfPosteriorSample(ArrayXd newLogWeightOfPosteriorSample);
-        ArrayXd getLogWeightOfPosteriorSample();
+        const ArrayXd &getLogWeightOfPosteriorSample();
         
-        ArrayXd getLogEvidenceOfPosteriorSample();
-        ArrayXd getLogMeanLiveEvidenceOfPosteriorSample();
+        const ArrayXd &getLogEvidenceOfPosteriorSample();
+        const ArrayXd &getLogMeanLiveEvidenceOfPosteriorSample();
         
         void setOutputPathPrefix(string newOutputPathPrefix);
         string getOutputPathPrefix();
+
+        void setAdaptiveReclustering(const bool activated, const double minFractionOfClusteringInterval = 0.2,
+                                     const double maxMultipleOfClusteringInterval = 10.0, const double maxRelativeAcceptanceRateDrop = 0.5,
+                                     const double maxRelativeBoundingVolumeGrowth = 8.0, const double maxClusterSizeDrift = 0.1);
        
         ofstream outputFile;                        // An output file stream to save configuring parameters also from derived classes 
 
@@ -111,6 +117,11 @@ class NestedSampler
         double logRemainingPriorMass;               // The remaining width in prior mass at a given nested iteration (log X)
         double ratioOfRemainderToCurrentEvidence;   // The current ratio of live to cumulated evidence 
         vector<int> NlivePointsPerIteration;        // A vector that stores the number of live points used at each iteration of the nesting process
+        LivePointIndex livePointIndex;              // A spatial index of the current live points, for fast neighbour queries
+        bool livePointIndexIsUpToDate;              // True once the index has been built, and as long as it follows the live points
+        int NdrawAttemptsOfLastDraw;                // Number of attempts of the last call to drawWithConstraint(), 0 if not provided by the sampler
+        int clusterIndexOfLastDrawnPoint;           // Cluster in which the last point was drawn, -1 if not provided by the sampler
+        double logBoundingVolumeOfLastDraw;         // log of the total volume of the bounds used for the last draw, NaN if not provided by the sampler
         
         mt19937 engine;
         virtual bool verifySamplerStatus() = 0; 
@@ -138,8 +149,28 @@ class NestedSampler
         ArrayXd logEvidenceOfPosteriorSample;    // log(Evidence) cumulated at iteration in the nesting process
         ArrayXd logMeanLiveEvidenceOfPosteriorSample; // log(MeanLiveEvidence) remaining at each iteration in the nesting process
 
+        bool adaptiveReclusteringActivated;      // Recluster when the telemetry of the draws degrades rather than at fixed intervals
+        double minFractionOfClusteringInterval;  // Minimum interval between two clusterings in the adaptive mode, relative to NiterationsWithSameClustering
+        double maxMultipleOfClusteringInterval;  // Maximum interval between two clusterings in the adaptive mode, relative to NiterationsWithSameClustering
+        int minNiterationsWithSameClustering;    // Minimum number of iterations between two clusterings in the adaptive mode
+        int maxNiterationsWithSameClustering;    // Maximum number of iterations between two clusterings in the adaptive mode
+        double maxRelativeAcceptanceRateDrop;    // Relative drop of the acceptance rate of the draws that triggers a clustering
+        double maxRelativeBoundingVolumeGrowth;  // Growth of the ratio of bounding volume to remaining prior mass that triggers a clustering
+        double maxClusterSizeDrift;              // Fraction of live points drifted between clusters that triggers a clustering
+        int NiterationsSinceClustering;          // Number of iterations since the last clustering
+        int NdrawAttemptsSinceClustering;        // Number of draw attempts since the last clustering
+        double referenceAcceptanceRate;          // Acceptance rate of the draws in the first iterations after the last clustering
+        double recentAcceptanceRate;             // Moving average of the acceptance rate of the draws
+        double referenceLogBoundingVolumeRatio;  // log of bounding volume over remaining prior mass right after the last clustering
+        double recentLogBoundingVolumeRatio;     // log of bounding volume over remaining prior mass at the last draw
+        vector<int> driftedClusterSizes;         // Sizes of the clusters according to the clusters in which new points were drawn
+
         void removeLivePointsFromSample(const vector<int> &indicesOfLivePointsToRemove, 
                                         vector<int> &clusterIndices, vector<int> &clusterSizes);
+        void resetReclusteringTelemetry(const vector<int> &clusterSizes);
+        void updateReclusteringTelemetry(const int clusterIndexOfReplacedPoint);
+        int findReasonForReclustering(const vector<int> &clusterSizes);
+        double computeClusterSizeDrift(const vector<int> &clusterSizes);
         void printComputationalTime(const double startTime);
 }; 
 
@@ -30,11 +30,14 @@ class NormalLikelihood : public Likelihood
         ArrayXd getUncertainties();
 
         virtual double logValue(RefArrayXd const modelParameters);
+        virtual double logValue(RefArrayXd const modelParameters, EvaluationWorkspace &workspace);
 
 
     private:
 
         ArrayXd uncertainties;
+        ArrayXd inverseVariances;           // 1/sigma^2 of each observation
+        double logNormalization;            // -0.5*N*log(2*pi) - sum(log(sigma)), independent of the free parameters
 
 }; 
 
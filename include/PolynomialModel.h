@@ -29,6 +29,7 @@ class PolynomialModel : public Model
         int getNdegrees();
 
         virtual void predict(RefArrayXd predictions, const RefArrayXd modelParameters);
+        void predictBlock(double *predictions, const int begin, const int size, const RefArrayXd modelParameters);
 
     protected:
 
@@ -0,0 +1,74 @@
+// Class for merging the posterior samples of any number of independent nested sampling runs
+// of the same inference problem into a single posterior sample, with its evidence.
+// The runs, given as binary posterior files or as prefixes of ASCII output files, are streamed
+// through a k-way merge by increasing likelihood, so that the memory used is set by the size of
+// the output buffers and by the final live points of the runs, and not by the size of the posterior.
+// Header file "PosteriorMerger.h"
+// Implementations contained in "PosteriorMerger.cpp"
+
+
+#ifndef POSTERIORMERGER_H
+#define POSTERIORMERGER_H
+
+#include <cstdlib>
+#include <cassert>
+#include <cstring>
+#include <cmath>
+#include <limits>
+#include <queue>
+#include <algorithm>
+#include <vector>
+#include <string>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <Eigen/Core>
+#include "Functions.h"
+#include "File.h"
+#include "BufferedAsciiWriter.h"
+#include "BinaryPosteriorFile.h"
+#include "MergeableRun.h"
+#include "BinaryMergeableRun.h"
+#include "AsciiMergeableRun.h"
+
+
+using namespace std;
+using namespace Eigen;
+
+
+class PosteriorMerger
+{
+    public:
+
+        PosteriorMerger(const int bufferSize = 65536);
+        ~PosteriorMerger();
+
+        void addRun(const string inputName);
+        void merge(const string outputPathPrefix, const bool writeAsciiFiles = true);
+
+        int getNruns();
+        int getNdimensions();
+        long getNsamples();
+        int getNlivePoints();
+        double getLogEvidence();
+        double getLogEvidenceError();
+        double getInformationGain();
+
+
+    private:
+
+        int bufferSize;                         // Number of points collected before writing them to the output files
+        vector<MergeableRun*> runs;             // The runs to merge
+        int Ndimensions;                        // Number of free parameters, the same for all the runs
+        long Nsamples;                          // Total number of points of the merged posterior sample
+        int NlivePoints;                        // Total number of live points of the runs
+        double logEvidence;                     // Skilling's log(Evidence) of the merged sample
+        double logEvidenceError;                // Skilling's error on log(Evidence) of the merged sample
+        double informationGain;                 // Skilling's information gain of the merged sample
+
+        void writeBlock(ofstream &outputFile, const streamoff offset, const vector<double> &buffer, const size_t Nvalues);
+
+}; // END class PosteriorMerger
+
+
+#endif
@@ -9,6 +9,8 @@
 #ifndef PRINCIPALCOMPONENTPROJECTOR_H
 #define PRINCIPALCOMPONENTPROJECTOR_H
 
+#include <ctime>
+#include <random>
 #include "Projector.h"
 
 
@@ -21,7 +23,9 @@ class PrincipalComponentProjector : public Projector
 {
     public:
     
-        PrincipalComponentProjector(bool printNdimensions, double scalingFactor = 0.7);
+        PrincipalComponentProjector(bool printNdimensions, double scalingFactor = 0.7, bool incrementalUpdateActivated = false,
+                                    unsigned int NoversamplingDimensions = 5, unsigned int NsubspaceIterations = 1,
+                                    unsigned int seed = 0);
         ~PrincipalComponentProjector(){};
     
         virtual ArrayXXd projection(RefArrayXXd sample);
@@ -30,10 +34,19 @@ class PrincipalComponentProjector : public Projector
     protected:
     
         double scalingFactor;
+        bool incrementalUpdateActivated;        // Update the basis of the previous call instead of a full eigendecomposition
+        unsigned int NoversamplingDimensions;   // Number of components kept in the basis beyond the retained ones
+        unsigned int NsubspaceIterations;       // Number of subspace iterations for each update of the basis
+        bool basisIsAvailable;                  // True if a basis was computed at a previous call
+        MatrixXd basis;                         // Leading eigenvectors of the correlation matrix, by decreasing eigenvalue
+        mt19937 engine;                         // Random generator of the new vectors of the basis
     
 
     private:
 
+        void computeFullBasis(RefArrayXXd differenceFromCenters);
+        bool updateBasis(RefArrayXXd differenceFromCenters);
+
 };
 
 
@@ -16,10 +16,21 @@
 #include <iomanip>
 #include <cassert>
 #include <limits>
+#include <cstring>
+#include <stdint.h>
+#include <vector>
+#include <utility>
+#include <fstream>
+#include <ctime>
+#include <random>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 #include <Eigen/Core>
 #include "Functions.h"
 #include "File.h"
 #include "NestedSampler.h"
+#include "BinaryPosteriorFile.h"
 
 
 using namespace std;
@@ -29,6 +40,24 @@ typedef Eigen::Ref<Eigen::ArrayXd> RefArrayXd;
 typedef Eigen::Ref<Eigen::ArrayXXd> RefArrayXXd;
 
 
+// Header of each grid of the binary file written by Results::writeJointMarginalDistributionsToFile().
+// It only contains fields of 8 bytes, so that its layout does not depend on the padding added by the compiler.
+
+struct JointMarginalHeader
+{
+    uint64_t parameterNumber1;      // Index of the parameter along the rows of the grid
+    uint64_t parameterNumber2;      // Index of the parameter along the columns of the grid
+    uint64_t Nbins1;                // Number of bins of the first parameter
+    uint64_t Nbins2;                // Number of bins of the second parameter
+    double minimum1;                // Left edge of the first bin of the first parameter
+    double binWidth1;               // Width of the bins of the first parameter
+    double maximum1;                // Right edge of the last bin of the first parameter
+    double minimum2;                // Left edge of the first bin of the second parameter
+    double binWidth2;               // Width of the bins of the second parameter
+    double maximum2;                // Right edge of the last bin of the second parameter
+};
+
+
 class Results
 {
 
@@ -40,19 +69,26 @@ class Results
         void writeParametersToFile(string fileName, string outputFileExtension = ".txt");
         void writeLogLikelihoodToFile(string fileName);
         void writeLogWeightsToFile(string fileName);
+        void writeNlivePointsPerIterationToFile(string fileName);
         void writeEvidenceInformationToFile(string fileName);
         void writePosteriorProbabilityToFile(string fileName);
         void writeLogEvidenceToFile(string fileName);
         void writeLogMeanLiveEvidenceToFile(string fileName);
-        void writeParametersSummaryToFile(string fileName, const double credibleLevel = 68.27, const bool writeMarginalDistribution = true);
+        void writeParametersSummaryToFile(string fileName, const double credibleLevel = 68.27, const bool writeMarginalDistribution = true,
+                                          const bool useKernelDensityEstimation = false);
+        void writePosteriorToBinaryFile(string fileName);
+        void writeEqualWeightPosteriorToFile(string fileName, const int Ndraws = 0, const unsigned int seed = 0);
+        void writeJointMarginalDistributionsToFile(string fileName, vector<pair<int, int> > parameterPairs = vector<pair<int, int> >(),
+                                                   const int maxNbins = 100);
+        void writeEvidenceUncertaintyToFile(string fileName, const int Nsimulations = 1000, const unsigned int seed = 0);
+        static void writeEqualWeightPosteriorToFile(BinaryPosteriorFile &posteriorFile, string fullPath, 
+                                                    const int Ndraws = 0, const unsigned int seed = 0);
         void writeObjectsIdentificationToFile(){};          // TO DO
 
 
     protected:
 
         double marginalDistributionMode;
-        ArrayXd parameterValues;
-        ArrayXd marginalDistribution;
         ArrayXd parameterValuesRebinned;
         ArrayXd parameterValuesInterpolated;
         ArrayXd marginalDistributionRebinned;
@@ -64,9 +100,20 @@ class Results
         NestedSampler &nestedSampler;
        
         ArrayXd posteriorProbability();
+        ArrayXi getNlivePointsOfDeadPoints();
         void writeMarginalDistributionToFile(const int parameterNumber);
         ArrayXd computeCredibleLimits(const double credibleLevel, const double skewness, const int NinterpolationsPerBin = 10);
-        ArrayXXd parameterEstimation(const double credibleLevel, const bool writeMarginalDistribution);
+        ArrayXXd parameterEstimation(const double credibleLevel, const bool writeMarginalDistribution, 
+                                     const bool useKernelDensityEstimation);
+        static void computeScottBinning(const double secondMoment, const int sampleSize, const double parameterMinimum, 
+                                        const double parameterMaximum, const int maxNbins, int &Nbins, double &binWidth);
+        static void computeKernelDensityEstimate(RefArrayXd const parameterValues, RefArrayXd const marginalDistribution, 
+                                                 const int Ngrid, ArrayXd &gridValues, ArrayXd &gridProbability);
+        static ArrayXXd simulatePriorVolumes(ConstRefArrayXXd posteriorSample, ConstRefArrayXd logLikelihood, 
+                                             const vector<int> &NlivePointsPerIteration, const int NfinalLivePoints, 
+                                             const int Nsimulations, const unsigned int seed);
+        static void resampleToEqualWeights(ofstream &outputFile, ConstRefArrayXXd posteriorSample, ConstRefArrayXd logLikelihood,
+                                           ConstRefArrayXd logWeight, int Ndraws, const unsigned int seed);
 
 };
 #endif
@@ -0,0 +1,69 @@
+// Derived class for building a model of many Lorentzian mode profiles over a flat background,
+// as used for peak bagging of oscillation power spectra. Each profile is split into a broad,
+// smooth part, whose sum over all the modes is computed on a coarse grid and interpolated,
+// and a narrow part, which is only evaluated within a window of a given number of linewidths 
+// around the centroid, located by a binary search on the sorted frequency grid.
+// The model can also be evaluated one block of bins at a time, e.g. by FusedLikelihood.
+// The neglected narrow parts make the total power slightly lower than that of the exact sum of the
+// profiles. With the default window of 10 linewidths, the log(Likelihood) of a simulated spectrum of 10^6 bins
+// differs from the exact one by about 0.08 for 100 modes and 0.2 for 300 modes (see demoWindowedModeProfileModel).
+// Wider windows reduce this difference at a higher cost.
+// Header file "WindowedModeProfileModel.h"
+// Implementations contained in "WindowedModeProfileModel.cpp"
+
+
+#ifndef WINDOWEDMODEPROFILEMODEL_H
+#define WINDOWEDMODEPROFILEMODEL_H
+
+#include <cstdlib>
+#include <cmath>
+#include <iostream>
+#include <algorithm>
+#include <Eigen/Core>
+#include "Functions.h"
+#include "Model.h"
+
+
+using namespace std;
+using Eigen::ArrayXd;
+typedef Eigen::Ref<Eigen::ArrayXd> RefArrayXd;
+
+
+class WindowedModeProfileModel : public Model
+{
+    public:
+
+        WindowedModeProfileModel(const RefArrayXd covariates, const int Nmodes, const double NlinewidthsInWindow = 10.0,
+                                 const bool profileWithAmplitude = false);
+        ~WindowedModeProfileModel();
+        int getNmodes();
+        double getNlinewidthsInWindow();
+
+        virtual void predict(RefArrayXd predictions, const RefArrayXd modelParameters);
+        virtual void predict(RefArrayXd predictions, const RefArrayXd modelParameters, EvaluationWorkspace &workspace);
+        void predictBlock(double *predictions, const int begin, const int size, const RefArrayXd modelParameters);
+
+    protected:
+
+        int Nmodes;                         // Number of mode profiles
+        double NlinewidthsInWindow;         // Half width of the window of each profile, in units of its linewidth
+        bool profileWithAmplitude;          // If true, the profiles are parametrized by amplitude instead of height
+        int maxNcoarsePoints;               // Largest number of points of the coarse grid of the broad parts
+        double minLinewidth;                // Smallest linewidth used, to which non-positive linewidths are raised
+
+
+    private:
+
+        static const int NbroadTerms = 6;                   // Number of terms of the expansion of the broad part of each profile
+        static const int NcoarseSpacingsInHalfWindow = 8;   // Smallest number of coarse grid spacings in a window half width
+
+        double getLinewidth(const RefArrayXd modelParameters, const int mode);
+        double setCoarseGrid(const RefArrayXd modelParameters, int &NcoarsePoints, double &coarseSpacing);
+        double sumBroadParts(const int coarseIndex, const RefArrayXd modelParameters, const double coarseSpacing,
+                             const double minAllowedHalfWindow);
+        double computeBroadPart(const double distanceSquared, const double scale, const double halfWindowSquared, const double delta);
+
+}; // END class WindowedModeProfileModel
+
+
+#endif
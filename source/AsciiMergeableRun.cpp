@@ -0,0 +1,197 @@
+#include "AsciiMergeableRun.h"
+
+
+// AsciiMergeableRun::AsciiMergeableRun()
+//
+// PURPOSE:
+//      Constructor. Reads the sizes of the run from its computation parameters,
+//      opens all its ASCII files and loads its first point.
+//
+// INPUT:
+//      pathPrefix:     path prefix of the output files of the run, as set in NestedSampler
+//
+// REMARK:
+//      The file of the numbers of live points, written by Results::writeNlivePointsPerIterationToFile(),
+//      can be omitted only if the run never reduced its live points. The program is stopped otherwise.
+//
+
+AsciiMergeableRun::AsciiMergeableRun(const string pathPrefix)
+: MergeableRun(pathPrefix),
+  NlivePointsAreStored(true)
+{
+    // Rows #1, #2, #3, #8 and #12 of the computation parameters contain Ndimensions, the initial NlivePoints,
+    // the minimum NlivePoints, Niterations and the final NlivePoints, respectively
+
+    ArrayXXd computationParameters = File::arrayXXdFromFile(pathPrefix + "computationParameters.txt");
+
+    if (computationParameters.rows() < 12)
+    {
+        cerr << "Error: incomplete file " << pathPrefix << "computationParameters.txt" << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    Ndimensions = computationParameters(0,0);
+    NlivePoints = computationParameters(1,0);
+    NfinalLivePoints = computationParameters(11,0);
+    Nsamples = static_cast<long>(computationParameters(7,0)) + NfinalLivePoints;
+
+
+    // Open the log(Likelihood) file and the file of each parameter, named as in File::arrayXXdRowsToFiles()
+
+    File::openInputFile(logLikelihoodFile, pathPrefix + "logLikelihood.txt");
+
+    NlivePointsFile.open((pathPrefix + "NlivePointsPerIteration.txt").c_str());
+    
+    if (!NlivePointsFile.good())
+    {
+        int minNlivePoints = computationParameters(2,0);
+
+        if (minNlivePoints != NlivePoints)
+        {
+            cerr << "Error: run " << pathPrefix << " reduced its live points, but "
+                 << pathPrefix << "NlivePointsPerIteration.txt is missing" << endl;
+            exit(EXIT_FAILURE);
+        }
+
+        NlivePointsAreStored = false;
+    }
+
+    parameterFiles.resize(Ndimensions);
+
+    for (int i = 0; i < Ndimensions; ++i)
+    {
+        ostringstream numberString;
+        numberString << setfill('0') << setw(3) << i;
+
+        parameterFiles[i] = new ifstream;
+        File::openInputFile(*parameterFiles[i], pathPrefix + "parameter" + numberString.str() + ".txt");
+    }
+
+    start();
+}
+
+
+
+
+
+
+
+
+
+
+// AsciiMergeableRun::~AsciiMergeableRun()
+//
+// PURPOSE:
+//      Destructor. Closes all the input files.
+//
+
+AsciiMergeableRun::~AsciiMergeableRun()
+{
+    for (size_t i = 0; i < parameterFiles.size(); ++i)
+    {
+        delete parameterFiles[i];
+    }
+}
+
+
+
+
+
+
+
+
+
+
+// AsciiMergeableRun::readNextSample()
+//
+// PURPOSE:
+//      Reads the next line of the log(Likelihood) file and of each parameter file.
+//
+// INPUT:
+//      logLikelihood:  set to the log(Likelihood) value of the point
+//      parameters:     pointer to Ndimensions values, set to the parameter values of the point
+//
+// OUTPUT:
+//      void
+//
+
+void AsciiMergeableRun::readNextSample(double &logLikelihood, double *parameters)
+{
+    logLikelihood = readNextValue(logLikelihoodFile);
+
+    for (int i = 0; i < Ndimensions; ++i)
+    {
+        parameters[i] = readNextValue(*parameterFiles[i]);
+    }
+}
+
+
+
+
+
+
+
+
+
+
+// AsciiMergeableRun::readNextNlivePoints()
+//
+// PURPOSE:
+//      Reads the next line of the file of the numbers of live points.
+//
+// OUTPUT:
+//      The number of live points of the next dead point of the run. This is the
+//      initial number of live points if the run has no file of the numbers of live points.
+//
+
+int AsciiMergeableRun::readNextNlivePoints()
+{
+    if (!NlivePointsAreStored)
+        return NlivePoints;
+
+    return readNextValue(NlivePointsFile);
+}
+
+
+
+
+
+
+
+
+
+
+// AsciiMergeableRun::readNextValue()
+//
+// PURPOSE:
+//      Reads the number on the next line of an input file, skipping comment and empty lines.
+//
+// INPUT:
+//      inputFile:  one of the input files of the run
+//
+// OUTPUT:
+//      The value read. The program is stopped if the file ends, or if the line
+//      does not contain a number.
+//
+
+double AsciiMergeableRun::readNextValue(ifstream &inputFile)
+{
+    while (getline(inputFile, line))
+    {
+        if (line.empty() || line[0] == '#') continue;
+
+        char *conversionEnd;
+        double value = strtod(line.c_str(), &conversionEnd);
+
+        if (conversionEnd == line.c_str())
+        {
+            cerr << "Error: can't convert " << line << " to a number in run " << runName << endl;
+            exit(EXIT_FAILURE);
+        }
+
+        return value;
+    }
+
+    cerr << "Error: the files of run " << runName << " contain less than " << Nsamples << " points" << endl;
+    exit(EXIT_FAILURE);
+}
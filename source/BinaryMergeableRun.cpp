@@ -0,0 +1,86 @@
+#include "BinaryMergeableRun.h"
+
+
+// BinaryMergeableRun::BinaryMergeableRun()
+//
+// PURPOSE:
+//      Constructor. Maps the binary posterior file of the run and loads its first point.
+//
+// INPUT:
+//      fileName:   full path of the binary posterior file
+//
+// REMARK:
+//      A merged posterior file has no final live points, since the numbers of live points
+//      of all its points are stored in the file.
+//
+
+BinaryMergeableRun::BinaryMergeableRun(const string fileName)
+: MergeableRun(fileName),
+  posteriorFile(fileName),
+  Nread(0),
+  NreadNlivePoints(0)
+{
+    Ndimensions = posteriorFile.getNdimensions();
+    Nsamples = posteriorFile.getNsamples();
+    NlivePoints = posteriorFile.getHeader().initialNlivePoints;
+    NfinalLivePoints = posteriorFile.getNfinalLivePoints();
+
+    start();
+}
+
+
+
+
+
+
+
+
+
+
+// BinaryMergeableRun::readNextSample()
+//
+// PURPOSE:
+//      Reads the next point of the file, in the order in which it is stored.
+//
+// INPUT:
+//      logLikelihood:  set to the log(Likelihood) value of the point
+//      parameters:     pointer to Ndimensions values, set to the parameter values of the point
+//
+// OUTPUT:
+//      void
+//
+
+void BinaryMergeableRun::readNextSample(double &logLikelihood, double *parameters)
+{
+    Map<const ArrayXXd> posteriorSample = posteriorFile.getPosteriorSample();
+    
+    logLikelihood = posteriorFile.getLogLikelihood()(Nread);
+    copy(posteriorSample.col(Nread).data(), posteriorSample.col(Nread).data() + Ndimensions, parameters);
+    Nread++;
+}
+
+
+
+
+
+
+
+
+
+
+// BinaryMergeableRun::readNextNlivePoints()
+//
+// PURPOSE:
+//      Reads the next value of the block of the numbers of live points of the file.
+//
+// OUTPUT:
+//      The number of live points of the next dead point of the file.
+//
+
+int BinaryMergeableRun::readNextNlivePoints()
+{
+    int NlivePointsOfDeadPoint = posteriorFile.getNlivePointsPerIteration()(NreadNlivePoints);
+    NreadNlivePoints++;
+
+    return NlivePointsOfDeadPoint;
+}
@@ -0,0 +1,283 @@
+#include "BinaryPosteriorFile.h"
+
+
+const char BinaryPosteriorFile::magicNumber[8] = {'D', 'I', 'A', 'M', 'O', 'N', 'D', 'S'};
+const uint32_t BinaryPosteriorFile::version;
+const uint32_t BinaryPosteriorFile::byteOrderMark;
+
+
+// BinaryPosteriorFile::BinaryPosteriorFile()
+//
+// PURPOSE:
+//      Constructor. Maps the input binary posterior file in memory and checks
+//      that its header is consistent with its size. The program is stopped if
+//      the file is not a valid binary posterior file.
+//
+// INPUT:
+//      fileName:   full path of the binary posterior file to read
+//
+
+BinaryPosteriorFile::BinaryPosteriorFile(const string fileName)
+: mappedFile(fileName)
+{
+    if (mappedFile.getSize() < sizeof(BinaryPosteriorHeader))
+    {
+        cerr << "Error: " << fileName << " is too short to be a binary posterior file" << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    memcpy(&header, mappedFile.getData(), sizeof(BinaryPosteriorHeader));
+
+    if (memcmp(header.magicNumber, magicNumber, sizeof(magicNumber)) != 0)
+    {
+        cerr << "Error: " << fileName << " is not a binary posterior file" << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    if (header.byteOrderMark != byteOrderMark)
+    {
+        cerr << "Error: " << fileName << " was written on a machine with a different byte order" << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    if (header.version != version)
+    {
+        cerr << "Error: " << fileName << " has version " << header.version
+             << " of the binary posterior format, while version " << version << " is supported" << endl;
+        exit(EXIT_FAILURE);
+    }
+
+
+    if (header.NfinalLivePoints > header.Nsamples)
+    {
+        cerr << "Error: " << fileName << " has more final live points than points" << endl;
+        exit(EXIT_FAILURE);
+    }
+
+
+    // The sizes are returned as int, which also keeps the products below from overflowing
+
+    if ((header.Ndimensions > static_cast<uint64_t>(numeric_limits<int>::max())) 
+        || (header.Nsamples > static_cast<uint64_t>(numeric_limits<int>::max())))
+    {
+        cerr << "Error: " << fileName << " has an invalid header, with " << header.Ndimensions
+             << " dimensions and " << header.Nsamples << " points" << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    if ((header.dataOffset < sizeof(BinaryPosteriorHeader)) || (header.dataOffset % sizeof(double) != 0)
+        || (header.dataOffset > mappedFile.getSize()))
+    {
+        cerr << "Error: " << fileName << " has an invalid position of the data blocks" << endl;
+        exit(EXIT_FAILURE);
+    }
+
+
+    // The file must contain the blocks of the parameters, of the log(Likelihood) and of the log(Weight) values,
+    // and the block of the numbers of live points of the dead points. The sizes are compared in number of values
+    // rather than of bytes, so that a corrupt header cannot overflow them.
+
+    uint64_t NdeadPoints = header.Nsamples - header.NfinalLivePoints;
+    uint64_t NexpectedValues = (header.Ndimensions + 2) * header.Nsamples + NdeadPoints;
+    uint64_t NavailableValues = (mappedFile.getSize() - header.dataOffset) / sizeof(double);
+
+    if (NavailableValues < NexpectedValues)
+    {
+        cerr << "Error: " << fileName << " is truncated. Expected " << NexpectedValues
+             << " values after the header, found " << NavailableValues << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    posteriorSample = reinterpret_cast<const double*>(mappedFile.getData() + header.dataOffset);
+    logLikelihood = posteriorSample + header.Ndimensions * header.Nsamples;
+    logWeight = logLikelihood + header.Nsamples;
+    NlivePointsPerIteration = logWeight + header.Nsamples;
+}
+
+
+
+
+
+
+
+
+
+
+// BinaryPosteriorFile::getHeader()
+//
+// PURPOSE:
+//      Gets the header of the file, with the sizes of the sample and the summary of the run.
+//
+// OUTPUT:
+//      A constant reference to the header of the file.
+//
+
+const BinaryPosteriorHeader &BinaryPosteriorFile::getHeader()
+{
+    return header;
+}
+
+
+
+
+
+
+
+
+
+
+// BinaryPosteriorFile::getNdimensions()
+//
+// PURPOSE:
+//      Gets the number of free parameters of the posterior sample.
+//
+// OUTPUT:
+//      An integer containing the number of dimensions.
+//
+
+int BinaryPosteriorFile::getNdimensions()
+{
+    return header.Ndimensions;
+}
+
+
+
+
+
+
+
+
+
+
+// BinaryPosteriorFile::getNsamples()
+//
+// PURPOSE:
+//      Gets the number of points of the posterior sample.
+//
+// OUTPUT:
+//      An integer containing the number of sampling points.
+//
+
+int BinaryPosteriorFile::getNsamples()
+{
+    return header.Nsamples;
+}
+
+
+
+
+
+
+
+
+
+
+// BinaryPosteriorFile::getNfinalLivePoints()
+//
+// PURPOSE:
+//      Gets the number of live points left at the end of the nesting process,
+//      which are appended at the end of the posterior sample.
+//
+// OUTPUT:
+//      An integer containing the number of final live points.
+//
+
+int BinaryPosteriorFile::getNfinalLivePoints()
+{
+    return header.NfinalLivePoints;
+}
+
+
+
+
+
+
+
+
+
+
+// BinaryPosteriorFile::getPosteriorSample()
+//
+// PURPOSE:
+//      Gets the parameter values of the posterior sample, directly from the mapped file.
+//
+// OUTPUT:
+//      A read-only Eigen Map of Ndimensions rows and Nsamples columns, one column per
+//      sampling point. It is valid as long as this object exists.
+//
+
+Map<const ArrayXXd> BinaryPosteriorFile::getPosteriorSample()
+{
+    return Map<const ArrayXXd>(posteriorSample, header.Ndimensions, header.Nsamples);
+}
+
+
+
+
+
+
+
+
+
+
+// BinaryPosteriorFile::getLogLikelihood()
+//
+// PURPOSE:
+//      Gets the log(Likelihood) values of the posterior sample, directly from the mapped file.
+//
+// OUTPUT:
+//      A read-only Eigen Map of Nsamples elements. It is valid as long as this object exists.
+//
+
+Map<const ArrayXd> BinaryPosteriorFile::getLogLikelihood()
+{
+    return Map<const ArrayXd>(logLikelihood, header.Nsamples);
+}
+
+
+
+
+
+
+
+
+
+
+// BinaryPosteriorFile::getLogWeight()
+//
+// PURPOSE:
+//      Gets the log(Weight) values of the posterior sample, directly from the mapped file.
+//
+// OUTPUT:
+//      A read-only Eigen Map of Nsamples elements. It is valid as long as this object exists.
+//
+
+Map<const ArrayXd> BinaryPosteriorFile::getLogWeight()
+{
+    return Map<const ArrayXd>(logWeight, header.Nsamples);
+}
+
+
+
+
+
+
+
+
+
+
+// BinaryPosteriorFile::getNlivePointsPerIteration()
+//
+// PURPOSE:
+//      Gets the number of live points at the iteration of each dead point of the posterior sample, 
+//      directly from the mapped file.
+//
+// OUTPUT:
+//      A read-only Eigen Map of Nsamples - NfinalLivePoints elements. It is valid as long as
+//      this object exists.
+//
+
+Map<const ArrayXd> BinaryPosteriorFile::getNlivePointsPerIteration()
+{
+    return Map<const ArrayXd>(NlivePointsPerIteration, header.Nsamples - header.NfinalLivePoints);
+}
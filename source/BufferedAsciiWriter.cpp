@@ -0,0 +1,228 @@
+#include "BufferedAsciiWriter.h"
+
+
+// BufferedAsciiWriter::BufferedAsciiWriter()
+//
+// PURPOSE:
+//      Constructor. Reads the formatting state of the output stream, e.g. as set by
+//      scientific and setprecision(), so that the numbers are written exactly as the
+//      stream itself would write them.
+//
+// INPUT:
+//      outputStream:   the output stream to write to, assumed to be already opened and checked for sanity
+//      bufferSize:     the number of characters to collect before writing them to the stream
+//
+
+BufferedAsciiWriter::BufferedAsciiWriter(ostream &outputStream, const size_t bufferSize)
+: outputStream(outputStream),
+  buffer(bufferSize),
+  Ncharacters(0)
+{
+    setFormatFromStream();
+}
+
+
+
+
+
+
+
+
+
+
+// BufferedAsciiWriter::~BufferedAsciiWriter()
+//
+// PURPOSE:
+//      Destructor. Writes the characters left in the buffer to the stream.
+//
+
+BufferedAsciiWriter::~BufferedAsciiWriter()
+{
+    flush();
+}
+
+
+
+
+
+
+
+
+
+
+// BufferedAsciiWriter::write()
+//
+// PURPOSE:
+//      Appends a number to the buffer, formatted according to the state of the stream.
+//
+// INPUT:
+//      value:  the number to write
+//
+// OUTPUT:
+//      void
+//
+// REMARK:
+//      If the state of the stream cannot be reproduced (e.g. a field width or a locale
+//      different from the classic one is set), the number is written through the stream itself.
+//
+
+void BufferedAsciiWriter::write(const double value)
+{
+    if (!formatIsSupported)
+    {
+        flush();
+        outputStream << value;
+        return;
+    }
+
+    size_t NavailableCharacters = buffer.size() - Ncharacters;
+    int Nformatted = snprintf(&buffer[Ncharacters], NavailableCharacters, format, precision, value);
+
+    if (static_cast<size_t>(Nformatted) >= NavailableCharacters)
+    {
+        // The number did not fit in the remaining part of the buffer. Empty the buffer,
+        // enlarge it if even an empty buffer is too small, and format the number again.
+
+        flush();
+
+        if (static_cast<size_t>(Nformatted) >= buffer.size())
+        {
+            buffer.resize(Nformatted + 1);
+        }
+
+        Nformatted = snprintf(&buffer[0], buffer.size(), format, precision, value);
+    }
+
+    Ncharacters += Nformatted;
+}
+
+
+
+
+
+
+
+
+
+
+// BufferedAsciiWriter::write()
+//
+// PURPOSE:
+//      Appends a string, e.g. a separator or a line terminator, to the buffer.
+//
+// INPUT:
+//      text:   the string to write
+//
+// OUTPUT:
+//      void
+//
+
+void BufferedAsciiWriter::write(const string &text)
+{
+    if (Ncharacters + text.size() > buffer.size())
+    {
+        flush();
+
+        if (text.size() > buffer.size())
+        {
+            outputStream.write(text.data(), text.size());
+            return;
+        }
+    }
+
+    memcpy(&buffer[Ncharacters], text.data(), text.size());
+    Ncharacters += text.size();
+}
+
+
+
+
+
+
+
+
+
+
+// BufferedAsciiWriter::flush()
+//
+// PURPOSE:
+//      Writes all the characters of the buffer to the stream in a single call, and empties the buffer.
+//
+// OUTPUT:
+//      void
+//
+
+void BufferedAsciiWriter::flush()
+{
+    if (Ncharacters > 0)
+    {
+        outputStream.write(&buffer[0], Ncharacters);
+        Ncharacters = 0;
+    }
+}
+
+
+
+
+
+
+
+
+
+
+// BufferedAsciiWriter::setFormatFromStream()
+//
+// PURPOSE:
+//      Builds the snprintf format that gives the same output as operator<< of the stream,
+//      i.e. the format used by the standard library itself for its current flags:
+//      %e for scientific, %f for fixed and %g otherwise, with the precision of the stream,
+//      and with the modifiers given by the flags showpos, showpoint and uppercase 
+//      (the latter only for %e and %g, as in the standard library).
+//
+// OUTPUT:
+//      void
+//
+
+void BufferedAsciiWriter::setFormatFromStream()
+{
+    ios_base::fmtflags flags = outputStream.flags();
+    ios_base::fmtflags floatField = flags & ios_base::floatfield;
+    precision = outputStream.precision();
+
+
+    // A negative precision means the default one
+
+    if (precision < 0)
+        precision = 6;
+
+
+    // A field width applies to the next number only, hexadecimal floats are not produced
+    // by snprintf in the same way on all systems, and other locales can use a different decimal point.
+    // In these cases leave the formatting to the stream.
+
+    formatIsSupported = (outputStream.width() == 0) && (floatField != (ios_base::fixed | ios_base::scientific))
+                        && (outputStream.getloc() == locale::classic());
+
+    int position = 0;
+    format[position++] = '%';
+
+    if (flags & ios_base::showpos)
+        format[position++] = '+';
+
+    if (flags & ios_base::showpoint)
+        format[position++] = '#';
+
+    format[position++] = '.';
+    format[position++] = '*';
+
+    bool uppercase = (flags & ios_base::uppercase);
+
+    if (floatField == ios_base::scientific)
+        format[position++] = uppercase ? 'E' : 'e';
+    else if (floatField == ios_base::fixed)
+        format[position++] = 'f';
+    else
+        format[position++] = uppercase ? 'G' : 'g';
+
+    format[position] = '\0';
+}
@@ -29,6 +29,40 @@ Clusterer::Clusterer(Metric &metric, Projector &featureProjector, bool featurePr
 
 
 
+// Clusterer::clusterWithWarmStart()
+//
+// PURPOSE:
+//      Recluster a sample starting from the partition found at a previous call. 
+//      Derived classes that can refine an existing partition override this function.
+//      By default no warm start is available and a full clustering is performed.
+//
+// INPUT:
+//      sample(Ndimensions, Npoints): sample of N-dimensional points
+//      clusterIndices(Npoints): on input, for each point the index of the cluster it belonged to in 
+//                               the previous partition. On output, the updated cluster indices.
+//      clusterSizes(Nclusters): on input, the sizes of the clusters of the previous partition.
+//                               On output, the updated cluster sizes.
+//
+// OUTPUT:
+//      The number of clusters found.
+//
+
+int Clusterer::clusterWithWarmStart(RefArrayXXd sample, vector<int> &clusterIndices, vector<int> &clusterSizes)
+{
+    clusterSizes.clear();
+
+    return cluster(sample, clusterIndices, clusterSizes);
+}
+
+
+
+
+
+
+
+
+
+
 // Clusterer::getReducedNdimensions()
 //
 // PURPOSE:
@@ -0,0 +1,336 @@
+#include "CoresetClusterer.h"
+
+
+// CoresetClusterer::CoresetClusterer()
+//
+// PURPOSE: 
+//      Constructor.
+//
+// INPUT: 
+//      metric: this class is used to compute the distance between two points
+//      featureProjector: this class is used to compute a dimensionality reduction of the input sample of points
+//      featureProjectionActivated: a boolean to activate or deactivate the dimensionality reduction through the featureProjector class.
+//                                  The projection is done once on the whole sample, hence the clusterer applied to the
+//                                  coreset should not activate it again.
+//      clusterer: the clustering algorithm (e.g. k-means or Gaussian mixture) used to cluster the coreset
+//      coresetSize: the number of points of the coreset. Samples with no more points than this are 
+//                   clustered directly.
+//      NrefinementIterations: the number of k-means iterations on the whole sample, after the points 
+//                             have been assigned to the clusters found in the coreset
+//
+
+CoresetClusterer::CoresetClusterer(Metric &metric, Projector &featureProjector, bool featureProjectionActivated,
+                                   Clusterer &clusterer, unsigned int coresetSize, unsigned int NrefinementIterations)
+: Clusterer(metric, featureProjector, featureProjectionActivated),
+  clusterer(clusterer),
+  coresetSize(coresetSize),
+  NrefinementIterations(NrefinementIterations)
+{
+    // Set the seed of the random generator using the clock
+
+    clock_t clockticks = clock();
+    engine.seed(clockticks);
+
+    assert(coresetSize > 0);
+}
+
+
+
+
+
+
+
+
+
+// CoresetClusterer::~CoresetClusterer()
+//
+// PURPOSE: 
+//      Destructor.
+//
+
+CoresetClusterer::~CoresetClusterer()
+{
+
+}
+
+
+
+
+
+
+
+
+
+// CoresetClusterer::chooseCoreset()
+//
+// PURPOSE: 
+//      Choose the points of the coreset uniformly at random, without replacement, with a partial
+//      Fisher-Yates shuffle of the point indices. The clusterers applied to the coreset do not 
+//      take weights, hence every point needs the same probability to be drawn, so that the density
+//      of the coreset follows the one of the sample and the clustering of the coreset is not biased,
+//      e.g. towards far away or outlying points.
+//
+// INPUT:
+//      sample(Ndimensions, Npoints): sample of N-dimensional points
+//      coresetIndices(coresetSize): on output, the indices of the points of the coreset, in ascending order
+// 
+// OUTPUT: 
+//      void
+//
+
+void CoresetClusterer::chooseCoreset(RefArrayXXd sample, vector<int> &coresetIndices)
+{
+    int Npoints = sample.cols();
+    vector<int> indices(Npoints);
+
+    for (int n = 0; n < Npoints; ++n)
+    {
+        indices[n] = n;
+    }
+
+    for (unsigned int m = 0; m < coresetSize; ++m)
+    {
+        uniform_int_distribution<int> uniform(m, Npoints - 1);
+        swap(indices[m], indices[uniform(engine)]);
+    }
+
+    coresetIndices.assign(indices.begin(), indices.begin() + coresetSize);
+    sort(coresetIndices.begin(), coresetIndices.end());
+}
+
+
+
+
+
+
+
+
+
+// CoresetClusterer::assignPointsToClusters()
+//
+// PURPOSE: 
+//      Assign all the points of the sample to the cluster of the closest center, computing 
+//      all the distances in a single batch, and optionally refine the partition with a few 
+//      k-means iterations. Clusters that end up with less than Ndimensions+1 points, the minimum 
+//      to build an ellipsoid, are removed, and their points are moved to the closest remaining cluster.
+//
+// INPUT:
+//      sample(Ndimensions, Npoints): sample of N-dimensional points
+//      centers(Ndimensions, Nclusters): the initial centers of the clusters. On output, the barycenters
+//                                       of the clusters of the last iteration.
+//      clusterIndices(Npoints): on output, for each point the index of the cluster it belongs to
+//      clusterSizes(Nclusters): on output, the number of points of each cluster
+// 
+// OUTPUT: 
+//      The number of (non-empty) clusters
+//
+
+int CoresetClusterer::assignPointsToClusters(RefArrayXXd sample, RefArrayXXd centers, vector<int> &clusterIndices, 
+                                             vector<int> &clusterSizes)
+{
+    int Npoints = sample.cols();
+    int Nclusters = centers.cols();
+    Index indexOfClosestCenter;
+    ArrayXXd reducedDistancesToCenters(Npoints, Nclusters);
+    ArrayXd updatedClusterSizes(Nclusters);
+
+    clusterIndices.resize(Npoints);
+
+    for (unsigned int iteration = 0; iteration <= NrefinementIterations; ++iteration)
+    {
+        if (iteration > 0)
+        {
+            // Move the centers to the barycenters of the clusters found in the previous iteration
+
+            ArrayXXd updatedCenters = ArrayXXd::Zero(centers.rows(), Nclusters);
+
+            for (int n = 0; n < Npoints; ++n)
+            {
+                updatedCenters.col(clusterIndices[n]) += sample.col(n);
+            }
+
+            for (int k = 0; k < Nclusters; ++k)
+            {
+                if (updatedClusterSizes(k) > 0) centers.col(k) = updatedCenters.col(k) / updatedClusterSizes(k);
+            }
+        }
+
+
+        // Only the ordering of the distances matters, hence use their reduced (cheaper) form 
+
+        metric.pairwiseDistances(sample, centers, reducedDistancesToCenters, true);
+        updatedClusterSizes.setZero();
+
+        for (int n = 0; n < Npoints; ++n)
+        {
+            reducedDistancesToCenters.row(n).minCoeff(&indexOfClosestCenter);
+            clusterIndices[n] = indexOfClosestCenter;
+            updatedClusterSizes(indexOfClosestCenter) += 1;
+        }
+    }
+
+
+    // Dissolve the clusters that are too small, moving their points to the closest of the other clusters.
+    // If no cluster is large enough, the whole sample is taken as a single cluster.
+
+    const int minNpointsPerCluster = sample.rows() + 1;
+    vector<bool> clusterIsKept(Nclusters);
+    bool someClusterIsKept = false;
+
+    for (int k = 0; k < Nclusters; ++k)
+    {
+        clusterIsKept[k] = (updatedClusterSizes(k) >= minNpointsPerCluster);
+        someClusterIsKept = someClusterIsKept || clusterIsKept[k];
+    }
+
+    if (!someClusterIsKept)
+    {
+        clusterIndices.assign(Npoints, 0);
+        clusterSizes.assign(1, Npoints);
+        return 1;
+    }
+
+    for (int n = 0; n < Npoints; ++n)
+    {
+        if (clusterIsKept[clusterIndices[n]]) continue;
+
+        int closestKeptCluster = -1;
+
+        for (int k = 0; k < Nclusters; ++k)
+        {
+            if (clusterIsKept[k] && ((closestKeptCluster < 0) || 
+                (reducedDistancesToCenters(n, k) < reducedDistancesToCenters(n, closestKeptCluster))))
+            {
+                closestKeptCluster = k;
+            }
+        }
+
+        updatedClusterSizes(clusterIndices[n]) -= 1;
+        updatedClusterSizes(closestKeptCluster) += 1;
+        clusterIndices[n] = closestKeptCluster;
+    }
+
+
+    // Remove the dissolved clusters and renumber the others from 0 to Nclusters-1
+
+    vector<int> newClusterIndices(Nclusters, -1);
+    clusterSizes.clear();
+
+    for (int k = 0; k < Nclusters; ++k)
+    {
+        if (updatedClusterSizes(k) > 0)
+        {
+            newClusterIndices[k] = clusterSizes.size();
+            clusterSizes.push_back(updatedClusterSizes(k));
+        }
+    }
+
+    for (int n = 0; n < Npoints; ++n)
+    {
+        clusterIndices[n] = newClusterIndices[clusterIndices[n]];
+    }
+
+    return clusterSizes.size();
+}
+
+
+
+
+
+
+
+
+
+// CoresetClusterer::cluster()
+//
+// PURPOSE: 
+//      Given a large sample of N-dimensional points, cluster a small coreset of it with the 
+//      chosen clustering algorithm, and assign all the points to the clusters found. The cost of
+//      the (many) iterations and trials of the clustering algorithm only depends on the size of
+//      the coreset, and the whole sample is only involved in the final assignment, which takes
+//      1 + NrefinementIterations passes over the points. As the points are assigned to the closest
+//      barycenter of the clusters of the coreset, this is best suited for compact clusters, such
+//      as those of k-means and of Gaussian mixtures.
+//
+// INPUT:
+//      sample(Ndimensions, Npoints): sample of N-dimensional points
+//      optimalClusterIndices(Npoints): for each point the index of the cluster it belongs to. This index
+//                                      runs from 0 to Nclusters-1.
+//      optimalClusterSizes(Nclusters): for each of the clusters, this vector contains the number of points
+// 
+// OUTPUT:
+//      The number of clusters found
+//
+
+int CoresetClusterer::cluster(RefArrayXXd sample, vector<int> &optimalClusterIndices, vector<int> &optimalClusterSizes)
+{
+    ArrayXXd optimizedSample;
+
+    // If activated, apply a dimensionality reduction of the data sample according to the chosen feature projector (e.g. PCA)
+
+    if (featureProjectionActivated)
+    {
+        optimizedSample = featureProjector.projection(sample);
+    }
+    else
+    {
+        optimizedSample = sample;
+    }
+
+    int Npoints = optimizedSample.cols();
+    int Ndimensions = optimizedSample.rows();
+
+
+    // Small samples do not need a coreset
+
+    if (Npoints <= static_cast<int>(coresetSize))
+    {
+        optimalClusterSizes.clear();
+        return clusterer.cluster(optimizedSample, optimalClusterIndices, optimalClusterSizes);
+    }
+
+
+    // Cluster the coreset
+
+    vector<int> coresetIndices;
+    chooseCoreset(optimizedSample, coresetIndices);
+
+    ArrayXXd coreset(Ndimensions, coresetSize);
+
+    for (unsigned int m = 0; m < coresetSize; ++m)
+    {
+        coreset.col(m) = optimizedSample.col(coresetIndices[m]);
+    }
+
+    vector<int> coresetClusterIndices(coresetSize);
+    vector<int> coresetClusterSizes;
+    int Nclusters = clusterer.cluster(coreset, coresetClusterIndices, coresetClusterSizes);
+
+
+    // Some clusterers do not fill the cluster sizes when they fall back to a single cluster 
+    // (e.g. the Gaussian mixture clusterer), in which case the coreset is taken as one cluster.
+
+    if ((Nclusters < 1) || (coresetClusterSizes.size() != static_cast<size_t>(Nclusters)))
+    {
+        Nclusters = 1;
+        coresetClusterIndices.assign(coresetSize, 0);
+        coresetClusterSizes.assign(1, coresetSize);
+    }
+
+
+    // Compute the barycenters of the clusters of the coreset, and assign all the points to them
+
+    ArrayXXd centers = ArrayXXd::Zero(Ndimensions, Nclusters);
+
+    for (unsigned int m = 0; m < coresetSize; ++m)
+    {
+        centers.col(coresetClusterIndices[m]) += coreset.col(m);
+    }
+
+    for (int k = 0; k < Nclusters; ++k)
+    {
+        centers.col(k) /= max(coresetClusterSizes[k], 1);
+    }
+
+    return assignPointsToClusters(optimizedSample, centers, optimalClusterIndices, optimalClusterSizes);
+}
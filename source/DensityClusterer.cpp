@@ -0,0 +1,371 @@
+#include "DensityClusterer.h"
+
+
+// DensityClusterer::DensityClusterer()
+//
+// PURPOSE: 
+//      Constructor.
+//
+// INPUT: 
+//      metric: this class is used to compute the distance between two points
+//      featureProjector: this class is used to compute a dimensionality reduction of the input sample of points
+//      featureProjectionActivated: a boolean to activate or deactivate the dimensionality reduction through the featureProjector class
+//      minNneighbours: the minimum number of points (including the point itself) within the neighbourhood 
+//                      of a point for the latter to be a core point of a cluster. If 0, it is set to 
+//                      max(2*Ndimensions, Ndimensions+1, 4), according to the dimensionality of the sample.
+//      neighbourhoodRadius: the radius (eps) of the neighbourhood of each point. If 0, it is chosen 
+//                           automatically at each clustering from the distribution of the distances 
+//                           of the points to their minNneighbours-th nearest neighbour.
+//
+
+DensityClusterer::DensityClusterer(Metric &metric, Projector &featureProjector, bool featureProjectionActivated,
+                                   unsigned int minNneighbours, double neighbourhoodRadius)
+: Clusterer(metric, featureProjector, featureProjectionActivated),
+  tree(metric),
+  neighbourhoodRadius(neighbourhoodRadius),
+  minNneighbours(minNneighbours),
+  userNeighbourhoodRadius(neighbourhoodRadius)
+{
+    assert(neighbourhoodRadius >= 0.0);
+}
+
+
+
+
+
+
+
+
+
+// DensityClusterer::~DensityClusterer()
+//
+// PURPOSE: 
+//      Destructor.
+//
+
+DensityClusterer::~DensityClusterer()
+{
+
+}
+
+
+
+
+
+
+
+
+
+// DensityClusterer::chooseNeighbourhoodRadius()
+//
+// PURPOSE: 
+//      Choose the radius of the neighbourhood from the k-distance statistics of the sample, i.e. 
+//      the distances of all the points to their k-th nearest neighbour. When sorted in increasing
+//      order, these distances show a "knee": points inside clusters have small, slowly increasing
+//      k-distances, while points in between clusters have large, rapidly increasing k-distances.
+//      The knee is located as the point of the sorted curve that is farthest from the straight 
+//      line joining its two end points (both axes normalized to unity).
+//
+// INPUT:
+//      sample(Ndimensions, Npoints): sample of N-dimensional points, already stored in the k-d tree
+//      Nneighbours: the number of neighbours k (including the point itself)
+// 
+// OUTPUT: 
+//      The radius of the neighbourhood
+//
+
+double DensityClusterer::chooseNeighbourhoodRadius(RefArrayXXd sample, const unsigned int Nneighbours)
+{
+    ArrayXd kDistances(Npoints);
+
+    #ifdef _OPENMP
+    #pragma omp parallel for schedule(dynamic, 64)
+    #endif
+    for (unsigned int n = 0; n < Npoints; ++n)
+    {
+        vector<int> neighbourIndices;
+        vector<double> neighbourDistances;
+        tree.nearestNeighbours(sample.col(n), Nneighbours, neighbourIndices, neighbourDistances);
+        kDistances(n) = neighbourDistances.back();
+    }
+
+    sort(kDistances.data(), kDistances.data() + Npoints);
+
+    double range = kDistances(Npoints-1) - kDistances(0);
+
+    if (range <= 0.0)
+    {
+        return kDistances(Npoints-1);
+    }
+
+
+    // Distance of each normalized point (x, y) of the curve to the diagonal y = x is proportional to x - y
+
+    ArrayXd normalizedRanks = ArrayXd::LinSpaced(Npoints, 0.0, 1.0);
+    ArrayXd normalizedKdistances = (kDistances - kDistances(0)) / range;
+    int kneeIndex;
+    (normalizedRanks - normalizedKdistances).maxCoeff(&kneeIndex);
+
+    return kDistances(kneeIndex);
+}
+
+
+
+
+
+
+
+
+
+// DensityClusterer::assignNoisePointsToClusters()
+//
+// PURPOSE: 
+//      Assign each point that does not belong to any cluster (noise) to the cluster 
+//      of its nearest neighbour that belongs to a cluster. Every live point has to be part
+//      of a cluster, since the ellipsoids built from the clusters must enclose all of them.
+//
+// INPUT:
+//      sample(Ndimensions, Npoints): sample of N-dimensional points, already stored in the k-d tree
+//      clusterIndices(Npoints): for each point the index of the cluster it belongs to, or -1 for
+//                               noise points. On output, all the indices are valid.
+// 
+// OUTPUT: 
+//      void
+//
+
+void DensityClusterer::assignNoisePointsToClusters(RefArrayXXd sample, vector<int> &clusterIndices)
+{
+    vector<int> originalClusterIndices = clusterIndices;
+    vector<int> neighbourIndices;
+    vector<double> neighbourDistances;
+
+    for (unsigned int n = 0; n < Npoints; ++n)
+    {
+        if (originalClusterIndices[n] >= 0) continue;
+
+
+        // Increase the number of neighbours until one of them belongs to a cluster
+
+        for (int Nneighbours = 8; clusterIndices[n] < 0; Nneighbours *= 2)
+        {
+            tree.nearestNeighbours(sample.col(n), min(Nneighbours, int(Npoints)), neighbourIndices, neighbourDistances);
+
+            for (size_t k = 0; k < neighbourIndices.size(); ++k)
+            {
+                if (originalClusterIndices[neighbourIndices[k]] >= 0)
+                {
+                    clusterIndices[n] = originalClusterIndices[neighbourIndices[k]];
+                    break;
+                }
+            }
+        }
+    }
+}
+
+
+
+
+
+
+
+
+
+// DensityClusterer::cluster()
+//
+// PURPOSE: 
+//      Given a sample of N-dimensional points, use the DBSCAN algorithm (Ester et al. 1996) to find
+//      the clusters as connected regions of high density, together with their number, in a single pass. 
+//      A core point has at least minNneighbours points within its neighbourhood. Clusters are grown 
+//      from core points by collecting their neighbours, and further expanded through the neighbours 
+//      that are core points themselves. All the neighbour queries are done with a k-d tree, 
+//      taking O(log Npoints) operations each in low to moderate dimensionality.
+//      Clusters with less than Ndimensions+1 points, for which no ellipsoid can be computed, are
+//      discarded. The points that are not part of a cluster are finally assigned to the cluster of
+//      their nearest clustered neighbour. If no cluster is found, the whole sample is one cluster.
+//
+// INPUT:
+//      sample(Ndimensions, Npoints): sample of N-dimensional points
+//      optimalClusterIndices(Npoints): for each point the index of the cluster it belongs to. This index
+//                                      runs from 0 to Nclusters-1.
+//      optimalClusterSizes(Nclusters): for each of the clusters, this vector contains the number of points
+// 
+// OUTPUT:
+//      The number of clusters found
+//
+
+int DensityClusterer::cluster(RefArrayXXd sample, vector<int> &optimalClusterIndices, vector<int> &optimalClusterSizes)
+{
+    Npoints = sample.cols();
+    ArrayXXd optimizedSample;
+
+    // If activated, apply a dimensionality reduction of the data sample according to the chosen feature projector (e.g. PCA)
+
+    if (featureProjectionActivated)
+    {
+        optimizedSample = featureProjector.projection(sample);
+    }
+    else
+    {
+        optimizedSample = sample;
+    }
+    
+    Ndimensions = optimizedSample.rows();
+    optimalClusterIndices.assign(Npoints, -1);
+    optimalClusterSizes.clear();
+
+    unsigned int minNpointsPerCluster = Ndimensions + 1;
+    unsigned int Nneighbours = minNneighbours;
+
+    if (Nneighbours == 0)
+    {
+        Nneighbours = max(max(2*Ndimensions, minNpointsPerCluster), 4u);
+    }
+
+    if (Npoints < max(Nneighbours, minNpointsPerCluster))
+    {
+        // The sample is too small to contain more than one cluster
+
+        optimalClusterIndices.assign(Npoints, 0);
+        optimalClusterSizes.push_back(Npoints);
+        return 1;
+    }
+
+
+    // Build the spatial index and choose the radius of the neighbourhoods
+
+    tree.build(optimizedSample);
+
+    if (userNeighbourhoodRadius > 0.0)
+    {
+        neighbourhoodRadius = userNeighbourhoodRadius;
+    }
+    else
+    {
+        neighbourhoodRadius = chooseNeighbourhoodRadius(optimizedSample, Nneighbours);
+    }
+
+
+    // Grow the clusters from the core points
+
+    const int unvisited = -2;
+    const int noise = -1;
+    vector<int> labels(Npoints, unvisited);
+    vector<int> neighbourIndices;
+    vector<int> seedIndices;
+    int Nclusters = 0;
+
+    for (unsigned int n = 0; n < Npoints; ++n)
+    {
+        if (labels[n] != unvisited) continue;
+
+        tree.radiusSearch(optimizedSample.col(n), neighbourhoodRadius, neighbourIndices);
+
+        if (neighbourIndices.size() < Nneighbours)
+        {
+            // Not a core point. It may still be reached later from a core point of a cluster.
+
+            labels[n] = noise;
+            continue;
+        }
+
+
+        // Start a new cluster and expand it through all the core points that can be reached
+
+        int clusterIndex = Nclusters++;
+        labels[n] = clusterIndex;
+        seedIndices = neighbourIndices;
+
+        for (size_t k = 0; k < seedIndices.size(); ++k)
+        {
+            int seedIndex = seedIndices[k];
+
+            if (labels[seedIndex] == noise)
+            {
+                // A border point of the cluster
+
+                labels[seedIndex] = clusterIndex;
+            }
+
+            if (labels[seedIndex] != unvisited) continue;
+
+            labels[seedIndex] = clusterIndex;
+            tree.radiusSearch(optimizedSample.col(seedIndex), neighbourhoodRadius, neighbourIndices);
+
+            if (neighbourIndices.size() >= Nneighbours)
+            {
+                seedIndices.insert(seedIndices.end(), neighbourIndices.begin(), neighbourIndices.end());
+            }
+        }
+    }
+
+
+    // Discard the clusters that are too small to compute an ellipsoid, and renumber the others 
+
+    vector<unsigned int> clusterSizes(Nclusters, 0);
+
+    for (unsigned int n = 0; n < Npoints; ++n)
+    {
+        if (labels[n] >= 0) clusterSizes[labels[n]]++;
+    }
+
+    vector<int> newClusterIndices(Nclusters, noise);
+    int NvalidClusters = 0;
+
+    for (int i = 0; i < Nclusters; ++i)
+    {
+        if (clusterSizes[i] >= minNpointsPerCluster)
+        {
+            newClusterIndices[i] = NvalidClusters++;
+        }
+    }
+
+    if (NvalidClusters == 0)
+    {
+        // No dense region was found, hence the whole sample is a single cluster
+
+        optimalClusterIndices.assign(Npoints, 0);
+        optimalClusterSizes.push_back(Npoints);
+        return 1;
+    }
+
+    for (unsigned int n = 0; n < Npoints; ++n)
+    {
+        optimalClusterIndices[n] = (labels[n] >= 0 ? newClusterIndices[labels[n]] : noise);
+    }
+
+
+    // Every point has to belong to a cluster
+
+    assignNoisePointsToClusters(optimizedSample, optimalClusterIndices);
+
+    optimalClusterSizes.assign(NvalidClusters, 0);
+
+    for (unsigned int n = 0; n < Npoints; ++n)
+    {
+        optimalClusterSizes[optimalClusterIndices[n]]++;
+    }
+
+    return NvalidClusters;
+}
+
+
+
+
+
+
+
+
+
+// DensityClusterer::getNeighbourhoodRadius()
+//
+// PURPOSE: 
+//      Get the radius of the neighbourhoods used in the last clustering.
+//
+// OUTPUT:
+//      A double containing the radius of the neighbourhoods
+//
+
+double DensityClusterer::getNeighbourhoodRadius()
+{
+    return neighbourhoodRadius;
+}
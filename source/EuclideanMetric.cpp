@@ -5,4 +5,106 @@
 double EuclideanMetric::distance(RefArrayXd point1, RefArrayXd point2)
 {
     return sqrt((point1-point2).square().sum());
-}
\ No newline at end of file
+}
+
+
+
+
+
+
+
+
+
+// EuclideanMetric::pointToCentersDistances()
+//
+// PURPOSE:
+//      Compute the Euclidean distances between one point and a set of centers. 
+//      The reduced distance is the squared distance, which avoids taking the square roots.
+//
+// INPUT:
+//      point(Ndimensions): coordinates of the point
+//      centers(Ndimensions, Ncenters): coordinates of the centers
+//      distances(Ncenters): on output, the (reduced) distance between the point and each center
+//      reduced: if true, return the squared distances
+//
+// OUTPUT:
+//      void
+//
+
+void EuclideanMetric::pointToCentersDistances(RefArrayXd point, RefArrayXXd centers, RefArrayXd distances, bool reduced)
+{
+    distances = (centers.colwise() - point).square().colwise().sum().transpose();
+
+    if (!reduced)
+    {
+        distances = distances.sqrt();
+    }
+}
+
+
+
+
+
+
+
+
+
+// EuclideanMetric::pairwiseDistances()
+//
+// PURPOSE:
+//      Compute the matrix of Euclidean distances between two samples of points. 
+//      The squared distances are obtained as ||x||^2 + ||y||^2 - 2 x.y, so that the bulk of 
+//      the computation is a single matrix product. Small negative values due to round-off
+//      errors are set to zero.
+//
+// INPUT:
+//      sample1(Ndimensions, Npoints1): coordinates of the first sample of points
+//      sample2(Ndimensions, Npoints2): coordinates of the second sample of points
+//      distances(Npoints1, Npoints2): on output, the (reduced) distance between each point of sample1 (rows)
+//                                     and each point of sample2 (columns)
+//      reduced: if true, return the squared distances
+//
+// OUTPUT:
+//      void
+//
+
+void EuclideanMetric::pairwiseDistances(RefArrayXXd sample1, RefArrayXXd sample2, RefArrayXXd distances, bool reduced)
+{
+    Eigen::ArrayXd squaredNorms1 = sample1.square().colwise().sum().transpose();
+    Eigen::ArrayXd squaredNorms2 = sample2.square().colwise().sum().transpose();
+
+    distances.matrix().noalias() = -2.0 * sample1.matrix().transpose() * sample2.matrix();
+    distances.colwise() += squaredNorms1;
+    distances.rowwise() += squaredNorms2.transpose();
+    distances = distances.max(0.0);
+
+    if (!reduced)
+    {
+        distances = distances.sqrt();
+    }
+}
+
+
+
+
+
+
+
+
+
+// EuclideanMetric::reducedDistanceToDistance()
+//
+// PURPOSE:
+//      Convert a squared Euclidean distance into the distance.
+//
+// INPUT:
+//      reducedDistance: the squared distance
+//
+// OUTPUT:
+//      The corresponding distance
+//
+
+double EuclideanMetric::reducedDistanceToDistance(double reducedDistance)
+{
+    return sqrt(reducedDistance);
+}
@@ -0,0 +1,168 @@
+#include "EvaluationWorkspace.h"
+
+
+// EvaluationWorkspace::EvaluationWorkspace()
+//
+// PURPOSE:
+//      Constructor. The arrays are empty until their first use.
+//
+
+EvaluationWorkspace::EvaluationWorkspace()
+{
+
+}
+
+
+
+
+
+
+
+
+
+// EvaluationWorkspace::~EvaluationWorkspace()
+//
+// PURPOSE:
+//      Destructor.
+//
+
+EvaluationWorkspace::~EvaluationWorkspace()
+{
+
+}
+
+
+
+
+
+
+
+
+
+// EvaluationWorkspace::getPredictions()
+//
+// PURPOSE:
+//      Gets the array meant to contain the predictions of the model.
+//
+// INPUT:
+//      Npoints:    the required number of elements
+//
+// OUTPUT:
+//      A reference to an array of Npoints elements, with undefined values.
+//
+
+ArrayXd &EvaluationWorkspace::getPredictions(const int Npoints)
+{
+    return prepareArray(predictions, Npoints);
+}
+
+
+
+
+
+
+
+
+
+// EvaluationWorkspace::getLikelihoodArray()
+//
+// PURPOSE:
+//      Gets the scratch array reserved to the likelihood, e.g. for the variances of
+//      a likelihood whose uncertainties depend on the free parameters.
+//
+// INPUT:
+//      Npoints:    the required number of elements
+//
+// OUTPUT:
+//      A reference to an array of Npoints elements, with undefined values.
+//
+
+ArrayXd &EvaluationWorkspace::getLikelihoodArray(const int Npoints)
+{
+    return prepareArray(likelihoodArray, Npoints);
+}
+
+
+
+
+
+
+
+
+
+// EvaluationWorkspace::getModelArray()
+//
+// PURPOSE:
+//      Gets one of the scratch arrays reserved to the model. These are distinct from the
+//      arrays used by the likelihood, so that a model can use them while the likelihood
+//      waits for its predictions.
+//
+// INPUT:
+//      index:      the number of the array, from 0 to NmodelArrays - 1
+//      Npoints:    the required number of elements
+//
+// OUTPUT:
+//      A reference to an array of Npoints elements, with undefined values.
+//
+
+ArrayXd &EvaluationWorkspace::getModelArray(const int index, const int Npoints)
+{
+    assert((index >= 0) && (index < NmodelArrays));
+
+    return prepareArray(modelArrays[index], Npoints);
+}
+
+
+
+
+
+
+
+
+
+// EvaluationWorkspace::getThreadWorkspace()
+//
+// PURPOSE:
+//      Gets a workspace private to the calling thread. It is used by the evaluations
+//      that are not given a workspace explicitly, so that they do not allocate memory either,
+//      except at their first call in each thread.
+//
+// OUTPUT:
+//      A reference to the workspace of the calling thread.
+//
+
+EvaluationWorkspace &EvaluationWorkspace::getThreadWorkspace()
+{
+    static thread_local EvaluationWorkspace threadWorkspace;
+
+    return threadWorkspace;
+}
+
+
+
+
+
+
+
+
+
+// EvaluationWorkspace::prepareArray()
+//
+// PURPOSE:
+//      Resizes an array, only if its size differs from the required one.
+//
+// INPUT:
+//      array:      the array to prepare
+//      Npoints:    the required number of elements
+//
+// OUTPUT:
+//      A reference to the input array.
+//
+
+ArrayXd &EvaluationWorkspace::prepareArray(ArrayXd &array, const int Npoints)
+{
+    if (array.size() != Npoints)
+        array.resize(Npoints);
+
+    return array;
+}
@@ -56,10 +56,57 @@ ExponentialLikelihood::~ExponentialLikelihood()
 
 double ExponentialLikelihood::logValue(RefArrayXd const modelParameters)
 {
-    ArrayXd predictions(observations.size());
+    return logValue(modelParameters, EvaluationWorkspace::getThreadWorkspace());
+}
+
+
+
+
+
+
+
+
+
+// ExponentialLikelihood::logValue()
+//
+// PURPOSE:
+//      Same as above, using the arrays of a workspace, so that no memory is allocated.
+//      The terms of the likelihood are summed by blocks of blockSize points, and the sums of
+//      the blocks are then added pairwise, which keeps the rounding error small for large data sets.
+//      For an evaluation of very large data sets by several threads, use instead 
+//      FusedLikelihood<ExponentialNoise, ModelType>, which predicts and sums the same blocks, 
+//      with a model that can be predicted block by block, e.g. WindowedModeProfileModel.
+//
+// INPUT:
+//      modelParameters: a one-dimensional array containing the actual
+//      values of the free parameters that describe the model.
+//      workspace: the workspace of the calling thread.
+//
+// OUTPUT:
+//      a double number containing the natural logarithm of the
+//      exponential likelihood
+//
+
+double ExponentialLikelihood::logValue(RefArrayXd const modelParameters, EvaluationWorkspace &workspace)
+{
+    const int Npoints = observations.size();
+    const int Nblocks = (Npoints + blockSize - 1) / blockSize;
+
+    ArrayXd &predictions = workspace.getPredictions(Npoints);
     predictions.setZero();
-    model.predict(predictions, modelParameters);
+    model.predict(predictions, modelParameters, workspace);
+
+    ArrayXd &blockLogLikelihoods = workspace.getLikelihoodArray(Nblocks);
+
+    for (int block = 0; block < Nblocks; ++block)
+    {
+        int begin = block * blockSize;
+        int size = (Npoints - begin < blockSize) ? (Npoints - begin) : blockSize;
+
+        blockLogLikelihoods(block) = -1.0*(predictions.segment(begin, size).log() 
+                                           + observations.segment(begin, size)/predictions.segment(begin, size)).sum();
+    }
 
-    return -1.0*(predictions.log() + observations/predictions).sum();
+    return Functions::pairwiseSum(blockLogLikelihoods);
 }
 
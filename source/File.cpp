@@ -184,6 +184,301 @@ ArrayXXd File::arrayXXdFromFile(ifstream &inputFile, const unsigned long Nrows,
 
 
 
+// AsciiChunk
+//
+// PURPOSE:
+//      Result of the parsing of a contiguous block of lines of a memory-mapped
+//      ascii file, used by File::arrayXXdFromFile(string, ...).
+//
+
+struct AsciiChunk
+{
+    const char *begin;              // First character of the block, always at the beginning of a line
+    const char *end;                // One past the last character of the block
+    vector<double> values;          // The numbers of the block, row after row
+    unsigned long Nrows;            // Number of rows with values in the block
+    int Ncols;                      // Number of columns of the first row of the block, -1 if the block has no rows
+    bool hasError;                  // True if the parsing stopped at a malformed row, which is then row Nrows of the block
+    string errorMessage;            // The description of the error, following the row number
+};
+
+
+
+
+
+
+
+
+
+
+// parseAsciiChunk()
+//
+// PURPOSE: 
+//      Parses a block of lines of a memory-mapped ascii file, with the same rules
+//      as File::arrayXXdFromFile(ifstream &, ...): lines starting with the comment
+//      character, and lines with only whitespace, are skipped, and all the other lines
+//      must contain the same number of numbers, delimited by one or more separators.
+//
+// INPUT:
+//      chunk: block to parse, with begin and end set. The other fields are filled in.
+//      separator: numbers are normally separated by ' '. Use ',' for CSV files.
+//      commentChar: all lines starting with this character (e.g. '#') are skipped
+// 
+// OUTPUT:
+//      void
+//
+//  REMARKS:
+//      - the parsing stops at the first malformed row, which is flagged in the chunk
+//
+
+static void parseAsciiChunk(AsciiChunk &chunk, char separator, char commentChar)
+{
+    string token;
+    vector<double> rowValues;
+    const char *lineBegin = chunk.begin;
+
+    chunk.Nrows = 0;
+    chunk.Ncols = -1;
+    chunk.hasError = false;
+    chunk.values.reserve((chunk.end - chunk.begin) / 8);
+
+    while (lineBegin < chunk.end)
+    {
+        const char *lineEnd = static_cast<const char*>(memchr(lineBegin, '\n', chunk.end - lineBegin));
+        
+        if (lineEnd == NULL)
+            lineEnd = chunk.end;
+
+        const char *nextLine = lineEnd + 1;
+
+
+        // Skip those lines that start with the comment character
+        
+        if (lineBegin < lineEnd && *lineBegin == commentChar)
+        {
+            lineBegin = nextLine;
+            continue;
+        }
+
+
+        // Skip those lines with only whitespace
+        
+        const char *position = lineBegin;
+        
+        while (position < lineEnd && (*position == ' ' || *position == '\t'))
+            position++;
+
+        if (position == lineEnd)
+        {
+            lineBegin = nextLine;
+            continue;
+        }
+
+
+        // Convert the tokens delimited by separator in place, keeping only the first
+        // one that cannot be converted, since the number of tokens is checked first.
+
+        rowValues.clear();
+        bool conversionFailed = false;
+        string wrongToken;
+        position = lineBegin;
+
+        while (true)
+        {
+            while (position < lineEnd && *position == separator)
+                position++;
+
+            if (position == lineEnd)
+                break;
+
+            const char *tokenBegin = position;
+
+            while (position < lineEnd && *position != separator)
+                position++;
+
+
+            // The token is copied into a (reused) string, so that the conversion cannot
+            // read beyond its end, and in particular beyond the end of the mapped file.
+
+            token.assign(tokenBegin, position);
+            char *conversionEnd;
+            double value = strtod(token.c_str(), &conversionEnd);
+
+            if (conversionEnd == token.c_str() && !conversionFailed)
+            {
+                conversionFailed = true;
+                wrongToken = token;
+            }
+
+            rowValues.push_back(value);
+        }
+
+
+        // The first row of the block sets the number of columns
+
+        if (chunk.Ncols < 0)
+            chunk.Ncols = rowValues.size();
+
+
+        // Check if the number of numbers on the line matches the expected
+        // number of columns
+        
+        if (rowValues.size() != static_cast<size_t>(chunk.Ncols))
+        {
+            ostringstream message;
+            message << ": number of tokens != " << chunk.Ncols;
+            chunk.errorMessage = message.str();
+            chunk.hasError = true;
+            return;
+        }
+
+        if (conversionFailed)
+        {
+            chunk.errorMessage = ". Can't convert " + wrongToken + " to a number";
+            chunk.hasError = true;
+            return;
+        }
+
+        chunk.values.insert(chunk.values.end(), rowValues.begin(), rowValues.end());
+        chunk.Nrows++;
+        lineBegin = nextLine;
+    }
+}
+
+
+
+
+
+
+
+
+
+
+// File::arrayXXdFromFile()
+//
+// PURPOSE: 
+//      Reads an ascii file into an Eigen ArrayXXd in a single pass, without knowing 
+//      its number of rows and columns in advance. It replaces the pair of calls to 
+//      File::sniffFile() and File::arrayXXdFromFile(ifstream &, ...), which read 
+//      the file twice.
+//
+// INPUT:
+//      inputFileName: full path of the input file
+//      separator: numbers are normally separated by ' '. Use ',' for CSV files.
+//      commentChar: all lines starting with this character (e.g. '#') are skipped
+// 
+// OUTPUT:
+//      An Eigen::ArrayXXd, with as many rows as non-comment and non-empty lines in the file, 
+//      and as many columns as numbers in the first of these lines.
+//
+//  REMARKS:
+//      - the file is memory-mapped and split into blocks of whole lines, which are parsed
+//        in parallel when OpenMP is enabled. The result does not depend on the number of threads.
+//      - the same rules and error messages as in File::arrayXXdFromFile(ifstream &, ...) apply.
+//        The numbers are converted with strtod(), hence also inf and nan are accepted.
+//
+
+ArrayXXd File::arrayXXdFromFile(const string inputFileName, char separator, char commentChar)
+{
+    MemoryMappedFile mappedFile(inputFileName);
+    const char *data = mappedFile.getData();
+    const size_t size = mappedFile.getSize();
+
+
+    // Split the file into blocks of about 4 MB, each starting at the beginning of a line
+
+    const size_t chunkSize = 4194304;
+    const int Nchunks = size / chunkSize + 1;
+    vector<AsciiChunk> chunks(Nchunks);
+    const char *chunkBegin = data;
+
+    for (int i = 0; i < Nchunks; i++)
+    {
+        const char *chunkEnd = data + size;
+        
+        if (i < Nchunks-1)
+        {
+            chunkEnd = max(chunkBegin, data + (i+1) * (size / Nchunks));
+            const char *newline = static_cast<const char*>(memchr(chunkEnd, '\n', data + size - chunkEnd));
+            chunkEnd = (newline == NULL) ? data + size : newline + 1;
+        }
+
+        chunks[i].begin = chunkBegin;
+        chunks[i].end = chunkEnd;
+        chunkBegin = chunkEnd;
+    }
+
+
+    // Parse all the blocks
+
+    #ifdef _OPENMP
+    #pragma omp parallel for schedule(dynamic)
+    #endif
+    for (int i = 0; i < Nchunks; i++)
+    {
+        parseAsciiChunk(chunks[i], separator, commentChar);
+    }
+
+
+    // Check the blocks in the order of the file, so that the first malformed row is reported, 
+    // and that the number of columns of each block is the one of the first row of the file.
+
+    unsigned long Nrows = 0;
+    int Ncols = -1;
+
+    for (int i = 0; i < Nchunks; i++)
+    {
+        if (chunks[i].Ncols >= 0 && Ncols < 0)
+            Ncols = chunks[i].Ncols;
+
+        if (chunks[i].Ncols >= 0 && chunks[i].Ncols != Ncols)
+        {
+            cerr << "Error on row " << Nrows << ": number of tokens != " << Ncols << endl;
+            exit(EXIT_FAILURE);
+        }
+
+        if (chunks[i].hasError)
+        {
+            cerr << "Error on row " << Nrows + chunks[i].Nrows << chunks[i].errorMessage << endl;
+            exit(EXIT_FAILURE);
+        }
+
+        Nrows += chunks[i].Nrows;
+    }
+
+    if (Nrows == 0)
+    {
+        return ArrayXXd();
+    }
+
+
+    // Collect the rows of all the blocks
+
+    typedef Array<double, Dynamic, Dynamic, RowMajor> ArrayXXdRowMajor;
+    ArrayXXd array(Nrows, Ncols);
+    unsigned long iRow = 0;
+
+    for (int i = 0; i < Nchunks; i++)
+    {
+        if (chunks[i].Nrows == 0) continue;
+
+        array.middleRows(iRow, chunks[i].Nrows) = Map<const ArrayXXdRowMajor>(chunks[i].values.data(), chunks[i].Nrows, Ncols);
+        iRow += chunks[i].Nrows;
+        vector<double>().swap(chunks[i].values);
+    }
+
+    return array;
+}
+
+
+
+
+
+
+
+
+
+
 // File::vectorStringFromFile()
 //
 // PURPOSE: 
@@ -273,17 +568,23 @@ vector<string> File::vectorStringFromFile(ifstream &inputFile, const unsigned lo
 // REMARKS:
 //      - the stream is not closed afterwards
 //      - this function can equally well be used to append to an existing file
+//      - the values are formatted with the current settings of the stream (e.g. scientific,
+//        setprecision()) through a BufferedAsciiWriter, and written to the stream in large blocks
 //
 
-void File::arrayXXdToFile(ofstream &outputFile, RefArrayXXd array, string separator, string terminator)
+void File::arrayXXdToFile(ofstream &outputFile, ConstRefArrayXXd array, string separator, string terminator)
 {
+    BufferedAsciiWriter writer(outputFile);
+
     for (ptrdiff_t i = 0; i < array.rows(); ++i)
     {
         for (ptrdiff_t j = 0; j < array.cols()-1; ++j)
         {
-            outputFile << array(i,j) << separator;
+            writer.write(array(i,j));
+            writer.write(separator);
         }
-        outputFile << array(i,array.cols()-1) << terminator;
+        writer.write(array(i,array.cols()-1));
+        writer.write(terminator);
     }
 } 
 
@@ -313,15 +614,22 @@ void File::arrayXXdToFile(ofstream &outputFile, RefArrayXXd array, string separa
 //      - overloaded function
 //      - the stream is not closed afterwards
 //      - this function can equally well be used to append to an existing file
+//      - the values are formatted with the current settings of the stream (e.g. scientific,
+//        setprecision()) through a BufferedAsciiWriter, and written to the stream in large blocks
 //
 
-void File::twoArrayXdToFile(ofstream &outputFile, RefArrayXd array1, RefArrayXd array2, string separator, string terminator)
+void File::twoArrayXdToFile(ofstream &outputFile, ConstRefArrayXd array1, ConstRefArrayXd array2, string separator, string terminator)
 {
     assert(array1.size() == array2.size());
     
+    BufferedAsciiWriter writer(outputFile);
+
     for (ptrdiff_t i = 0; i < array1.rows(); ++i)
     {
-        outputFile << array1(i) << separator << array2(i) << terminator;
+        writer.write(array1(i));
+        writer.write(separator);
+        writer.write(array2(i));
+        writer.write(terminator);
     }
 }
 
@@ -351,13 +659,18 @@ void File::twoArrayXdToFile(ofstream &outputFile, RefArrayXd array1, RefArrayXd
 // REMARKS:
 //      - the stream is not closed afterwards
 //      - this function can equally well be used to append to an existing file
+//      - the values are formatted with the current settings of the stream (e.g. scientific,
+//        setprecision()) through a BufferedAsciiWriter, and written to the stream in large blocks
 //
 
-void File::arrayXdToFile(ofstream &outputFile, RefArrayXd array, string terminator)
+void File::arrayXdToFile(ofstream &outputFile, ConstRefArrayXd array, string terminator)
 {
+    BufferedAsciiWriter writer(outputFile);
+
     for (ptrdiff_t i = 0; i < array.size(); ++i)
     {
-        outputFile << array(i) << terminator;
+        writer.write(array(i));
+        writer.write(terminator);
     }
 } 
 
@@ -371,7 +684,7 @@ void File::arrayXdToFile(ofstream &outputFile, RefArrayXd array, string terminat
 
 
 
-void File::arrayXXdRowsToFiles(RefArrayXXd array, string fullPathPrefix, string fileExtension, string terminator)
+void File::arrayXXdRowsToFiles(ConstRefArrayXXd array, string fullPathPrefix, string fileExtension, string terminator)
 {
     int Nrows = array.rows();
     assert(Nrows > 0);
@@ -395,10 +708,19 @@ void File::arrayXXdRowsToFiles(RefArrayXXd array, string fullPathPrefix, string
         outputFile << setiosflags(ios::scientific) << setprecision(9);
 
 
-        // Write all values of this particular parameter in our sample to the output file
+        // Write all values of this particular parameter in our sample to the output file.
+        // The row is read in place, without copying it to a contiguous array first.
         
-        ArrayXd oneRow = array.row(i);
-        File::arrayXdToFile(outputFile, oneRow, terminator);
+        {
+            BufferedAsciiWriter writer(outputFile);
+
+            for (ptrdiff_t j = 0; j < array.cols(); ++j)
+            {
+                writer.write(array(i,j));
+                writer.write(terminator);
+            }
+        }
+
         outputFile.close();
     }
 }
@@ -27,3 +27,99 @@ double FractionalDistanceMetric::distance(RefArrayXd point1, RefArrayXd point2)
 {
     return pow((point1-point2).abs().pow(fraction).sum(),1.0/fraction);
 }
+
+
+
+
+
+
+
+
+
+// FractionalDistanceMetric::pointToCentersDistances()
+//
+// PURPOSE:
+//      Compute the fractional distances between one point and a set of centers.
+//      The reduced distance is sum_i^d |x_i - y_i|^f, which avoids the final power 1/f.
+//
+// INPUT:
+//      point(Ndimensions): coordinates of the point
+//      centers(Ndimensions, Ncenters): coordinates of the centers
+//      distances(Ncenters): on output, the (reduced) distance between the point and each center
+//      reduced: if true, return the reduced distances
+//
+// OUTPUT:
+//      void
+//
+
+void FractionalDistanceMetric::pointToCentersDistances(RefArrayXd point, RefArrayXXd centers, RefArrayXd distances, bool reduced)
+{
+    distances = (centers.colwise() - point).abs().pow(fraction).colwise().sum().transpose();
+
+    if (!reduced)
+    {
+        distances = distances.pow(1.0/fraction);
+    }
+}
+
+
+
+
+
+
+
+
+
+// FractionalDistanceMetric::pairwiseDistances()
+//
+// PURPOSE:
+//      Compute the matrix of fractional distances between two samples of points.
+//
+// INPUT:
+//      sample1(Ndimensions, Npoints1): coordinates of the first sample of points
+//      sample2(Ndimensions, Npoints2): coordinates of the second sample of points
+//      distances(Npoints1, Npoints2): on output, the (reduced) distance between each point of sample1 (rows)
+//                                     and each point of sample2 (columns)
+//      reduced: if true, return the reduced distances
+//
+// OUTPUT:
+//      void
+//
+
+void FractionalDistanceMetric::pairwiseDistances(RefArrayXXd sample1, RefArrayXXd sample2, RefArrayXXd distances, bool reduced)
+{
+    for (int j = 0; j < sample2.cols(); ++j)
+    {
+        distances.col(j) = (sample1.colwise() - sample2.col(j)).abs().pow(fraction).colwise().sum().transpose();
+    }
+
+    if (!reduced)
+    {
+        distances = distances.pow(1.0/fraction);
+    }
+}
+
+
+
+
+
+
+
+
+
+// FractionalDistanceMetric::reducedDistanceToDistance()
+//
+// PURPOSE:
+//      Convert a reduced fractional distance into the distance.
+//
+// INPUT:
+//      reducedDistance: the reduced distance sum_i^d |x_i - y_i|^f
+//
+// OUTPUT:
+//      The corresponding distance
+//
+
+double FractionalDistanceMetric::reducedDistanceToDistance(double reducedDistance)
+{
+    return pow(reducedDistance, 1.0/fraction);
+}
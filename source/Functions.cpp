@@ -511,6 +511,91 @@ double Functions::logExpDifference(const double x, const double y)
 
 
 
+
+// Functions::pairwiseSumOfRange()
+//
+// PURPOSE: 
+//      Computes the sum of the elements of an array within a range of indices by 
+//      recursively summing its two halves.
+//
+// INPUT: 
+//      values: an Eigen Array with the numbers to be summed
+//      beginIndex: an integer specifying the first index of the range
+//      endIndex: an integer specifying the index after the last one of the range
+//
+// OUTPUT: 
+//      The sum of the elements of the array within the range.
+//
+// REMARK:
+//      This function is not intented to be used separately
+//      but only through the call to pairwiseSum.
+//
+
+double Functions::pairwiseSumOfRange(RefArrayXd const values, int beginIndex, int endIndex)
+{
+    if (endIndex - beginIndex <= 8)
+    {
+        double sum = 0.0;
+
+        for (int i = beginIndex; i < endIndex; ++i)
+            sum += values(i);
+
+        return sum;
+    }
+
+    const int middleIndex = beginIndex + (endIndex - beginIndex)/2;
+
+    return pairwiseSumOfRange(values, beginIndex, middleIndex) + pairwiseSumOfRange(values, middleIndex, endIndex);
+}
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+// Functions::pairwiseSum()
+//
+// PURPOSE: 
+//      Computes the sum of the elements of an array by recursively summing its two halves,
+//      so that the rounding error grows as log(n) rather than n.
+//
+// INPUT: 
+//      values: an Eigen Array with the numbers to be summed
+//
+// OUTPUT: 
+//      The sum of the elements of the array.
+//
+// REMARK:
+//      The order of the additions only depends on the size of the array, so that the result 
+//      is reproducible, e.g. when the elements are partial sums computed by different threads.
+//
+
+double Functions::pairwiseSum(RefArrayXd const values)
+{
+    return pairwiseSumOfRange(values, 0, values.size());
+}
+
+
+
+
+
+
+
+
+
+
+
+
+
+
 // Functions::topDownMerge()
 //
 // PURPOSE: 
@@ -873,6 +958,56 @@ int Functions::countArrayIndicesWithinBoundaries(RefArrayXd const array, double
 
 
 
+// Functions::countSortedArrayIndicesWithinBoundaries()
+//
+// PURPOSE: 
+//      This function counts the number of elements of an input array sorted in ascending
+//      order that fall within the input boundaries, by means of two binary searches.
+//
+// INPUT:
+//      sortedArray:    an Eigen array whose elements are sorted in ascending order
+//      lowerBound:     a double specifying the smallest value allowed in the search
+//      upperBound:     a double specifying the largest value allowed in the search
+//
+// OUTPUT:
+//      an integer containing the number of elements of the input array that
+//      fall within the input boundaries.
+//
+// REMARKS:
+//      The result is the same as that of countArrayIndicesWithinBoundaries(), but it is 
+//      obtained in O(log n) operations instead of O(n). The input array must be sorted.
+//
+
+int Functions::countSortedArrayIndicesWithinBoundaries(RefArrayXd const sortedArray, double lowerBound, double upperBound)
+{
+    // At least one point is needed
+
+    assert(sortedArray.size() >= 1);
+    int binSize = 0;
+    
+    if (lowerBound < upperBound)
+    {
+        const double *begin = sortedArray.data();
+        const double *end = sortedArray.data() + sortedArray.size();
+
+        binSize = upper_bound(begin, end, upperBound) - lower_bound(begin, end, lowerBound);
+    }
+
+    return binSize;
+}
+
+
+
+
+
+
+
+
+
+
+
+
+
 // Functions::cubicSplineInterpolation()
 // 
 // PURPOSE:
@@ -934,7 +1069,7 @@ ArrayXd Functions::cubicSplineInterpolation(RefArrayXd const observedAbscissa, R
         // Since upper bound of observed abscissa is lower, and the routine is not doing any extrapolation, truncate the array of
         // interpolated abscissa at this upper bound.
 
-        int extraSize = Functions::countArrayIndicesWithinBoundaries(interpolatedAbscissaUntruncated, largestObservedAbscissa, largestInterpolatedAbscissa);
+        int extraSize = Functions::countSortedArrayIndicesWithinBoundaries(interpolatedAbscissaUntruncated, largestObservedAbscissa, largestInterpolatedAbscissa);
         interpolatedSize = interpolatedSize - extraSize;
         interpolatedAbscissa = interpolatedAbscissaUntruncated.segment(0,interpolatedSize);
     }
@@ -987,26 +1122,28 @@ ArrayXd Functions::cubicSplineInterpolation(RefArrayXd const observedAbscissa, R
     }
 
 
-    // Initialize arrays of differences in both ordinate and abscissa
+    // Initialize the array of interpolated ordinate
     
     ArrayXd interpolatedOrdinate = ArrayXd::Zero(interpolatedSize);
-    ArrayXd remainingInterpolatedAbscissa = interpolatedAbscissa;       // The remaining part of the array of interpolated abscissa
     int cumulatedBinSize = 0;                                           // The cumulated number of interpolated points from the beginning
     int i = 0;                                                          // Bin counter
 
     while ((i < size-1) && (cumulatedBinSize < interpolatedSize))
     {
         // Find which values of interpolatedAbscissa are containined within the selected bin of observedAbscissa.
-        // Since elements in interpolatedAbscissa are monotonically increasing, we cut the input array each time
-        // we identify the elements of the current bin. This allows to speed up the process.
+        // Since elements in interpolatedAbscissa are monotonically increasing, and all those preceding the current bin 
+        // have already been interpolated, the points of the bin are the ones that follow, up to the upper edge of the bin.
+        // Hence a single pass over interpolatedAbscissa is done for all the bins.
 
         double lowerAbscissa = observedAbscissa(i);
         double upperAbscissa = observedAbscissa(i+1);
+        int binSize = 0;
 
-
-        // Find total number of interpolated points falling in the current bin
-
-        int binSize = Functions::countArrayIndicesWithinBoundaries(remainingInterpolatedAbscissa, lowerAbscissa, upperAbscissa);
+        if (lowerAbscissa < upperAbscissa)
+        {
+            while ((cumulatedBinSize + binSize < interpolatedSize) && (interpolatedAbscissa(cumulatedBinSize + binSize) <= upperAbscissa))
+                ++binSize;
+        }
       
 
         // Do interpolation only if interpolated points are found within the bin
@@ -1018,31 +1155,21 @@ ArrayXd Functions::cubicSplineInterpolation(RefArrayXd const observedAbscissa, R
             double denominator = differenceAbscissa(i);
             double upperSecondDerivative = secondDerivatives[i+1];
             double lowerSecondDerivative = secondDerivatives[i];
-            ArrayXd interpolatedAbscissaInCurrentBin = remainingInterpolatedAbscissa.segment(0, binSize);
-            ArrayXd interpolatedOrdinateInCurrentBin = ArrayXd::Zero(binSize);
-
-
-            // Compute coefficients for cubic spline interpolation function
 
-            ArrayXd a = (upperAbscissa - interpolatedAbscissaInCurrentBin) / denominator;
-            ArrayXd b = 1.0 - a;
-            ArrayXd c = (1.0/6.0) * (a.cube() - a)*denominator*denominator;
-            ArrayXd d = (1.0/6.0) * (b.cube() - b)*denominator*denominator;
-            interpolatedOrdinateInCurrentBin = a*lowerOrdinate + b*upperOrdinate + c*lowerSecondDerivative + d*upperSecondDerivative;
 
-                
-            // Merge bin ordinate into total array of ordinate
-        
-            interpolatedOrdinate.segment(cumulatedBinSize, binSize) = interpolatedOrdinateInCurrentBin;
+            // Compute coefficients for cubic spline interpolation function and evaluate it 
+            // directly into the total array of ordinate
 
+            for (int j = cumulatedBinSize; j < cumulatedBinSize + binSize; ++j)
+            {
+                double a = (upperAbscissa - interpolatedAbscissa(j)) / denominator;
+                double b = 1.0 - a;
+                double c = (1.0/6.0) * (a*a*a - a)*denominator*denominator;
+                double d = (1.0/6.0) * (b*b*b - b)*denominator*denominator;
+                interpolatedOrdinate(j) = a*lowerOrdinate + b*upperOrdinate + c*lowerSecondDerivative + d*upperSecondDerivative;
+            }
 
-            // Reduce size of array remainingInterpolatedAbscissa by binSize elements and initialize the array
-            // with remaining part of interpolatedAbscissa
-        
-            int currentRemainingSize = interpolatedSize - cumulatedBinSize;
-            remainingInterpolatedAbscissa.resize(currentRemainingSize - binSize);
             cumulatedBinSize += binSize;
-            remainingInterpolatedAbscissa = interpolatedAbscissa.segment(cumulatedBinSize, interpolatedSize-cumulatedBinSize);
         }  
 
 
@@ -1053,3 +1180,163 @@ ArrayXd Functions::cubicSplineInterpolation(RefArrayXd const observedAbscissa, R
 
     return interpolatedOrdinate;
 }
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+// Functions::fastFourierTransform()
+//
+// PURPOSE:
+//      Computes in place the discrete Fourier transform of a complex array, or its inverse,
+//      by means of the iterative radix-2 Cooley-Tukey algorithm, in O(n log n) operations.
+//
+// INPUT:
+//      data:       an Eigen array of complex numbers, whose size must be a power of two.
+//                  It is replaced by its transform.
+//      inverse:    if true, the inverse transform is computed, including the normalization 1/n, 
+//                  so that the inverse of the direct transform gives back the input array.
+//
+// OUTPUT:
+//      void
+//
+// REMARKS:
+//      The direct transform is defined as X_k = sum_j x_j exp(-2 pi i j k / n). The twiddle factors 
+//      are computed once for the largest stage, rather than by repeated multiplications, to limit round-off errors.
+//
+
+void Functions::fastFourierTransform(ArrayXcd &data, const bool inverse)
+{
+    const int size = data.size();
+    assert((size > 0) && ((size & (size - 1)) == 0));
+
+    if (size == 1)
+        return;
+
+
+    // Reorder the elements according to the bit-reversed order of their indices
+
+    for (int i = 1, j = 0; i < size; ++i)
+    {
+        int bit = size >> 1;
+
+        for (; j & bit; bit >>= 1)
+            j ^= bit;
+
+        j ^= bit;
+
+        if (i < j)
+            swap(data(i), data(j));
+    }
+
+
+    // Compute the twiddle factors exp(-+ 2 pi i k / n) for k = 0, ..., n/2 - 1
+
+    const double sign = inverse ? 1.0 : -1.0;
+    ArrayXcd twiddleFactors(size/2);
+
+    for (int k = 0; k < size/2; ++k)
+    {
+        twiddleFactors(k) = polar(1.0, sign * 2.0 * PI * k / size);
+    }
+
+
+    // Combine the transforms of increasing length, from 2 up to n
+
+    for (int length = 2; length <= size; length <<= 1)
+    {
+        const int halfLength = length/2;
+        const int twiddleStride = size/length;
+
+        for (int i = 0; i < size; i += length)
+        {
+            for (int k = 0; k < halfLength; ++k)
+            {
+                complex<double> even = data(i + k);
+                complex<double> odd = data(i + k + halfLength) * twiddleFactors(k * twiddleStride);
+                data(i + k) = even + odd;
+                data(i + k + halfLength) = even - odd;
+            }
+        }
+    }
+
+    if (inverse)
+        data /= static_cast<double>(size);
+}
+
+
+
+
+
+
+
+
+
+
+
+
+
+// Functions::symmetricConvolution()
+//
+// PURPOSE:
+//      Computes the linear (non-circular) convolution of an array with a symmetric kernel, 
+//      e.g. binned data with a smoothing kernel, by means of fast Fourier transforms.
+//
+// INPUT:
+//      data:       an Eigen array with the n input values, e.g. on a regular grid
+//      kernel:     an Eigen array with the values of the kernel at lags 0, 1, ..., L (in units of 
+//                  the grid step). The kernel is symmetric, and zero beyond lag L.
+//
+// OUTPUT:
+//      An Eigen array of n values, with element k equal to sum_j data_j kernel(|k - j|).
+//
+// REMARKS:
+//      The arrays are padded with zeros to a power of two not smaller than n + L, so that
+//      the circular convolution computed by the transforms does not wrap around. 
+//      The cost is O((n + L) log(n + L)), rather than O(n L) for a direct sum.
+//
+
+ArrayXd Functions::symmetricConvolution(RefArrayXd const data, RefArrayXd const kernel)
+{
+    const int size = data.size();
+    const int maxLag = min(static_cast<int>(kernel.size()) - 1, size - 1);
+    assert((size > 0) && (maxLag >= 0));
+
+    int transformSize = 1;
+
+    while (transformSize < size + maxLag)
+        transformSize <<= 1;
+
+    ArrayXcd dataTransform = ArrayXcd::Zero(transformSize);
+    ArrayXcd kernelTransform = ArrayXcd::Zero(transformSize);
+
+    for (int j = 0; j < size; ++j)
+        dataTransform(j) = data(j);
+
+
+    // Store the kernel with its negative lags at the end of the array, as required by the circular convolution
+
+    kernelTransform(0) = kernel(0);
+
+    for (int lag = 1; lag <= maxLag; ++lag)
+    {
+        kernelTransform(lag) = kernel(lag);
+        kernelTransform(transformSize - lag) = kernel(lag);
+    }
+
+    fastFourierTransform(dataTransform);
+    fastFourierTransform(kernelTransform);
+    dataTransform *= kernelTransform;
+    fastFourierTransform(dataTransform, true);
+
+    return dataTransform.head(size).real();
+}
@@ -0,0 +1,230 @@
+#include "FusedLikelihood.h"
+
+
+// NormalNoise::NormalNoise()
+//
+// PURPOSE:
+//      Constructor. Computes once the terms that only depend on the uncertainties.
+//
+// INPUT:
+//      uncertainties: array containing the uncertainties of the observations
+//
+
+NormalNoise::NormalNoise(const RefArrayXd uncertainties)
+{
+    inverseVariances = uncertainties.square().inverse();
+    logNormalization = -0.5 * uncertainties.size() * log(2.0*Functions::PI) - uncertainties.log().sum();
+}
+
+
+
+
+
+
+
+
+
+// NormalNoise::~NormalNoise()
+//
+// PURPOSE:
+//      Destructor.
+//
+
+NormalNoise::~NormalNoise()
+{
+
+}
+
+
+
+
+
+
+
+
+
+// NormalNoise::getNpoints()
+//
+// PURPOSE:
+//      Gets the number of observations.
+//
+// OUTPUT:
+//      An integer containing the number of observations.
+//
+
+int NormalNoise::getNpoints() const
+{
+    return inverseVariances.size();
+}
+
+
+
+
+
+
+
+
+
+// NormalNoise::getLogNormalization()
+//
+// PURPOSE:
+//      Gets the term of the log(Likelihood) that does not depend on the free parameters.
+//
+// OUTPUT:
+//      A double containing -0.5*N*log(2*pi) - sum(log(sigma)).
+//
+
+double NormalNoise::getLogNormalization() const
+{
+    return logNormalization;
+}
+
+
+
+
+
+
+
+
+
+// NormalNoise::reduceBlock()
+//
+// PURPOSE:
+//      Computes the contribution of a block of points to the log(Likelihood), 
+//      i.e. -0.5 * sum((observation - prediction)^2 / sigma^2).
+//
+// INPUT:
+//      observations:   pointer to all the observations
+//      predictions:    pointer to the predictions of the block
+//      begin:          index of the first observation of the block
+//      size:           number of points of the block
+//
+// OUTPUT:
+//      A double containing the contribution of the block.
+//
+
+double NormalNoise::reduceBlock(const double *observations, const double *predictions, const int begin, const int size) const
+{
+    Eigen::Map<const ArrayXd> observationsBlock(observations + begin, size);
+    Eigen::Map<const ArrayXd> predictionsBlock(predictions, size);
+
+    return -0.5 * ((observationsBlock - predictionsBlock).square() * inverseVariances.segment(begin, size)).sum();
+}
+
+
+
+
+
+
+
+
+
+// ExponentialNoise::ExponentialNoise()
+//
+// PURPOSE:
+//      Constructor.
+//
+// INPUT:
+//      Npoints: number of observations
+//
+
+ExponentialNoise::ExponentialNoise(const int Npoints)
+: Npoints(Npoints)
+{
+
+}
+
+
+
+
+
+
+
+
+
+// ExponentialNoise::~ExponentialNoise()
+//
+// PURPOSE:
+//      Destructor.
+//
+
+ExponentialNoise::~ExponentialNoise()
+{
+
+}
+
+
+
+
+
+
+
+
+
+// ExponentialNoise::getNpoints()
+//
+// PURPOSE:
+//      Gets the number of observations.
+//
+// OUTPUT:
+//      An integer containing the number of observations.
+//
+
+int ExponentialNoise::getNpoints() const
+{
+    return Npoints;
+}
+
+
+
+
+
+
+
+
+
+// ExponentialNoise::getLogNormalization()
+//
+// PURPOSE:
+//      Gets the term of the log(Likelihood) that does not depend on the free parameters.
+//
+// OUTPUT:
+//      Zero, since the exponential likelihood has no such term.
+//
+
+double ExponentialNoise::getLogNormalization() const
+{
+    return 0.0;
+}
+
+
+
+
+
+
+
+
+
+// ExponentialNoise::reduceBlock()
+//
+// PURPOSE:
+//      Computes the contribution of a block of points to the log(Likelihood), 
+//      i.e. -sum(log(prediction) + observation/prediction).
+//
+// INPUT:
+//      observations:   pointer to all the observations
+//      predictions:    pointer to the predictions of the block
+//      begin:          index of the first observation of the block
+//      size:           number of points of the block
+//
+// OUTPUT:
+//      A double containing the contribution of the block.
+//
+
+double ExponentialNoise::reduceBlock(const double *observations, const double *predictions, const int begin, const int size) const
+{
+    Eigen::Map<const ArrayXd> observationsBlock(observations + begin, size);
+    Eigen::Map<const ArrayXd> predictionsBlock(predictions, size);
+
+    return -1.0*(predictionsBlock.log() + observationsBlock/predictionsBlock).sum();
+}
@@ -17,16 +17,38 @@
 //               repeat k-means with different trials of initial centers, and pick the best one.
 //      relTolerance: fitting the clusters converged when dp < relTolerance, where dp is the relative 
 //                    change in the total likelihood of the Gaussian Mixture Model as a function of the iterations. 
+//      warmStartActivated: a boolean to allow clusterWithWarmStart() to refine the previous partition
+//                          instead of performing a full search over the range of number of clusters
+//      maxRelativeBICdegradation: a warm-started partition is rejected if its BIC value per point is smaller 
+//                                 than the one of the last full search by more than this relative amount
+//      maxNconsecutiveWarmStarts: maximum number of consecutive warm starts after which a full search 
+//                                 is performed anyway, so that new clusters can still be detected
+//      covarianceType: the form of the covariance matrices of the clusters. FULL matrices are the most flexible,
+//                      DIAGONAL matrices neglect the correlations among the coordinates, SPHERICAL matrices 
+//                      have the same variance along all the coordinates, and TIED means that all the clusters 
+//                      share the same full covariance matrix. The simpler forms are cheaper in high dimensions.
+//      maxNiterations: the maximum number of EM iterations for each trial
 // 
 
 GaussianMixtureClusterer::GaussianMixtureClusterer(Metric &metric, Projector &featureProjector, bool featureProjectionActivated, 
 unsigned int minNclusters, unsigned int maxNclusters, unsigned int Ntrials, 
-double relTolerance)
+double relTolerance, bool warmStartActivated, double maxRelativeBICdegradation, unsigned int maxNconsecutiveWarmStarts,
+CovarianceType covarianceType, unsigned int maxNiterations)
 : Clusterer(metric, featureProjector, featureProjectionActivated),
   minNclusters(minNclusters), 
   maxNclusters(maxNclusters), 
   Ntrials(Ntrials), 
-  relTolerance(relTolerance)
+  relTolerance(relTolerance),
+  covarianceType(covarianceType),
+  maxNiterations(maxNiterations),
+  NpointsPerChunk(256),
+  warmStartActivated(warmStartActivated),
+  previousPartitionIsAvailable(false),
+  maxNconsecutiveWarmStarts(maxNconsecutiveWarmStarts),
+  NconsecutiveWarmStarts(0),
+  previousNdimensions(0),
+  maxRelativeBICdegradation(maxRelativeBICdegradation),
+  previousBICvaluePerPoint(-1.0*numeric_limits<double>::max())
 {
     // Set the seed of the random generator using the clock
 
@@ -36,6 +58,7 @@ double relTolerance)
     // Do some sanity check(s)
 
     assert(minNclusters <= maxNclusters);
+    assert(maxNiterations > 0);
 }
 
 
@@ -99,81 +122,52 @@ void GaussianMixtureClusterer::chooseInitialClusterCenters(RefArrayXXd sample)
 
     int randomPointIndex = uniform(engine);
     int k;
-    double distanceToClosestCenter[Npoints];
-    double sumOfDistancesToClosestCenters;
-    double distance;
+    ArrayXd distanceToClosestCenter(Npoints);
+    ArrayXd distanceToNewCenter(Npoints);
     double uniform01Number;
     double cumulativeDistance;
     centers.col(0) = sample.col(randomPointIndex);
 
+
+    // For each of the points in the sample, determine the distance to the first center.
+    // All the distances are computed in a single call to the metric.
+
+    metric.pointToCentersDistances(centers.col(0), sample, distanceToClosestCenter);
+
     
     
     // Select the other initial centers probabilistically 
 
     for (int n = 1; n < Nclusters; ++n)
     {
-        // For each of the points in the sample, determine the distance to
-        // its closest center 
-    
-        sumOfDistancesToClosestCenters = 0.0;
-    
-        for (int k = 0; k < Npoints; ++k)
-        {
-            for (int j = 0; j < n; ++j)
-            {
-                distance = metric.distance(sample.col(k), centers.col(j));
-                if (j == 0)
-                {
-                    // This is the very first center we're checking, so let's adopt
-                    // this initially as the closest center. 
-                
-                    distanceToClosestCenter[k] = distance;
-                }
-                else
-                {
-                    // Compare with the previous distance to the closest center.
-                    // If it is even smaller, we've found an even closer center.
-                    // In that case, keep the distance value.
-                
-                    if (distance < distanceToClosestCenter[k])
-                    {
-                        distanceToClosestCenter[k] = distance;
-                    }
-                }
-            }
-        
-            sumOfDistancesToClosestCenters += distanceToClosestCenter[k];
-        } 
-    
-
-        // Normalize the distances
+        // Generate a uniform random number between 0 and the sum of the distances 
+        // to the closest center, so that the distances need not be normalized.
     
-        for (int k = 0; k < Npoints; ++k)
-        { 
-            distanceToClosestCenter[k] /= sumOfDistancesToClosestCenters;
-        }
-    
-
-        // Generate a uniform random number between 0 and 1
-    
-        uniform01Number = uniform01(engine);
+        uniform01Number = uniform01(engine) * distanceToClosestCenter.sum();
     
 
         // Select the point that makes the cumulative distance greater than the random
         // number. Those points with a larger distance to their closest center, will have 
         // a greater chance to be chosen as the next cluster center point, than the others.
         
-        cumulativeDistance = distanceToClosestCenter[0];
+        cumulativeDistance = distanceToClosestCenter(0);
         k = 0;
         
-        while (cumulativeDistance < uniform01Number)
+        while ((cumulativeDistance < uniform01Number) && (k < Npoints-1))
         {
             k++;
-            cumulativeDistance += distanceToClosestCenter[k];
+            cumulativeDistance += distanceToClosestCenter(k);
         }
 
         centers.col(n) = sample.col(k);
 
+
+        // Only the distances to the new center have to be computed to update the distances 
+        // of the points to their closest center
+
+        metric.pointToCentersDistances(centers.col(n), sample, distanceToNewCenter);
+        distanceToClosestCenter = distanceToClosestCenter.min(distanceToNewCenter);
+
     } // end loop of selecting initial cluster centers
 }
 
@@ -190,7 +184,7 @@ void GaussianMixtureClusterer::chooseInitialClusterCenters(RefArrayXXd sample)
 //
 // PURPOSE: 
 //      Choose the initial covariance matrices for each cluster by using the set of cluster
-//      centers found previously.
+//      centers found previously. The matrices are then constrained to the chosen covariance type.
 //
 // INPUT:
 //      sample(Ndimensions, Npoints): sample of N-dimensional points
@@ -199,25 +193,261 @@ void GaussianMixtureClusterer::chooseInitialClusterCenters(RefArrayXXd sample)
 //      Nclusters: number of clusters considered
 // 
 // OUTPUT: 
-//      void
+//      True if all the covariance matrices are positive definite, false otherwise
 //
-void GaussianMixtureClusterer::chooseInitialClusterCovarianceMatrices(RefArrayXXd sample)
+bool GaussianMixtureClusterer::chooseInitialClusterCovarianceMatrices(RefArrayXXd sample)
 {
     double biasFactor = 1.0/(Npoints-1.0);
+    MatrixXd differenceFromCenter(Ndimensions, Npoints);
 
     for (int i = 0; i < Nclusters; i++)
     {
-        differenceFromCenters.block(0,i*Npoints,Ndimensions,Npoints) = sample.colwise() - centers.col(i);
+        differenceFromCenter = (sample.colwise() - centers.col(i)).matrix();
 
         covarianceMatrices.block(0, i*Ndimensions,Ndimensions,Ndimensions) = 
-                differenceFromCenters.block(0, i*Npoints,Ndimensions,Npoints).matrix() * 
-                differenceFromCenters.block(0, i*Npoints,Ndimensions,Npoints).matrix().transpose() * biasFactor;
-        
-        determinantOfCovarianceMatrices(i) = covarianceMatrices.block(0, i*Ndimensions,Ndimensions,Ndimensions).matrix().determinant();
-       
-        inverseOfCovarianceMatrices.block(0, i*Ndimensions,Ndimensions,Ndimensions).matrix() = 
-                covarianceMatrices.block(0, i*Ndimensions,Ndimensions,Ndimensions).matrix().inverse();
+                (differenceFromCenter * differenceFromCenter.transpose() * biasFactor).array();
+    }
+
+
+    // Constrain the full covariance matrices according to the covariance type
+
+    if (covarianceType == DIAGONAL || covarianceType == SPHERICAL)
+    {
+        for (int i = 0; i < Nclusters; i++)
+        {
+            ArrayXd variances = covarianceMatrices.block(0, i*Ndimensions,Ndimensions,Ndimensions).matrix().diagonal().array();
+
+            if (covarianceType == SPHERICAL)
+            {
+                variances.setConstant(variances.mean());
+            }
+
+            covarianceMatrices.block(0, i*Ndimensions,Ndimensions,Ndimensions) = MatrixXd(variances.matrix().asDiagonal()).array();
+        }
+    }
+    else if (covarianceType == TIED)
+    {
+        ArrayXXd tiedCovarianceMatrix = ArrayXXd::Zero(Ndimensions, Ndimensions);
+
+        for (int i = 0; i < Nclusters; i++)
+        {
+            tiedCovarianceMatrix += amplitudes(i) * covarianceMatrices.block(0, i*Ndimensions,Ndimensions,Ndimensions);
+        }
+
+        for (int i = 0; i < Nclusters; i++)
+        {
+            covarianceMatrices.block(0, i*Ndimensions,Ndimensions,Ndimensions) = tiedCovarianceMatrix;
+        }
+    }
+
+    return computeCholeskyFactors();
+}
+
+
+
+
+
+
+
+
+
+// GaussianMixtureClusterer::computeCholeskyFactors()
+//
+// PURPOSE: 
+//      Compute the Cholesky decomposition Sigma = L*L^T of the covariance matrix of each cluster,
+//      together with the logarithm of its determinant, log|Sigma| = 2 sum_i log(L_ii).
+//      The factors are used to evaluate the Mahalanobis distances through a triangular solve, 
+//      which avoids both the explicit inverse and the determinant of possibly ill-conditioned matrices.
+//      For diagonal and spherical covariance matrices the factor is simply the diagonal of standard 
+//      deviations, and for tied covariance matrices a single decomposition is shared by all the clusters.
+//
+// OUTPUT: 
+//      True if all the covariance matrices are positive definite, false otherwise
+//
+
+bool GaussianMixtureClusterer::computeCholeskyFactors()
+{
+    for (int i = 0; i < Nclusters; i++)
+    {
+        if (covarianceType == DIAGONAL || covarianceType == SPHERICAL)
+        {
+            ArrayXd variances = covarianceMatrices.block(0, i*Ndimensions,Ndimensions,Ndimensions).matrix().diagonal().array();
+
+            if ((variances <= 0.0).any())
+            {
+                return false;
+            }
+
+            choleskyFactorsOfCovarianceMatrices.block(0, i*Ndimensions,Ndimensions,Ndimensions) = 
+                    MatrixXd(variances.sqrt().matrix().asDiagonal()).array();
+            logDeterminantOfCovarianceMatrices(i) = variances.log().sum();
+        }
+        else if ((covarianceType == TIED) && (i > 0))
+        {
+            choleskyFactorsOfCovarianceMatrices.block(0, i*Ndimensions,Ndimensions,Ndimensions) = 
+                    choleskyFactorsOfCovarianceMatrices.block(0, 0,Ndimensions,Ndimensions);
+            logDeterminantOfCovarianceMatrices(i) = logDeterminantOfCovarianceMatrices(0);
+        }
+        else
+        {
+            LLT<MatrixXd> cholesky(covarianceMatrices.block(0, i*Ndimensions,Ndimensions,Ndimensions).matrix());
+
+            if (cholesky.info() != Success)
+            {
+                return false;
+            }
+
+            choleskyFactorsOfCovarianceMatrices.block(0, i*Ndimensions,Ndimensions,Ndimensions) = cholesky.matrixL().toDenseMatrix().array();
+            logDeterminantOfCovarianceMatrices(i) = 2.0*cholesky.matrixL().toDenseMatrix().diagonal().array().log().sum();
+        }
+
+        if (!std::isfinite(logDeterminantOfCovarianceMatrices(i)))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+
+
+
+
+
+
+// GaussianMixtureClusterer::chooseClusterParametersFromPartition()
+//
+// PURPOSE: 
+//      Initialize the centers, covariance matrices and amplitudes of the Gaussian Mixture Model
+//      from a given (hard) partition of the sample, e.g. the one found at a previous clustering.
+//      The partition is converted into assignment probabilities equal to either 0 or 1, 
+//      from which a single M-step of the EM algorithm gives the parameters of the model.
+//
+// INPUT:
+//      sample(Ndimensions, Npoints): sample of N-dimensional points
+//      clusterIndices(Npoints): for each point the index of the cluster it belongs to
+//      clusterSizes(Nclusters): for each cluster, the number of points it contains
+// 
+// OUTPUT: 
+//      True if all the covariance matrices are positive definite, false otherwise
+//
+
+bool GaussianMixtureClusterer::chooseClusterParametersFromPartition(RefArrayXXd sample, vector<int> &clusterIndices, 
+                                                                    vector<int> &clusterSizes)
+{
+    assignmentProbabilities.setZero();
+
+    for (int n = 0; n < Npoints; ++n)
+    {
+        assignmentProbabilities(n, clusterIndices[n]) = 1.0;
+    }
+
+    responsibilities = assignmentProbabilities.colwise().sum().transpose();
+
+
+    // The full covariance matrix of a cluster with less than Ndimensions+1 points is singular
+
+    unsigned int minClusterSize = ((covarianceType == FULL) ? Ndimensions + 1 : 2);
+
+    if (responsibilities.minCoeff() < minClusterSize)
+    {
+        return false;
+    }
+
+    return updateClusterParameters(sample);
+}
+
+
+
+
+
+
+
+
+// GaussianMixtureClusterer::resizeClusterArrays()
+//
+// PURPOSE: 
+//      Resize and set to zero all the arrays describing the Gaussian Mixture Model, 
+//      according to the current values of Ndimensions, Npoints and Nclusters.
+//
+// OUTPUT: 
+//      void
+//
+
+void GaussianMixtureClusterer::resizeClusterArrays()
+{
+    covarianceMatrices.resize(Ndimensions, Ndimensions*Nclusters);
+    covarianceMatrices.setZero();
+
+    centers.resize(Ndimensions, Nclusters);          // coordinates of each of the old cluster centers
+    centers.setZero();
+    
+    choleskyFactorsOfCovarianceMatrices.resize(Ndimensions, Ndimensions*Nclusters);
+    choleskyFactorsOfCovarianceMatrices.setZero();
+    
+    logDeterminantOfCovarianceMatrices.resize(Nclusters);
+    logDeterminantOfCovarianceMatrices.setZero();
+
+    logMultivariateGaussians.resize(Npoints, Nclusters);
+    logMultivariateGaussians.setZero();
+
+    logModelProbability.resize(Npoints);
+    logModelProbability.setZero();
+
+    assignmentProbabilities.resize(Npoints, Nclusters);
+    assignmentProbabilities.setZero();
+
+    responsibilities.resize(Nclusters);
+    responsibilities.setZero();
+}
+
+
+
+
+
+
+
+
+// GaussianMixtureClusterer::evaluateBICvalue()
+//
+// PURPOSE: 
+//      Evaluate the BIC value of the current Gaussian Mixture Model, by taking into account 
+//      the number of free parameters of the model. Each mixture component has Ndimensions coordinates
+//      of the center, and a number of covariance parameters that depends on the covariance type: 
+//      Ndimensions*(Ndimensions + 1)/2 for full, Ndimensions for diagonal, 1 for spherical covariance 
+//      matrices, while a single set of Ndimensions*(Ndimensions + 1)/2 parameters is shared by all 
+//      the components for tied covariance matrices. The weights of the components add Nclusters-1
+//      free parameters. Higher BIC values correspond to better models.
+//
+// INPUT:
+//      totalLogOfModelProbability: the total logarithm of the GMM probability of the sample
+// 
+// OUTPUT: 
+//      The BIC value
+//
+
+double GaussianMixtureClusterer::evaluateBICvalue(double totalLogOfModelProbability)
+{
+    double NcovarianceParameters;
+
+    switch (covarianceType)
+    {
+        case DIAGONAL:
+            NcovarianceParameters = Nclusters*Ndimensions;
+            break;
+        case SPHERICAL:
+            NcovarianceParameters = Nclusters;
+            break;
+        case TIED:
+            NcovarianceParameters = Ndimensions*(Ndimensions+1)*0.5;
+            break;
+        default:
+            NcovarianceParameters = Nclusters*Ndimensions*(Ndimensions+1)*0.5;
     }
+
+    return totalLogOfModelProbability - 0.5*log(Npoints)*(Nclusters-1 + Nclusters*Ndimensions + NcovarianceParameters);
 }
 
 
@@ -230,44 +460,267 @@ void GaussianMixtureClusterer::chooseInitialClusterCovarianceMatrices(RefArrayXX
 // GaussianMixtureClusterer::computeGaussianMixtureModel()
 //
 // PURPOSE: 
-//      Choose the initial covariance matrices for each cluster by using the set of cluster
-//      centers found previously. Assume amplitudes of individual Gaussians are defined from outside.
+//      Perform the E-step of the EM algorithm. Given the current centers, covariance matrices
+//      and amplitudes, compute the logarithm of each Gaussian of the mixture and of the total
+//      Gaussian Mixture Model for all the points of the sample, together with the assignment 
+//      probabilities and the responsibilities of the clusters. The points are processed in chunks 
+//      that are distributed over the threads, if OpenMP is enabled.
 //
 // INPUT:
 //      sample(Ndimensions, Npoints): sample of N-dimensional points
-//      center(Ndimensions, Nclusters): set of N-dimensional coordinates of the cluster centers 
-//      covarianceMatrices(Ndimensions,Nclusters*Ndimensions): set of Nclusters N-dimensional covariance matrices for the clusters
-//      Nclusters: number of clusters considered
 // 
 // OUTPUT: 
 //      void
 //
 void GaussianMixtureClusterer::computeGaussianMixtureModel(RefArrayXXd sample)
 {
-    // Compute the multivariate Gaussian for each cluster selected
+    int Nchunks = (Npoints + NpointsPerChunk - 1) / NpointsPerChunk;
+    ArrayXd logAmplitudes = amplitudes.log();
+    double logNormalization = -0.5*Ndimensions*log(2.0*Functions::PI);
+
+    #ifdef _OPENMP
+    #pragma omp parallel for schedule(static)
+    #endif
+    for (int chunk = 0; chunk < Nchunks; ++chunk)
+    {
+        int firstPoint = chunk * NpointsPerChunk;
+        int NpointsInChunk = min(NpointsPerChunk, int(Npoints) - firstPoint);
+        MatrixXd whitenedDifferences(Ndimensions, NpointsInChunk);
 
-    modelProbability.setZero();
-    ArrayXXd argument(Npoints, Npoints);
 
-    for (int i = 0; i < Nclusters; i++)
+        // Compute the logarithm of the multivariate Gaussian for each cluster selected. 
+        // The squared Mahalanobis distance of each point is (x-mu)^T Sigma^-1 (x-mu) = |L^-1 (x-mu)|^2,
+        // which only requires a triangular solve with the Cholesky factor L of the covariance matrix,
+        // or a simple division by the standard deviations if the covariance matrix is diagonal.
+
+        for (int i = 0; i < Nclusters; i++)
+        {
+            whitenedDifferences = (sample.block(0, firstPoint, Ndimensions, NpointsInChunk).colwise() - centers.col(i)).matrix();
+
+            if (covarianceType == DIAGONAL || covarianceType == SPHERICAL)
+            {
+                whitenedDifferences.array().colwise() /= 
+                        choleskyFactorsOfCovarianceMatrices.block(0, i*Ndimensions,Ndimensions, Ndimensions).matrix().diagonal().array();
+            }
+            else
+            {
+                choleskyFactorsOfCovarianceMatrices.block(0, i*Ndimensions,Ndimensions, Ndimensions).matrix()
+                        .triangularView<Lower>().solveInPlace(whitenedDifferences);
+            }
+
+            logMultivariateGaussians.col(i).segment(firstPoint, NpointsInChunk) = logNormalization - 0.5*logDeterminantOfCovarianceMatrices(i)
+                                                                                - 0.5*whitenedDifferences.colwise().squaredNorm().transpose().array();
+        }
+
+
+        // Compute the logarithm of the total Gaussian Mixture Model with the log-sum-exp trick, 
+        // so that points far away from all the clusters do not underflow
+
+        ArrayXXd logWeightedGaussians = logMultivariateGaussians.middleRows(firstPoint, NpointsInChunk).rowwise() + logAmplitudes.transpose();
+        ArrayXd maxLogWeightedGaussians = logWeightedGaussians.rowwise().maxCoeff();
+
+        logModelProbability.segment(firstPoint, NpointsInChunk) = maxLogWeightedGaussians + 
+                (logWeightedGaussians.colwise() - maxLogWeightedGaussians).exp().rowwise().sum().log();
+
+
+        // Compute assignment probabilities for each data point
+
+        assignmentProbabilities.middleRows(firstPoint, NpointsInChunk) = 
+                (logWeightedGaussians.colwise() - logModelProbability.segment(firstPoint, NpointsInChunk)).exp();
+    }
+
+
+    // Compute the responsibility of each cluster
+
+    responsibilities = assignmentProbabilities.colwise().sum().transpose();
+}
+
+
+
+
+
+
+
+
+// GaussianMixtureClusterer::updateClusterParameters()
+//
+// PURPOSE: 
+//      Perform the M-step of the EM algorithm. Given the assignment probabilities of the points, 
+//      update the amplitudes, the centers and the covariance matrices of the clusters according 
+//      to the covariance type. The points are processed in chunks that are distributed over the threads,
+//      if OpenMP is enabled. Each thread accumulates its own partial sufficient statistics, which
+//      are summed up in the order of the threads after the parallel region. As the chunks are statically
+//      assigned to the threads, the result is reproducible for a given number of threads.
+//
+// INPUT:
+//      sample(Ndimensions, Npoints): sample of N-dimensional points
+// 
+// OUTPUT: 
+//      True if all the updated covariance matrices are positive definite, false otherwise
+//
+
+bool GaussianMixtureClusterer::updateClusterParameters(RefArrayXXd sample)
+{
+    int Nchunks = (Npoints + NpointsPerChunk - 1) / NpointsPerChunk;
+    bool covarianceIsDiagonal = (covarianceType == DIAGONAL || covarianceType == SPHERICAL);
+
+
+    // Update the amplitudes and the cluster centers, which are simply the barycenters of all points 
+    // weighted by the probabilities computed from each cluster (weights). 
+
+    amplitudes = responsibilities/Npoints; 
+    centers.setZero();
+
+    int Nthreads = 1;
+
+    #ifdef _OPENMP
+    Nthreads = omp_get_max_threads();
+    #endif
+
+    vector<MatrixXd> partialCenters(Nthreads, MatrixXd::Zero(Ndimensions, Nclusters));
+
+    #ifdef _OPENMP
+    #pragma omp parallel num_threads(Nthreads)
+    #endif
+    {
+        int thread = 0;
+
+        #ifdef _OPENMP
+        thread = omp_get_thread_num();
+        #endif
+
+        #ifdef _OPENMP
+        #pragma omp for schedule(static)
+        #endif
+        for (int chunk = 0; chunk < Nchunks; ++chunk)
+        {
+            int firstPoint = chunk * NpointsPerChunk;
+            int NpointsInChunk = min(NpointsPerChunk, int(Npoints) - firstPoint);
+
+            partialCenters[thread].noalias() += sample.block(0, firstPoint, Ndimensions, NpointsInChunk).matrix() * 
+                                                assignmentProbabilities.middleRows(firstPoint, NpointsInChunk).matrix();
+        }
+    }
+
+    for (int thread = 0; thread < Nthreads; ++thread)
+    {
+        centers += partialCenters[thread].array();
+    }
+
+    centers.rowwise() /= responsibilities.transpose();
+
+
+    // Update the covariance matrices for each cluster. For diagonal types only the variances are accumulated.
+
+    ArrayXXd variances = ArrayXXd::Zero(Ndimensions, Nclusters);
+    covarianceMatrices.setZero();
+
+    vector<ArrayXXd> partialVariances(Nthreads);
+    vector<ArrayXXd> partialCovarianceMatrices(Nthreads);
+
+    for (int thread = 0; thread < Nthreads; ++thread)
     {
-        argument = differenceFromCenters.block(0, i*Npoints,Ndimensions, Npoints).matrix().transpose() * 
-                            inverseOfCovarianceMatrices.block(0, i*Ndimensions,Ndimensions, Ndimensions).matrix() * 
-                            differenceFromCenters.block(0, i*Npoints,Ndimensions, Npoints).matrix();
-        multivariateGaussians.col(i) = (-0.5*Ndimensions*log(2.0*Functions::PI) -0.5*log(fabs(determinantOfCovarianceMatrices(i))) - 
-                            0.5*argument).matrix().diagonal().array().exp();
+        if (covarianceIsDiagonal)
+            partialVariances[thread] = ArrayXXd::Zero(Ndimensions, Nclusters);
+        else
+            partialCovarianceMatrices[thread] = ArrayXXd::Zero(Ndimensions, Ndimensions*Nclusters);
+    }
+
+    #ifdef _OPENMP
+    #pragma omp parallel num_threads(Nthreads)
+    #endif
+    {
+        int thread = 0;
+        MatrixXd differenceFromCenter;
+        MatrixXd weightedDifferenceFromCenter;
+
+        #ifdef _OPENMP
+        thread = omp_get_thread_num();
+        #endif
+
+        #ifdef _OPENMP
+        #pragma omp for schedule(static)
+        #endif
+        for (int chunk = 0; chunk < Nchunks; ++chunk)
+        {
+            int firstPoint = chunk * NpointsPerChunk;
+            int NpointsInChunk = min(NpointsPerChunk, int(Npoints) - firstPoint);
+
+            for (int i = 0; i < Nclusters; i++)
+            {
+                differenceFromCenter = (sample.block(0, firstPoint, Ndimensions, NpointsInChunk).colwise() - centers.col(i)).matrix();
+                weightedDifferenceFromCenter = (differenceFromCenter.array().rowwise() * 
+                                                assignmentProbabilities.col(i).segment(firstPoint, NpointsInChunk).transpose()).matrix();
+
+                if (covarianceIsDiagonal)
+                {
+                    partialVariances[thread].col(i) += (weightedDifferenceFromCenter.array() * differenceFromCenter.array()).rowwise().sum();
+                }
+                else
+                {
+                    partialCovarianceMatrices[thread].block(0, i*Ndimensions,Ndimensions, Ndimensions).matrix().noalias() += 
+                            weightedDifferenceFromCenter * differenceFromCenter.transpose();
+                }
+            }
+        }
+    }
+
+    for (int thread = 0; thread < Nthreads; ++thread)
+    {
+        if (covarianceIsDiagonal)
+        {
+            variances += partialVariances[thread];
+        }
+        else
+        {
+            covarianceMatrices += partialCovarianceMatrices[thread];
+        }
+    }
+
+
+    // Normalize the covariance matrices according to the covariance type
+
+    if (covarianceType == TIED)
+    {
+        ArrayXXd tiedCovarianceMatrix = ArrayXXd::Zero(Ndimensions, Ndimensions);
+
+        for (int i = 0; i < Nclusters; i++)
+        {
+            tiedCovarianceMatrix += covarianceMatrices.block(0, i*Ndimensions,Ndimensions, Ndimensions);
+        }
+
+        tiedCovarianceMatrix /= Npoints;
+
+        for (int i = 0; i < Nclusters; i++)
+        {
+            covarianceMatrices.block(0, i*Ndimensions,Ndimensions, Ndimensions) = tiedCovarianceMatrix;
+        }
+    }
+    else
+    {
+        for (int i = 0; i < Nclusters; i++)
+        {
+            if (covarianceType == DIAGONAL)
+            {
+                covarianceMatrices.block(0, i*Ndimensions,Ndimensions, Ndimensions) = 
+                        MatrixXd((variances.col(i) / responsibilities(i)).matrix().asDiagonal()).array();
+            }
+            else if (covarianceType == SPHERICAL)
+            {
+                covarianceMatrices.block(0, i*Ndimensions,Ndimensions, Ndimensions) = 
+                        MatrixXd::Identity(Ndimensions, Ndimensions).array() * variances.col(i).sum() / (Ndimensions * responsibilities(i));
+            }
+            else
+            {
+                covarianceMatrices.block(0, i*Ndimensions,Ndimensions, Ndimensions) /= responsibilities(i);
+            }
+        }
     }
 
-    // Compute total Gaussian Mixture Model
 
-    modelProbability = multivariateGaussians.matrix()*amplitudes.matrix(); 
-
-
-    // Compute assignment probabilities for each data point and the cluster responsibility
-
-    assignmentProbabilities = (multivariateGaussians.rowwise()*amplitudes.transpose()).colwise()/modelProbability;
-    responsibilities = assignmentProbabilities.colwise().sum();
+    // The covariance matrices have to be positive definite for the GMM to be computed
 
+    return computeCholeskyFactors();
 }
 
 
@@ -287,20 +740,15 @@ void GaussianMixtureClusterer::computeGaussianMixtureModel(RefArrayXXd sample)
 //      so that the cluster center and covariance matrix can be updated. 
 //      The weights are in this case the assignment probabilities for each point to belong
 //      to a given cluster, according to the definition of the GMM.
+//      The iterations stop when the relative increment in the total log-likelihood of the GMM
+//      falls below relTolerance, when the log-likelihood no longer increases, or after maxNiterations.
 //
 // INPUT:
 //      sample(Ndimensions, Npoints):   sample of N-dimensional points
-//      center(Ndimensions, Nclusters): set of N-dimensional coordinates of the cluster centers 
-//      clusterSizes(Nclusters):        for each cluster, the number of points it contains
-//      clusterIndices(Npoints):        for each point the index of the cluster it belongs to. This index
-//                                      runs from 0 to Nclusters-1.
-//      relTolerance:                   fitting the clusters converged when S < relTolerance, where S 
-//                                      is the relative increment in total logarithm of GMM probability
 // 
 // OUTPUT:
-//      True if the convergence of k-means was successful, false otherwise. A convergence is
-//      considered successful if the relTolerance-criterion is satisfied (see above), _and_ if 
-//      all clusters contain at least 2 points.
+//      True if the convergence of the EM algorithm was successful, false otherwise. A convergence is
+//      considered successful if all the covariance matrices remained positive definite.
 
 
 bool GaussianMixtureClusterer::updateClustersUntilConverged(RefArrayXXd optimizedSample)
@@ -309,6 +757,7 @@ bool GaussianMixtureClusterer::updateClustersUntilConverged(RefArrayXXd optimize
     // Once convergence is reached, determe which points belongs to which cluster
     
     double relativeIncrement;
+    double updatedTotalLogOfModelProbability;
     bool stopIterations = false;
     bool convergenceReached;
     unsigned int loop = 0;
@@ -316,46 +765,17 @@ bool GaussianMixtureClusterer::updateClustersUntilConverged(RefArrayXXd optimize
 
     while (!stopIterations)
     {
-        // Recompute/update the new cluster centers, which is simply
-        // the barycenter of all points belonging to the cluster according to
-        // the probabilities computed from each cluster (weights). 
-    
-        amplitudes = responsibilities/Npoints; 
-        centers = optimizedSample.matrix() * assignmentProbabilities.matrix();
-        centers = centers.rowwise()/responsibilities.transpose();
-
-
-        // Update the covariance matrices for each cluster
+        // M-step: update the amplitudes, centers and covariance matrices. If at least one of the covariance 
+        // matrices is not positive definite, then the algorithm must be stopped and a new trial has to be done
 
-        for (int i = 0; i < Nclusters; i++)
+        if (!updateClusterParameters(optimizedSample))
         {
-            differenceFromCenters.block(0,i*Npoints,Ndimensions, Npoints) = optimizedSample.colwise() - centers.col(i);
-
-            covarianceMatrices.block(0, i*Ndimensions,Ndimensions, Ndimensions) = 
-                    differenceFromCenters.block(0, i*Npoints,Ndimensions, Npoints).matrix() * 
-                    assignmentProbabilities.col(i).matrix().asDiagonal() * 
-                    differenceFromCenters.block(0, i*Npoints,Ndimensions, Npoints).matrix().transpose();
-
-            covarianceMatrices.block(0, i*Ndimensions,Ndimensions, Ndimensions) /= responsibilities(i);
-
-            determinantOfCovarianceMatrices(i) = covarianceMatrices.block(0, i*Ndimensions,Ndimensions,Ndimensions).matrix().determinant();
-           
-            
-            // If at least one of the covariance matrices determinant is zero, then the algorithm must be stopped and 
-            // a new trial has to be done
-            
-            if (determinantOfCovarianceMatrices(i) == 0)
-            {
-                convergenceReached = false;
-                return convergenceReached;
-            }
-            
-            inverseOfCovarianceMatrices.block(0, i*Ndimensions,Ndimensions, Ndimensions).matrix() = 
-            covarianceMatrices.block(0, i*Ndimensions,Ndimensions, Ndimensions).matrix().inverse();
+            convergenceReached = false;
+            return convergenceReached;
         }
         
             
-        // If this step has been reached, then covariance matrices are invertible and the GMM can be computed
+        // E-step: if this step has been reached, then covariance matrices are positive definite and the GMM can be computed
             
         computeGaussianMixtureModel(optimizedSample);
        
@@ -363,21 +783,24 @@ bool GaussianMixtureClusterer::updateClustersUntilConverged(RefArrayXXd optimize
         // A new set of clusters has been determined.
         // Decide whether the algorithm has converged. Convergence occurs when
         // the increment in the total model probability becomes lower than an input threshold.
+        // Since each EM iteration cannot decrease the total model probability, a decrease
+        // only reflects round-off errors and the iterations can be stopped as well.
         
-        relativeIncrement = fabs(modelProbability.log().sum() - totalLogOfModelProbability)/fabs(minTotalLogOfModelProbability); 
-        totalLogOfModelProbability = modelProbability.log().sum();
+        updatedTotalLogOfModelProbability = logModelProbability.sum();
+        relativeIncrement = (updatedTotalLogOfModelProbability - totalLogOfModelProbability)/fabs(minTotalLogOfModelProbability); 
+        totalLogOfModelProbability = updatedTotalLogOfModelProbability;
 
         if (relativeIncrement <= relTolerance)
         {
             stopIterations = true;
         }
-       
-        if (loop >= 30)                 // !!!!!!!!!!!!!
+
+        loop++;
+
+        if (loop >= maxNiterations)
         {
             stopIterations = true;
         }
-
-        loop++;
     }  // end GMM updating loop 
     
     
@@ -396,8 +819,6 @@ bool GaussianMixtureClusterer::updateClustersUntilConverged(RefArrayXXd optimize
 
 
 
-
-
 // GaussianMixtureClusterer::searchForEmptyClusters()
 //
 // PURPOSE: 
@@ -504,7 +925,6 @@ void GaussianMixtureClusterer::obtainClusterMembership(vector<int> &optimalClust
 
 int GaussianMixtureClusterer::cluster(RefArrayXXd sample, vector<int> &optimalClusterIndices, vector<int> &optimalClusterSizes)
 {
-    Npoints = sample.cols();
     ArrayXXd optimizedSample;
 
     // If activated, apply a dimensionality reduction of the data sample according to the chosen feature projector (e.g. PCA)
@@ -522,9 +942,43 @@ int GaussianMixtureClusterer::cluster(RefArrayXXd sample, vector<int> &optimalCl
     {
         optimizedSample = sample;
     }
-    
+
+    return clusterProjectedSample(optimizedSample, optimalClusterIndices, optimalClusterSizes);
+}
+
+
+
+
+
+
+
+
+
+
+
+
+// GaussianMixtureClusterer::clusterProjectedSample()
+//
+// PURPOSE: 
+//      Search the optimal number of clusters of a sample to which the feature projection, if activated, 
+//      was already applied. This is the search done by cluster(), which is also used by clusterWithWarmStart()
+//      when the warm start is rejected, so that the same sample is never projected twice.
+//
+// INPUT:
+//      optimizedSample(Ndimensions, Npoints): sample of (projected) N-dimensional points
+//      optimalClusterIndices(Npoints): for each point the index of the cluster it belongs to. This index
+//                                      runs from 0 to Nclusters-1.
+//      optimalClusterSizes(Nclusters): for each of the clusters, this vector contains the number of points
+// 
+// OUTPUT:
+//      The optimal number of clusters
+//
+
+int GaussianMixtureClusterer::clusterProjectedSample(RefArrayXXd optimizedSample, vector<int> &optimalClusterIndices, 
+                                                     vector<int> &optimalClusterSizes)
+{
+    Npoints = optimizedSample.cols();
     Ndimensions = optimizedSample.rows();
-    modelProbability.resize(Npoints);
 
     bool convergedSuccessfully;
     bool noEmptyClustersFound;
@@ -540,6 +994,7 @@ int GaussianMixtureClusterer::cluster(RefArrayXXd sample, vector<int> &optimalCl
     // Best total model probability wrt number of clusters 
     
     double bestBICvalue = -1.0*numeric_limits<double>::max();
+    double optimalBICvalue = -1.0*numeric_limits<double>::max();
     double BICvalue;
 
     ArrayXXd bestCenters;
@@ -574,29 +1029,7 @@ int GaussianMixtureClusterer::cluster(RefArrayXXd sample, vector<int> &optimalCl
         
         // Resize relevant arrays according to the number of clusters
 
-        differenceFromCenters.resize(Ndimensions, Npoints*Nclusters);
-        differenceFromCenters.setZero();
-        
-        covarianceMatrices.resize(Ndimensions, Ndimensions*Nclusters);
-        covarianceMatrices.setZero();
-
-        centers.resize(Ndimensions, Nclusters);          // coordinates of each of the old cluster centers
-        centers.setZero();
-        
-        inverseOfCovarianceMatrices.resize(Ndimensions, Ndimensions*Nclusters);
-        inverseOfCovarianceMatrices.setZero();
-        
-        determinantOfCovarianceMatrices.resize(Nclusters);
-        determinantOfCovarianceMatrices.setZero();
-
-        multivariateGaussians.resize(Npoints, Nclusters);
-        multivariateGaussians.setZero();
-
-        assignmentProbabilities.resize(Npoints, Nclusters);
-        assignmentProbabilities.setZero();
-
-        responsibilities.resize(Nclusters);
-        responsibilities.setZero();
+        resizeClusterArrays();
 
         bestCenters.resize(Ndimensions, Nclusters);
         bestCovarianceMatrices.resize(Ndimensions, Ndimensions*Nclusters);
@@ -614,10 +1047,11 @@ int GaussianMixtureClusterer::cluster(RefArrayXXd sample, vector<int> &optimalCl
         {
             // cout << "Number of trail: " << m << endl;
             chooseInitialClusterCenters(optimizedSample);
-            chooseInitialClusterCovarianceMatrices(optimizedSample);
+
+            if (!chooseInitialClusterCovarianceMatrices(optimizedSample)) continue;
             
             computeGaussianMixtureModel(optimizedSample);
-            minTotalLogOfModelProbability = modelProbability.log().sum();
+            minTotalLogOfModelProbability = logModelProbability.sum();
             totalLogOfModelProbability = minTotalLogOfModelProbability;
 
             convergedSuccessfully = updateClustersUntilConverged(optimizedSample);
@@ -641,9 +1075,9 @@ int GaussianMixtureClusterer::cluster(RefArrayXXd sample, vector<int> &optimalCl
             // If we did obtain a successful convergence, compare it with the previous clusterings 
             // (all of them with the same number of clusters), and keep the best one.
             
-            if (modelProbability.log().sum() > bestTotalLogOfModelProbability)
+            if (logModelProbability.sum() > bestTotalLogOfModelProbability)
             {
-                bestTotalLogOfModelProbability = modelProbability.log().sum();
+                bestTotalLogOfModelProbability = logModelProbability.sum();
                 bestCenters = centers;
                 bestCovarianceMatrices = covarianceMatrices;
                 bestAssignmentProbabilities = assignmentProbabilities;
@@ -665,12 +1099,8 @@ int GaussianMixtureClusterer::cluster(RefArrayXXd sample, vector<int> &optimalCl
         if (maxNclusters - minNclusters > 0)
         {
             // Evaluate the BIC value by taking into account the number of free parameters of the model
-            // Considering a multivariate Gaussian in Ndimensions one has Ndimensions + Ndimensions*(Ndimensions + 1)/2
-            // free parameters. This has to be multiplied by the number of mixture components in the model and add the
-            // number of weights for each component as free parameters as well.
 
-            BICvalue = bestTotalLogOfModelProbability - 0.5*log(Npoints)*(Nclusters-1 + 
-                        Nclusters*(Ndimensions + Ndimensions*(Ndimensions+1)*0.5));
+            BICvalue = evaluateBICvalue(bestTotalLogOfModelProbability);
             
             if (BICvalue > bestBICvalue)
             {
@@ -680,6 +1110,7 @@ int GaussianMixtureClusterer::cluster(RefArrayXXd sample, vector<int> &optimalCl
                 // values for the number of clusters.
                 
                 bestBICvalue = BICvalue;
+                optimalBICvalue = BICvalue;
                 
                 optimalNclusters = Nclusters;
                 optimalCenters.resize(Ndimensions, Nclusters);
@@ -695,6 +1126,7 @@ int GaussianMixtureClusterer::cluster(RefArrayXXd sample, vector<int> &optimalCl
             // User allowed only 1 particular number of clusters. There is no need to check for the best
             // number of clusters.
             optimalNclusters = Nclusters;
+            optimalBICvalue = evaluateBICvalue(bestTotalLogOfModelProbability);
             optimalCenters.resize(Ndimensions, Nclusters);
             optimalCenters = bestCenters;
             optimalCovarianceMatrices.resize(Ndimensions, Ndimensions*Nclusters);
@@ -713,12 +1145,21 @@ int GaussianMixtureClusterer::cluster(RefArrayXXd sample, vector<int> &optimalCl
     {
         optimalClusterSizes.resize(optimalNclusters);
         obtainClusterMembership(optimalClusterIndices, optimalClusterSizes, optimalAssignmentProbabilities);
+
+        // Keep track of the quality of the partition, so that it can be used as a reference
+        // by the next warm-started clustering
+
+        previousPartitionIsAvailable = std::isfinite(optimalBICvalue) && (optimalBICvalue > -1.0*numeric_limits<double>::max());
+        previousNdimensions = Ndimensions;
+        NconsecutiveWarmStarts = 0;
+        previousBICvaluePerPoint = optimalBICvalue / Npoints;
     }
     else
     {
         cout << "Could not find cluster solution with input Nclusters range." << endl;
         cout << "Setting optimal number of clusters to 1 (entire sample)." << endl;
         optimalNclusters = 1;
+        previousPartitionIsAvailable = false;
     }
 
     // That's it!
@@ -727,3 +1168,297 @@ int GaussianMixtureClusterer::cluster(RefArrayXXd sample, vector<int> &optimalCl
     return optimalNclusters;
 }
 
+
+
+
+
+
+
+
+
+
+
+
+// GaussianMixtureClusterer::clusterWithWarmStart()
+//
+// PURPOSE: 
+//      Given a sample of N-dimensional points and the partition found at the previous clustering, 
+//      refine the partition with a few EM iterations, starting from the Gaussian Mixture Model 
+//      built from the previous clusters (as evaluated on the current sample). Since only a small 
+//      fraction of the points has changed since the previous clustering, this is usually much 
+//      cheaper than a full search over all numbers of clusters and all trials.
+//      The full search of cluster() is performed instead if the warm start is not activated, if
+//      no previous partition is available, after maxNconsecutiveWarmStarts consecutive warm starts 
+//      (a refinement cannot change the number of clusters), or if the refined partition fails a quality check,
+//      i.e. if a cluster ends up with less than 2 points or if the BIC value per point became worse
+//      than the one of the last full search by more than maxRelativeBICdegradation.
+//
+// INPUT:
+//      sample(Ndimensions, Npoints): sample of N-dimensional points
+//      clusterIndices(Npoints): on input, for each point the index of the cluster it belonged to in 
+//                               the previous partition. On output, the updated cluster indices.
+//      clusterSizes(Nclusters): on input, the sizes of the clusters of the previous partition.
+//                               On output, the updated cluster sizes.
+// 
+// OUTPUT:
+//      The number of clusters found
+//
+
+int GaussianMixtureClusterer::clusterWithWarmStart(RefArrayXXd sample, vector<int> &clusterIndices, vector<int> &clusterSizes)
+{
+    // Check whether a warm start is possible at all
+
+    bool warmStartIsPossible = warmStartActivated && previousPartitionIsAvailable
+                               && (NconsecutiveWarmStarts < maxNconsecutiveWarmStarts)
+                               && (clusterIndices.size() == static_cast<size_t>(sample.cols()))
+                               && (clusterSizes.size() >= minNclusters) && (clusterSizes.size() <= maxNclusters);
+
+    if (!warmStartIsPossible)
+    {
+        clusterSizes.clear();
+        return cluster(sample, clusterIndices, clusterSizes);
+    }
+
+    Npoints = sample.cols();
+    Nclusters = clusterSizes.size();
+
+    ArrayXXd optimizedSample;
+
+    if (featureProjectionActivated)
+    {
+        optimizedSample = featureProjector.projection(sample);
+    }
+    else
+    {
+        optimizedSample = sample;
+    }
+
+    Ndimensions = optimizedSample.rows();
+
+
+    // If the projected sample changed dimensionality, the previous partition is no longer a good reference
+
+    if (Ndimensions != previousNdimensions)
+    {
+        clusterSizes.clear();
+        return clusterProjectedSample(optimizedSample, clusterIndices, clusterSizes);
+    }
+
+
+    // Build the initial Gaussian Mixture Model from the previous partition and refine it with EM
+
+    resizeClusterArrays();
+
+    bool warmStartIsSuccessful = chooseClusterParametersFromPartition(optimizedSample, clusterIndices, clusterSizes);
+    double BICvaluePerPoint;
+
+    if (warmStartIsSuccessful)
+    {
+        computeGaussianMixtureModel(optimizedSample);
+        minTotalLogOfModelProbability = logModelProbability.sum();
+        totalLogOfModelProbability = minTotalLogOfModelProbability;
+
+        warmStartIsSuccessful = updateClustersUntilConverged(optimizedSample) && searchForEmptyClusters();
+    }
+
+    if (warmStartIsSuccessful)
+    {
+        // Check that the quality of the partition did not degrade significantly with respect to the one
+        // of the last full search, so that the degradations of consecutive warm starts cannot add up
+
+        BICvaluePerPoint = evaluateBICvalue(logModelProbability.sum()) / Npoints;
+        warmStartIsSuccessful = std::isfinite(BICvaluePerPoint) && 
+                                (BICvaluePerPoint >= previousBICvaluePerPoint - maxRelativeBICdegradation * fabs(previousBICvaluePerPoint));
+    }
+
+    if (!warmStartIsSuccessful)
+    {
+        // The warm start failed the quality check, hence do a full search over the range of number of clusters
+
+        clusterSizes.clear();
+        return clusterProjectedSample(optimizedSample, clusterIndices, clusterSizes);
+    }
+
+
+    // The refined partition is accepted
+
+    clusterSizes.assign(Nclusters, 0);
+    obtainClusterMembership(clusterIndices, clusterSizes, assignmentProbabilities);
+    NconsecutiveWarmStarts++;
+
+    return Nclusters;
+}
+
+
+
+
+
+
+
+
+
+
+
+
+
+// GaussianMixtureClusterer::getCenters()
+//
+// PURPOSE: 
+//      Get the centers of the clusters of the last Gaussian Mixture Model fitted.
+//
+// OUTPUT:
+//      An array of dimensions (Ndimensions, Nclusters) containing the coordinates of the centers
+//
+
+ArrayXXd GaussianMixtureClusterer::getCenters()
+{
+    return centers;
+}
+
+
+
+
+
+
+
+
+
+
+
+// GaussianMixtureClusterer::getCovarianceMatrices()
+//
+// PURPOSE: 
+//      Get the covariance matrices of the clusters of the last Gaussian Mixture Model fitted.
+//
+// OUTPUT:
+//      An array of dimensions (Ndimensions, Ndimensions*Nclusters) containing the covariance
+//      matrices of all the clusters, one after the other.
+//
+
+ArrayXXd GaussianMixtureClusterer::getCovarianceMatrices()
+{
+    return covarianceMatrices;
+}
+
+
+
+
+
+
+
+
+
+
+
+// GaussianMixtureClusterer::getCholeskyFactorsOfCovarianceMatrices()
+//
+// PURPOSE: 
+//      Get the lower triangular Cholesky factors of the covariance matrices of the clusters 
+//      of the last Gaussian Mixture Model fitted.
+//
+// OUTPUT:
+//      An array of dimensions (Ndimensions, Ndimensions*Nclusters) containing the Cholesky
+//      factors of all the clusters, one after the other.
+//
+
+ArrayXXd GaussianMixtureClusterer::getCholeskyFactorsOfCovarianceMatrices()
+{
+    return choleskyFactorsOfCovarianceMatrices;
+}
+
+
+
+
+
+
+
+
+
+
+
+// GaussianMixtureClusterer::getLogDeterminantOfCovarianceMatrices()
+//
+// PURPOSE: 
+//      Get the natural logarithm of the determinant of the covariance matrices of the clusters 
+//      of the last Gaussian Mixture Model fitted.
+//
+// OUTPUT:
+//      An array of dimensions Nclusters containing the log-determinants.
+//
+
+ArrayXd GaussianMixtureClusterer::getLogDeterminantOfCovarianceMatrices()
+{
+    return logDeterminantOfCovarianceMatrices;
+}
+
+
+
+
+
+
+
+
+
+
+
+
+// GaussianMixtureClusterer::getInverseOfCovarianceMatrices()
+//
+// PURPOSE: 
+//      Get the inverse of the covariance matrices of the clusters of the last Gaussian Mixture Model fitted.
+//      The inverses are no longer used by the E-step, and are computed here from the Cholesky factors,
+//      as inverse(L*L^T) = inverse(L)^T * inverse(L).
+//
+// OUTPUT:
+//      An array of dimensions (Ndimensions, Ndimensions*Nclusters) containing the inverse covariance
+//      matrices of all the clusters, one after the other.
+//
+// REMARK:
+//      Deprecated. Kept for compatibility, use getCholeskyFactorsOfCovarianceMatrices() instead.
+//
+
+ArrayXXd GaussianMixtureClusterer::getInverseOfCovarianceMatrices()
+{
+    const int Nclusters = (Ndimensions > 0) ? choleskyFactorsOfCovarianceMatrices.cols() / Ndimensions : 0;
+    ArrayXXd inverseOfCovarianceMatrices(Ndimensions, Ndimensions*Nclusters);
+
+    for (int i = 0; i < Nclusters; i++)
+    {
+        MatrixXd inverseOfCholeskyFactor = MatrixXd::Identity(Ndimensions, Ndimensions);
+        choleskyFactorsOfCovarianceMatrices.block(0, i*Ndimensions, Ndimensions, Ndimensions).matrix()
+                .triangularView<Lower>().solveInPlace(inverseOfCholeskyFactor);
+
+        inverseOfCovarianceMatrices.block(0, i*Ndimensions, Ndimensions, Ndimensions) = 
+                (inverseOfCholeskyFactor.transpose() * inverseOfCholeskyFactor).array();
+    }
+
+    return inverseOfCovarianceMatrices;
+}
+
+
+
+
+
+
+
+
+
+
+
+// GaussianMixtureClusterer::getDeterminantOfCovarianceMatrices()
+//
+// PURPOSE: 
+//      Get the determinant of the covariance matrices of the clusters of the last Gaussian Mixture Model fitted.
+//
+// OUTPUT:
+//      An array of dimensions Nclusters containing the determinants.
+//
+// REMARK:
+//      Deprecated. Kept for compatibility, use getLogDeterminantOfCovarianceMatrices() instead,
+//      which does not underflow or overflow in a large number of dimensions.
+//
+
+ArrayXd GaussianMixtureClusterer::getDeterminantOfCovarianceMatrices()
+{
+    return logDeterminantOfCovarianceMatrices.exp();
+}
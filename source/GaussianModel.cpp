@@ -72,16 +72,15 @@ void GaussianModel::predict(RefArrayXd predictions, RefArrayXd const modelParame
 {
     // Define useful variables;
 
-    ArrayXd exponent,argument;
-    exponent.resize(predictions.size());
-    exponent.setZero();
-    argument.resize(predictions.size());
-    argument.setZero();
     double standardDeviation;
     double meanValue;
     double normalizationFactor = 1.0;
     
-    // Compute predictions using a loop over the different covariates
+
+    // Compute predictions using a loop over the different covariates. The exponent is
+    // cumulated directly in the predictions array, so that no temporary array is allocated.
+
+    predictions.setZero();
 
     for (int observable = 0; observable < Nobservables; ++observable)
     {
@@ -89,12 +88,10 @@ void GaussianModel::predict(RefArrayXd predictions, RefArrayXd const modelParame
         meanValue = modelParameters(observable*2);
         normalizationFactor *= 1.0/(sqrt(2.0*Functions::PI)*standardDeviation);
 
-        argument = covariates.segment(observable*Npoints, Npoints) - meanValue;
-        exponent += 1.0/pow(standardDeviation,2) * argument.pow(2);
+        predictions += 1.0/pow(standardDeviation,2) * (covariates.segment(observable*Npoints, Npoints) - meanValue).square();
     }
 
-    exponent *= -0.5;
-    predictions = normalizationFactor * exp(exponent);
+    predictions = normalizationFactor * exp(-0.5 * predictions);
 }
 
     
@@ -141,3 +138,48 @@ int GaussianModel::getNpoints()
 {
     return Npoints;
 }
+
+
+
+
+
+
+
+
+
+
+// GaussianModel::predictBlock()
+//
+// PURPOSE:
+//      Same as predict(), but only for the points begin, ..., begin + size - 1 of each covariate.
+//      Used by FusedLikelihood to evaluate the model one block at a time, while the block is in the cache.
+//
+// INPUT:
+//      predictions:        pointer to the size elements to contain the predictions
+//      begin:              index of the first point of the block
+//      size:               number of points of the block
+//      modelParameters:    one-dimensional array where each element
+//                          contains the value of a free parameter of the model
+//
+// OUTPUT:
+//      void
+//
+
+void GaussianModel::predictBlock(double *predictions, const int begin, const int size, const RefArrayXd modelParameters)
+{
+    Eigen::Map<ArrayXd> predictionsBlock(predictions, size);
+    double normalizationFactor = 1.0;
+
+    predictionsBlock.setZero();
+
+    for (int observable = 0; observable < Nobservables; ++observable)
+    {
+        double standardDeviation = modelParameters(observable*2 + 1);
+        double meanValue = modelParameters(observable*2);
+        normalizationFactor *= 1.0/(sqrt(2.0*Functions::PI)*standardDeviation);
+
+        predictionsBlock += 1.0/pow(standardDeviation,2) * (covariates.segment(observable*Npoints + begin, size) - meanValue).square();
+    }
+
+    predictionsBlock = normalizationFactor * exp(-0.5 * predictionsBlock);
+}
@@ -0,0 +1,435 @@
+#include "KdTree.h"
+
+
+// KdTree::KdTree()
+//
+// PURPOSE: 
+//      Constructor.
+//
+// INPUT:
+//      metric: the metric used to compute the distances between the points. The pruning of the
+//              tree assumes that the distance between two points is never smaller than the absolute
+//              difference of any of their coordinates, which holds for the Euclidean, Manhattan and 
+//              fractional distance metrics.
+//      maxNpointsPerLeaf: the maximum number of points contained in a leaf of the tree. 
+//                         The points of a leaf are compared to a query point by brute force.
+//
+
+KdTree::KdTree(Metric &metric, unsigned int maxNpointsPerLeaf)
+: metric(metric),
+  maxNpointsPerLeaf(maxNpointsPerLeaf),
+  Ndimensions(0),
+  Npoints(0),
+  maxNpointsInLeaves(0)
+{
+    assert(maxNpointsPerLeaf > 0);
+}
+
+
+
+
+
+
+
+
+
+// KdTree::build()
+//
+// PURPOSE: 
+//      Build the tree for a given sample of points. Each node is split at the median of the 
+//      coordinate along which its points have the largest spread, so that the depth of the tree
+//      is log2(Npoints/maxNpointsPerLeaf) and the building takes O(Npoints log Npoints) operations.
+//      A copy of the sample is stored in the tree. The queries do not modify the tree, hence 
+//      they can be performed in parallel.
+//
+// INPUT:
+//      sample(Ndimensions, Npoints): sample of N-dimensional points
+//
+// OUTPUT:
+//      void
+//
+
+void KdTree::build(RefArrayXXd sample)
+{
+    Ndimensions = sample.rows();
+    Npoints = sample.cols();
+
+    sortedIndices.resize(Npoints);
+
+    for (unsigned int n = 0; n < Npoints; ++n)
+    {
+        sortedIndices[n] = n;
+    }
+
+    nodes.clear();
+    nodes.reserve(2 * (Npoints / maxNpointsPerLeaf + 1));
+
+    if (Npoints > 0)
+    {
+        buildNode(sample, 0, Npoints);
+    }
+
+
+    // Store the points in the order of the tree, so that the points of each leaf 
+    // are contiguous in memory and can be compared to a query point in a single batch
+
+    sortedPoints.resize(Ndimensions, Npoints);
+
+    for (unsigned int n = 0; n < Npoints; ++n)
+    {
+        sortedPoints.col(n) = sample.col(sortedIndices[n]);
+    }
+
+
+    // Leaves of coinciding points can be larger than maxNpointsPerLeaf
+
+    maxNpointsInLeaves = 0;
+
+    for (size_t i = 0; i < nodes.size(); ++i)
+    {
+        if (nodes[i].splitDimension < 0)
+        {
+            maxNpointsInLeaves = max(maxNpointsInLeaves, nodes[i].last - nodes[i].first);
+        }
+    }
+}
+
+
+
+
+
+
+
+
+
+// KdTree::buildNode()
+//
+// PURPOSE: 
+//      Recursively build the node containing the points between positions first and last 
+//      of sortedIndices, and all its descendants.
+//
+// INPUT:
+//      sample(Ndimensions, Npoints): sample of N-dimensional points
+//      first: first position in sortedIndices of the points of the node
+//      last: position past the last point of the node in sortedIndices
+//
+// OUTPUT:
+//      The index of the node in the vector of nodes
+//
+
+int KdTree::buildNode(RefArrayXXd sample, const int first, const int last)
+{
+    int nodeIndex = nodes.size();
+    Node node;
+    node.first = first;
+    node.last = last;
+    node.splitDimension = -1;
+    node.splitValue = 0.0;
+    node.leftChild = -1;
+    node.rightChild = -1;
+    nodes.push_back(node);
+
+    if (last - first <= static_cast<int>(maxNpointsPerLeaf))
+    {
+        // The node is a leaf
+
+        return nodeIndex;
+    }
+
+
+    // Find the coordinate along which the points of the node have the largest spread
+
+    ArrayXd minCoordinates = sample.col(sortedIndices[first]);
+    ArrayXd maxCoordinates = minCoordinates;
+
+    for (int n = first + 1; n < last; ++n)
+    {
+        minCoordinates = minCoordinates.min(sample.col(sortedIndices[n]));
+        maxCoordinates = maxCoordinates.max(sample.col(sortedIndices[n]));
+    }
+
+    int splitDimension;
+    double largestSpread = (maxCoordinates - minCoordinates).maxCoeff(&splitDimension);
+
+    if (largestSpread == 0.0)
+    {
+        // All the points of the node coincide, hence they cannot be split any further
+
+        return nodeIndex;
+    }
+
+
+    // Split the points at the median of the selected coordinate
+
+    int middle = first + (last - first) / 2;
+
+    nth_element(sortedIndices.begin() + first, sortedIndices.begin() + middle, sortedIndices.begin() + last,
+                [&sample, splitDimension](int i, int j) {return sample(splitDimension, i) < sample(splitDimension, j);});
+
+    nodes[nodeIndex].splitDimension = splitDimension;
+    nodes[nodeIndex].splitValue = sample(splitDimension, sortedIndices[middle]);
+
+    int leftChild = buildNode(sample, first, middle);
+    int rightChild = buildNode(sample, middle, last);
+    nodes[nodeIndex].leftChild = leftChild;
+    nodes[nodeIndex].rightChild = rightChild;
+
+    return nodeIndex;
+}
+
+
+
+
+
+
+
+
+
+// KdTree::radiusSearch()
+//
+// PURPOSE: 
+//      Find all the points of the tree within a given distance from a query point.
+//
+// INPUT:
+//      point(Ndimensions): coordinates of the query point
+//      radius: the maximum distance of the neighbours (inclusive)
+//      neighbourIndices: on output, the indices (in the sample used to build the tree) of the points 
+//                        within the given distance, in no particular order. The query point itself 
+//                        is included if it is part of the tree.
+//
+// OUTPUT:
+//      void
+//
+
+void KdTree::radiusSearch(RefArrayXd point, const double radius, vector<int> &neighbourIndices)
+{
+    neighbourIndices.clear();
+
+    if (Npoints > 0)
+    {
+        ArrayXd leafDistances(maxNpointsInLeaves);
+        radiusSearchInNode(0, point, radius, neighbourIndices, leafDistances);
+    }
+}
+
+
+
+
+
+
+
+
+
+// KdTree::radiusSearchInNode()
+//
+// PURPOSE: 
+//      Recursively collect the points within a given distance from a query point in a node
+//      and its descendants. A child is only visited if the splitting hyperplane is closer 
+//      to the query point than the search radius.
+//
+// INPUT:
+//      nodeIndex: index of the node to search
+//      point(Ndimensions): coordinates of the query point
+//      radius: the maximum distance of the neighbours (inclusive)
+//      neighbourIndices: the indices of the neighbours found so far
+//      leafDistances: working space for the distances of the points of a leaf
+//
+// OUTPUT:
+//      void
+//
+
+void KdTree::radiusSearchInNode(const int nodeIndex, RefArrayXd point, const double radius, vector<int> &neighbourIndices,
+                                ArrayXd &leafDistances)
+{
+    const Node &node = nodes[nodeIndex];
+
+    if (node.splitDimension < 0)
+    {
+        int NpointsInLeaf = node.last - node.first;
+
+        metric.pointToCentersDistances(point, sortedPoints.middleCols(node.first, NpointsInLeaf), leafDistances.head(NpointsInLeaf));
+
+        for (int n = 0; n < NpointsInLeaf; ++n)
+        {
+            if (leafDistances(n) <= radius)
+            {
+                neighbourIndices.push_back(sortedIndices[node.first + n]);
+            }
+        }
+
+        return;
+    }
+
+    double gap = point(node.splitDimension) - node.splitValue;
+
+    if (gap <= radius)
+    {
+        radiusSearchInNode(node.leftChild, point, radius, neighbourIndices, leafDistances);
+    }
+
+    if (-gap <= radius)
+    {
+        radiusSearchInNode(node.rightChild, point, radius, neighbourIndices, leafDistances);
+    }
+}
+
+
+
+
+
+
+
+
+
+// KdTree::nearestNeighbours()
+//
+// PURPOSE: 
+//      Find the Nneighbours points of the tree that are closest to a query point.
+//
+// INPUT:
+//      point(Ndimensions): coordinates of the query point
+//      Nneighbours: the number of neighbours to find
+//      neighbourIndices: on output, the indices (in the sample used to build the tree) of the 
+//                        nearest neighbours, sorted by increasing distance. The query point itself 
+//                        is included if it is part of the tree.
+//      neighbourDistances: on output, the distances of the nearest neighbours to the query point
+//
+// OUTPUT:
+//      void
+//
+
+void KdTree::nearestNeighbours(RefArrayXd point, const int Nneighbours, vector<int> &neighbourIndices, 
+                               vector<double> &neighbourDistances)
+{
+    // Keep the nearest points found so far in a max-heap, so that the farthest of them
+    // is always on top and can be replaced by a closer point
+
+    priority_queue<pair<double, int> > nearestPoints;
+
+    if ((Npoints > 0) && (Nneighbours > 0))
+    {
+        ArrayXd leafDistances(maxNpointsInLeaves);
+        nearestNeighboursInNode(0, point, Nneighbours, nearestPoints, leafDistances);
+    }
+
+    int Nfound = nearestPoints.size();
+    neighbourIndices.resize(Nfound);
+    neighbourDistances.resize(Nfound);
+
+    for (int n = Nfound-1; n >= 0; --n)
+    {
+        neighbourDistances[n] = nearestPoints.top().first;
+        neighbourIndices[n] = nearestPoints.top().second;
+        nearestPoints.pop();
+    }
+}
+
+
+
+
+
+
+
+
+
+// KdTree::nearestNeighboursInNode()
+//
+// PURPOSE: 
+//      Recursively update the nearest neighbours of a query point with the points of a node
+//      and its descendants. The child on the same side of the splitting hyperplane as the query
+//      point is visited first. The other child is only visited if the hyperplane is closer to 
+//      the query point than the farthest neighbour found so far.
+//
+// INPUT:
+//      nodeIndex: index of the node to search
+//      point(Ndimensions): coordinates of the query point
+//      Nneighbours: the number of neighbours to find
+//      nearestPoints: max-heap of the (distance, index) pairs of the nearest points found so far
+//      leafDistances: working space for the distances of the points of a leaf
+//
+// OUTPUT:
+//      void
+//
+
+void KdTree::nearestNeighboursInNode(const int nodeIndex, RefArrayXd point, const int Nneighbours, 
+                                     priority_queue<pair<double, int> > &nearestPoints, ArrayXd &leafDistances)
+{
+    const Node &node = nodes[nodeIndex];
+
+    if (node.splitDimension < 0)
+    {
+        int NpointsInLeaf = node.last - node.first;
+
+        metric.pointToCentersDistances(point, sortedPoints.middleCols(node.first, NpointsInLeaf), leafDistances.head(NpointsInLeaf));
+
+        for (int n = 0; n < NpointsInLeaf; ++n)
+        {
+            if (static_cast<int>(nearestPoints.size()) < Nneighbours)
+            {
+                nearestPoints.push(make_pair(leafDistances(n), sortedIndices[node.first + n]));
+            }
+            else if (leafDistances(n) < nearestPoints.top().first)
+            {
+                nearestPoints.pop();
+                nearestPoints.push(make_pair(leafDistances(n), sortedIndices[node.first + n]));
+            }
+        }
+
+        return;
+    }
+
+    double gap = point(node.splitDimension) - node.splitValue;
+    int nearChild = (gap <= 0.0 ? node.leftChild : node.rightChild);
+    int farChild = (gap <= 0.0 ? node.rightChild : node.leftChild);
+
+    nearestNeighboursInNode(nearChild, point, Nneighbours, nearestPoints, leafDistances);
+
+    if ((static_cast<int>(nearestPoints.size()) < Nneighbours) || (fabs(gap) <= nearestPoints.top().first))
+    {
+        nearestNeighboursInNode(farChild, point, Nneighbours, nearestPoints, leafDistances);
+    }
+}
+
+
+
+
+
+
+
+
+
+// KdTree::getNpoints()
+//
+// PURPOSE: 
+//      Get the number of points stored in the tree.
+//
+// OUTPUT:
+//      The number of points
+//
+
+unsigned int KdTree::getNpoints()
+{
+    return Npoints;
+}
+
+
+
+
+
+
+
+
+
+// KdTree::getNdimensions()
+//
+// PURPOSE: 
+//      Get the dimensionality of the points stored in the tree.
+//
+// OUTPUT:
+//      The number of dimensions
+//
+
+unsigned int KdTree::getNdimensions()
+{
+    return Ndimensions;
+}
@@ -17,15 +17,35 @@
 //               repeat k-means with different trials of initial centers, and pick the best one.
 //      relTolerance: fitting the clusters converged when S < relTolerance, where S is the relative 
 //                    change in total sum of distances of all points to their cluster center. 
+//      warmStartActivated: a boolean to allow clusterWithWarmStart() to refine the previous partition
+//                          instead of performing a full search over the range of number of clusters
+//      maxRelativeBICdegradation: a warm-started partition is rejected if its BIC value per point is larger 
+//                                 than the one of the last full search by more than this relative amount
+//      maxNconsecutiveWarmStarts: maximum number of consecutive warm starts after which a full search 
+//                                 is performed anyway, so that new clusters can still be detected
+//      hierarchicalSplittingActivated: a boolean to determine the number of clusters with the X-means algorithm, 
+//                                      i.e. by splitting the clusters in two as long as the BIC value improves,
+//                                      instead of running k-means for each number of clusters between 
+//                                      minNclusters and maxNclusters
 // 
 
 KmeansClusterer::KmeansClusterer(Metric &metric, Projector &featureProjector, bool featureProjectionActivated, 
-unsigned int minNclusters, unsigned int maxNclusters, unsigned int Ntrials, double relTolerance)
+unsigned int minNclusters, unsigned int maxNclusters, unsigned int Ntrials, double relTolerance,
+bool warmStartActivated, double maxRelativeBICdegradation, unsigned int maxNconsecutiveWarmStarts,
+bool hierarchicalSplittingActivated)
 : Clusterer(metric, featureProjector, featureProjectionActivated), 
   minNclusters(minNclusters), 
   maxNclusters(maxNclusters), 
   Ntrials(Ntrials), 
-  relTolerance(relTolerance)
+  relTolerance(relTolerance),
+  warmStartActivated(warmStartActivated),
+  previousPartitionIsAvailable(false),
+  maxNconsecutiveWarmStarts(maxNconsecutiveWarmStarts),
+  NconsecutiveWarmStarts(0),
+  previousNdimensions(0),
+  maxRelativeBICdegradation(maxRelativeBICdegradation),
+  previousBICvaluePerPoint(numeric_limits<double>::max()),
+  hierarchicalSplittingActivated(hierarchicalSplittingActivated)
 {
     // Set the seed of the random generator using the clock
 
@@ -97,80 +117,51 @@ void KmeansClusterer::chooseInitialClusterCenters(RefArrayXXd sample, RefArrayXX
 
     int randomPointIndex = uniform(engine);
     int k;
-    double distanceToClosestCenter[Npoints];
-    double sumOfDistancesToClosestCenters;
-    double distance;
+    ArrayXd distanceToClosestCenter(Npoints);
+    ArrayXd distanceToNewCenter(Npoints);
     double uniform01Number;
     double cumulativeDistance;
     centers.col(0) = sample.col(randomPointIndex);
 
+
+    // For each of the points in the sample, determine the distance to the first center.
+    // All the distances are computed in a single call to the metric.
+
+    metric.pointToCentersDistances(centers.col(0), sample, distanceToClosestCenter);
+
     
     // Select the other initial centers probabilistically 
 
     for (int n = 1; n < Nclusters; ++n)
     {
-        // For each of the points in the sample, determine the distance to
-        // its closest center 
-    
-        sumOfDistancesToClosestCenters = 0.0;
-    
-        for (int k = 0; k < Npoints; ++k)
-        {
-            for (int j = 0; j < n; ++j)
-            {
-                distance = metric.distance(sample.col(k), centers.col(j));
-                if (j == 0)
-                {
-                    // This is the very first center we're checking, so let's adopt
-                    // this initially as the closest center. 
-                
-                    distanceToClosestCenter[k] = distance;
-                }
-                else
-                {
-                    // Compare with the previous distance to the closest center.
-                    // If it is even smaller, we've found an even closer center.
-                    // In that case, keep the distance value.
-                
-                    if (distance < distanceToClosestCenter[k])
-                    {
-                        distanceToClosestCenter[k] = distance;
-                    }
-                }
-            }
-        
-            sumOfDistancesToClosestCenters += distanceToClosestCenter[k];
-        } 
-    
-
-        // Normalize the distances
-    
-        for (int k = 0; k < Npoints; ++k)
-        { 
-            distanceToClosestCenter[k] /= sumOfDistancesToClosestCenters;
-        }
-    
-
-        // Generate a uniform random number between 0 and 1
+        // Generate a uniform random number between 0 and the sum of the distances 
+        // to the closest center, so that the distances need not be normalized.
     
-        uniform01Number = uniform01(engine);
+        uniform01Number = uniform01(engine) * distanceToClosestCenter.sum();
     
 
         // Select the point that makes the cumulative distance greater than the random
         // number. Those points with a larger distance to their closest center, will have 
         // a greater chance to be chosen as the next cluster center point, than the others.
         
-        cumulativeDistance = distanceToClosestCenter[0];
+        cumulativeDistance = distanceToClosestCenter(0);
         k = 0;
         
-        while (cumulativeDistance < uniform01Number)
+        while ((cumulativeDistance < uniform01Number) && (k < Npoints-1))
         {
             k++;
-            cumulativeDistance += distanceToClosestCenter[k];
+            cumulativeDistance += distanceToClosestCenter(k);
         }
 
         centers.col(n) = sample.col(k);
 
+
+        // Only the distances to the new center have to be computed to update the distances 
+        // of the points to their closest center
+
+        metric.pointToCentersDistances(centers.col(n), sample, distanceToNewCenter);
+        distanceToClosestCenter = distanceToClosestCenter.min(distanceToNewCenter);
+
     } // end loop of selecting initial cluster centers
 }
 
@@ -223,11 +214,11 @@ bool KmeansClusterer::updateClusterCentersUntilConverged(RefArrayXXd sample, Ref
     
     bool stopIterations = false;
     bool convergenceReached;
-    unsigned int indexOfClosestCenter;
+    Index indexOfClosestCenter;
     double oldSumOfDistances = 0.0;
     double newSumOfDistances = 0.0;
-    double distanceToClosestCenter;
-    double distance; 
+    double reducedDistanceToClosestCenter;
+    ArrayXXd reducedDistancesToCenters(Npoints, Nclusters);
 
     while (!stopIterations)
     {
@@ -237,23 +228,18 @@ bool KmeansClusterer::updateClusterCentersUntilConverged(RefArrayXXd sample, Ref
     
         clusterSizes.setZero();
         updatedCenters.setZero();
+
+
+        // Only the ordering of the distances matters to find the closest center, hence 
+        // compute all of them at once in their reduced (cheaper) form.
+
+        metric.pairwiseDistances(sample, centers, reducedDistancesToCenters, true);
     
         for (int n = 0; n < Npoints; ++n)
         {
-            distanceToClosestCenter = numeric_limits<double>::max();
+            reducedDistanceToClosestCenter = reducedDistancesToCenters.row(n).minCoeff(&indexOfClosestCenter);
         
-            for (int i = 0; i < Nclusters; ++i)
-            {
-                distance = metric.distance(sample.col(n), centers.col(i));
-                
-                if (distance < distanceToClosestCenter)
-                {
-                    indexOfClosestCenter = i;
-                    distanceToClosestCenter = distance;
-                }
-            }
-        
-            newSumOfDistances += distanceToClosestCenter;
+            newSumOfDistances += metric.reducedDistanceToDistance(reducedDistanceToClosestCenter);
             updatedCenters.col(indexOfClosestCenter) += sample.col(n);
             clusterSizes(indexOfClosestCenter) += 1; 
             clusterIndices[n] = indexOfClosestCenter;        
@@ -346,22 +332,31 @@ bool KmeansClusterer::updateClusterCentersUntilConverged(RefArrayXXd sample, Ref
 // OUTPUT:
 //      BIC value: - 2 ln(L) + k ln(N) up to constant terms
 //
+// REMARK:
+//      The likelihood of spherical Gaussians depends on the squared Euclidean distances
+//      of the points to their center, whatever the metric used to assign the points.
+//
 
 double KmeansClusterer::evaluateBICvalue(RefArrayXXd sample, RefArrayXXd centers, 
                                          RefArrayXd clusterSizes, vector<int> &clusterIndices)
 {
     // Compute the intra-cluster variance for each cluster, assuming that each cluster 
-    // is spherical, making it a one-dimensional problem.
-    
+    // is spherical, making it a one-dimensional problem. Only the squared distance of 
+    // each point to its own center is needed, hence it is computed directly.
+
+    ArrayXd distanceToOwnCenter(Npoints);
     ArrayXd intraClusterVariances(Nclusters);
     intraClusterVariances.setZero();
-    
+
     for (int n = 0; n < Npoints; ++n)
     {
-        intraClusterVariances(clusterIndices[n]) += metric.distance(sample.col(n), centers.col(clusterIndices[n]));
+        distanceToOwnCenter(n) = (sample.col(n) - centers.col(clusterIndices[n])).matrix().squaredNorm();
+        intraClusterVariances(clusterIndices[n]) += distanceToOwnCenter(n);
     }
     
-    intraClusterVariances /= (clusterSizes-1);
+    // The variance of a spherical Gaussian is the same along each of the Ndimensions coordinates
+
+    intraClusterVariances /= double(Ndimensions) * (clusterSizes-1);
     
 
     // Initialize the cluster priors, i.e. the prior probability that a point belongs 
@@ -382,7 +377,7 @@ double KmeansClusterer::evaluateBICvalue(RefArrayXXd sample, RefArrayXXd centers
         cluster = clusterIndices[n]; 
         logLikelihood +=   log(clusterPriors(cluster))
                          - Ndimensions / 2.0 * log(intraClusterVariances(cluster))
-                         - metric.distance(sample.col(n), centers.col(cluster)) / 2.0 / intraClusterVariances(cluster);
+                         - distanceToOwnCenter(n) / 2.0 / intraClusterVariances(cluster);
     } 
     
     
@@ -414,6 +409,237 @@ double KmeansClusterer::evaluateBICvalue(RefArrayXXd sample, RefArrayXXd centers
 
 
 
+// KmeansClusterer::findBestClustering()
+//
+// PURPOSE: 
+//      Run the k-means algorithm Ntrials times with different initial centers, for the 
+//      current number of clusters Nclusters, and keep the clustering with the smallest 
+//      sum of distances of the points to their cluster center.
+//
+// INPUT:
+//      sample(Ndimensions, Npoints): sample of N-dimensional points
+//      bestCenters(Ndimensions, Nclusters): on output, the centers of the best clustering
+//      bestClusterSizes(Nclusters): on output, the number of points of each cluster of the best clustering
+//      bestClusterIndices(Npoints): on output, for each point the index of the cluster it belongs to
+// 
+// OUTPUT:
+//      True if at least one of the trials converged successfully, false otherwise.
+//
+
+bool KmeansClusterer::findBestClustering(RefArrayXXd sample, ArrayXXd &bestCenters, ArrayXd &bestClusterSizes, 
+                                         vector<int> &bestClusterIndices)
+{
+    ArrayXXd centers = ArrayXXd::Zero(Ndimensions, Nclusters);
+    ArrayXd clusterSizes = ArrayXd::Zero(Nclusters);
+    vector<int> clusterIndices(Npoints);
+    double sumOfDistancesToClosestCenter;
+    double bestSumOfDistancesToClosestCenter = numeric_limits<double>::max();
+
+    for (int m = 0; m < Ntrials; ++m)
+    {
+        chooseInitialClusterCenters(sample, centers);
+
+        if (!updateClusterCentersUntilConverged(sample, centers, clusterSizes, clusterIndices, 
+                                                sumOfDistancesToClosestCenter, relTolerance)) continue;
+
+        if (sumOfDistancesToClosestCenter < bestSumOfDistancesToClosestCenter)
+        {
+            bestSumOfDistancesToClosestCenter = sumOfDistancesToClosestCenter;
+            bestCenters = centers;
+            bestClusterIndices = clusterIndices;
+            bestClusterSizes = clusterSizes;  
+        }
+    }
+
+    return (bestSumOfDistancesToClosestCenter < numeric_limits<double>::max());
+}
+
+
+
+
+
+
+
+
+
+
+
+
+// KmeansClusterer::splitClustersHierarchically()
+//
+// PURPOSE: 
+//      Determine the number of clusters with the X-means algorithm (Pelleg & Moore 2000).
+//      Starting from the best k-means clustering with minNclusters clusters, each cluster is 
+//      split in two with a local 2-means on its own points, and the split is kept only if 
+//      the BIC value of the two children is lower than the one of the parent cluster alone.
+//      Both are computed with evaluateBICvalue() on the points of the parent, i.e. with the same
+//      criterion used to compare the partitions of the whole sample.
+//      The accepted splits (those with the largest BIC improvement first, up to maxNclusters
+//      clusters) are refined with k-means on the whole sample. The new partition is kept only 
+//      if it also lowers the BIC value of the whole sample, so that a split accepted locally
+//      cannot be rejected by the global model selection. The procedure is repeated until no 
+//      cluster can be split anymore. As each split decision only involves the points
+//      of one cluster, the cost is O(Npoints log Nclusters) instead of running k-means for 
+//      every number of clusters in the range.
+//
+// INPUT:
+//      sample(Ndimensions, Npoints): sample of N-dimensional points
+//      optimalClusterIndices(Npoints): on output, for each point the index of the cluster it belongs to. 
+//      optimalClusterSizes(Nclusters): on output, the number of points of each cluster
+//      optimalBICvalue: on output, the BIC value of the final partition of the whole sample
+// 
+// OUTPUT:
+//      True if a partition was found, false if no k-means clustering with minNclusters
+//      clusters converged successfully.
+//
+
+bool KmeansClusterer::splitClustersHierarchically(RefArrayXXd sample, vector<int> &optimalClusterIndices, 
+                                                  vector<int> &optimalClusterSizes, double &optimalBICvalue)
+{
+    // Start from the best partition with the minimum number of clusters
+
+    unsigned int NpointsOfSample = Npoints;
+    Nclusters = minNclusters;
+
+    ArrayXXd centers;
+    ArrayXd clusterSizes;
+    vector<int> clusterIndices(Npoints);
+
+    if (!findBestClustering(sample, centers, clusterSizes, clusterIndices))
+    {
+        return false;
+    }
+
+    double BICvalue = evaluateBICvalue(sample, centers, clusterSizes, clusterIndices);
+
+    while (Nclusters < maxNclusters)
+    {
+        // Try to split each of the clusters in two, using only the points of that cluster
+
+        unsigned int NclustersOfSample = Nclusters;
+        vector<pair<double, int> > BICimprovements;
+        vector<ArrayXXd> childCenters(NclustersOfSample);
+
+        for (int c = 0; c < NclustersOfSample; ++c)
+        {
+            // Each of the two children needs at least Ndimensions+1 points, the minimum to build an ellipsoid
+
+            if (clusterSizes(c) < 2 * (Ndimensions + 1)) continue;
+
+            ArrayXXd clusterSample(Ndimensions, int(clusterSizes(c)));
+            int m = 0;
+
+            for (int n = 0; n < NpointsOfSample; ++n)
+            {
+                if (clusterIndices[n] == c) clusterSample.col(m++) = sample.col(n);
+            }
+
+            Npoints = clusterSample.cols();
+
+
+            // BIC value of the parent cluster alone
+
+            Nclusters = 1;
+            ArrayXXd parentCenter = centers.col(c);
+            ArrayXd parentSize = ArrayXd::Constant(1, Npoints);
+            vector<int> parentIndices(Npoints, 0);
+            double parentBICvalue = evaluateBICvalue(clusterSample, parentCenter, parentSize, parentIndices);
+
+
+            // BIC value of the best split of the cluster in two
+
+            Nclusters = 2;
+            ArrayXd childSizes;
+            vector<int> childIndices;
+
+            if (findBestClustering(clusterSample, childCenters[c], childSizes, childIndices) && (childSizes > Ndimensions).all())
+            {
+                double childBICvalue = evaluateBICvalue(clusterSample, childCenters[c], childSizes, childIndices);
+
+                if (std::isfinite(childBICvalue) && (childBICvalue < parentBICvalue))
+                {
+                    BICimprovements.push_back(make_pair(parentBICvalue - childBICvalue, c));
+                }
+            }
+        }
+
+        Npoints = NpointsOfSample;
+        Nclusters = NclustersOfSample;
+
+        if (BICimprovements.empty()) break;
+
+
+        // Replace the parents by their two children, starting from the largest BIC improvement,
+        // without exceeding the maximum number of clusters
+
+        sort(BICimprovements.rbegin(), BICimprovements.rend());
+        int Nsplits = min(int(BICimprovements.size()), int(maxNclusters - NclustersOfSample));
+        ArrayXXd splitCenters(Ndimensions, NclustersOfSample + Nsplits);
+        splitCenters.leftCols(NclustersOfSample) = centers;
+
+        for (int k = 0; k < Nsplits; ++k)
+        {
+            int c = BICimprovements[k].second;
+            splitCenters.col(c) = childCenters[c].col(0);
+            splitCenters.col(NclustersOfSample + k) = childCenters[c].col(1);
+        }
+
+
+        // Refine the new partition on the whole sample. If a cluster becomes too small, or if
+        // the BIC value of the whole sample did not decrease, keep the partition from before the splits.
+
+        Nclusters = NclustersOfSample + Nsplits;
+        ArrayXd splitClusterSizes(Nclusters);
+        vector<int> splitClusterIndices(Npoints);
+        double sumOfDistancesToClosestCenter;
+
+        if (!updateClusterCentersUntilConverged(sample, splitCenters, splitClusterSizes, splitClusterIndices, 
+                                                sumOfDistancesToClosestCenter, relTolerance) || (splitClusterSizes <= Ndimensions).any())
+        {
+            Nclusters = NclustersOfSample;
+            break;
+        }
+
+        double splitBICvalue = evaluateBICvalue(sample, splitCenters, splitClusterSizes, splitClusterIndices);
+
+        if (!(splitBICvalue < BICvalue))
+        {
+            Nclusters = NclustersOfSample;
+            break;
+        }
+
+        BICvalue = splitBICvalue;
+        centers = splitCenters;
+        clusterSizes = splitClusterSizes;
+        clusterIndices = splitClusterIndices;
+    }
+
+
+    // Store the final partition
+
+    optimalBICvalue = BICvalue;
+    optimalClusterIndices = clusterIndices;
+    optimalClusterSizes.resize(Nclusters);
+
+    for (int n = 0; n < Nclusters; ++n)
+    {
+        optimalClusterSizes[n] = clusterSizes(n);
+    }
+
+    return true;
+}
+
+
+
+
+
+
+
+
+
+
+
+
 // KmeansClusterer::cluster()
 //
 // PURPOSE: 
@@ -432,9 +658,6 @@ double KmeansClusterer::evaluateBICvalue(RefArrayXXd sample, RefArrayXXd centers
 
 int KmeansClusterer::cluster(RefArrayXXd sample, vector<int> &optimalClusterIndices, vector<int> &optimalClusterSizes)
 {
-    bool convergedSuccessfully;
-    Npoints = sample.cols();
-    
     ArrayXXd optimizedSample;
 
     // If activated, apply a dimensionality reduction of the data sample according to the chosen feature projector (e.g. PCA)
@@ -452,22 +675,69 @@ int KmeansClusterer::cluster(RefArrayXXd sample, vector<int> &optimalClusterIndi
     {
         optimizedSample = sample;
     }
-    
+
+    return clusterProjectedSample(optimizedSample, optimalClusterIndices, optimalClusterSizes);
+}
+
+
+
+
+
+
+
+
+
+
+
+
+// KmeansClusterer::clusterProjectedSample()
+//
+// PURPOSE: 
+//      Search the optimal number of clusters of a sample to which the feature projection, if activated, 
+//      was already applied. This is the search done by cluster(), which is also used by clusterWithWarmStart()
+//      when the warm start is rejected, so that the same sample is never projected twice.
+//
+// INPUT:
+//      optimizedSample(Ndimensions, Npoints): sample of (projected) N-dimensional points
+//      optimalClusterIndices(Npoints): for each point the index of the cluster it belongs to. This index
+//                                      runs from 0 to Nclusters-1.
+//      optimalClusterSizes(Nclusters): for each of the clusters, this vector contains the number of points
+// 
+// OUTPUT:
+//      The optimal number of clusters
+//
+
+int KmeansClusterer::clusterProjectedSample(RefArrayXXd optimizedSample, vector<int> &optimalClusterIndices, 
+                                            vector<int> &optimalClusterSizes)
+{
+    bool convergedSuccessfully;
+    Npoints = optimizedSample.cols();
     Ndimensions = optimizedSample.rows();
 
     unsigned int optimalNclusters;    
     double bestBICvalue = numeric_limits<double>::max();
+    double optimalBICvalue = numeric_limits<double>::max();
     double BICvalue; 
-    double sumOfDistancesToClosestCenter;
-    double bestSumOfDistancesToClosestCenter = numeric_limits<double>::max();
-    vector<int> clusterIndices(Npoints);                    // For each point the index of the cluster to ...
-    vector<int> bestClusterIndices(Npoints);                // ... which it belongs
-    ArrayXd clusterSizes;                                   // Not vector<int> because will be used in Eigen array expressions
-    ArrayXd bestClusterSizes;
-    ArrayXXd centers;
+    vector<int> bestClusterIndices(Npoints);                // For each point the index of the cluster to which it belongs
+    ArrayXd bestClusterSizes;                               // Not vector<int> because will be used in Eigen array expressions
     ArrayXXd bestCenters;
     
 
+    // In the X-means mode, the number of clusters is found by splitting the clusters hierarchically.
+    // The sweep over the range of number of clusters below is only needed if this failed.
+
+    if (hierarchicalSplittingActivated && 
+        splitClustersHierarchically(optimizedSample, optimalClusterIndices, optimalClusterSizes, optimalBICvalue))
+    {
+        previousPartitionIsAvailable = std::isfinite(optimalBICvalue);
+        previousNdimensions = Ndimensions;
+        NconsecutiveWarmStarts = 0;
+        previousBICvaluePerPoint = optimalBICvalue / Npoints;
+
+        return Nclusters;
+    }
+
+
     // As we don't know a prior the optimal number of clusters, loop over a
     // user-specified range of clusters, and determine which number gives the
     // optimal clustering
@@ -476,43 +746,14 @@ int KmeansClusterer::cluster(RefArrayXXd sample, vector<int> &optimalClusterIndi
     {
         Nclusters = c;
 
-        centers = ArrayXXd::Zero(Ndimensions, Nclusters);          // coordinates of each of the old cluster centers
         bestCenters = ArrayXXd::Zero(Ndimensions, Nclusters);      // coordinates of the best centers (over all trials)
-        clusterSizes = ArrayXd::Zero(Nclusters);                    // # of points belonging to each cluster...
-        bestClusterSizes = ArrayXd::Zero(Nclusters);                // ... 'double', to avoid casting problems.               
+        bestClusterSizes = ArrayXd::Zero(Nclusters);                // # of points belonging to each cluster, 'double' to avoid casting problems.
        
 
         // The k-means algorithm is sensitive to the choice of the initial centers. 
         // We therefore run the algorithm 'Ntrial' times, and take the best clustering.
         
-        bestSumOfDistancesToClosestCenter = numeric_limits<double>::max();
-        
-                    
-        for (int m = 0; m < Ntrials; ++m)
-        {
-            chooseInitialClusterCenters(optimizedSample, centers);
-            convergedSuccessfully = updateClusterCentersUntilConverged(optimizedSample, centers, clusterSizes, clusterIndices, 
-                                                                       sumOfDistancesToClosestCenter, relTolerance);
-   
-
-            // If the convergence was not successfull (e.g. because some clusters contain 0 or 1 points),
-            // we likely had an unfortunate set of initial cluster centers. In this case, simply continue
-            // with the next 'trial'.
-            
-            if (!convergedSuccessfully) continue;
-   
-
-            // If we did obtain a successful convergence, compare it with the previous clusterings 
-            // (all of them with the same number of clusters), and keep the best one.
-            
-            if (sumOfDistancesToClosestCenter < bestSumOfDistancesToClosestCenter)
-            {
-                bestSumOfDistancesToClosestCenter = sumOfDistancesToClosestCenter;
-                bestCenters = centers;
-                bestClusterIndices = clusterIndices;
-                bestClusterSizes = clusterSizes;  
-            }               
-        } // end loop over Ntrials to determine the best clustering trying different initial centers
+        convergedSuccessfully = findBestClustering(optimizedSample, bestCenters, bestClusterSizes, bestClusterIndices);
        
 
         // Evaluate the current number of clusters, using the BIC value. Note that this is only necessary 
@@ -530,6 +771,7 @@ int KmeansClusterer::cluster(RefArrayXXd sample, vector<int> &optimalClusterIndi
                 // values for the number of clusters.
                 
                 bestBICvalue = BICvalue;
+                optimalBICvalue = BICvalue;
                 optimalNclusters = Nclusters;
                 optimalClusterIndices = bestClusterIndices;
                 optimalClusterSizes.resize(Nclusters);
@@ -551,13 +793,167 @@ int KmeansClusterer::cluster(RefArrayXXd sample, vector<int> &optimalClusterIndi
             {
                 optimalClusterSizes[n] = bestClusterSizes(n);
             }
+
+            if (warmStartActivated && convergedSuccessfully)
+            {
+                optimalBICvalue = evaluateBICvalue(optimizedSample, bestCenters, bestClusterSizes, bestClusterIndices);
+            }
         }
         
           
     } // end loop over Nclusters
     
+
+    // Keep track of the quality of the partition, so that it can be used as a reference
+    // by the next warm-started clustering
+
+    previousPartitionIsAvailable = (optimalBICvalue < numeric_limits<double>::max()) && std::isfinite(optimalBICvalue);
+    previousNdimensions = Ndimensions;
+    NconsecutiveWarmStarts = 0;
+    previousBICvaluePerPoint = optimalBICvalue / Npoints;
+    
     // That's it!
 
     return optimalNclusters;
 }
 
+
+
+
+
+
+
+
+
+
+
+
+// KmeansClusterer::clusterWithWarmStart()
+//
+// PURPOSE: 
+//      Given a sample of N-dimensional points and the partition found at the previous clustering, 
+//      refine the partition with a few k-means iterations, using the barycenters of the previous 
+//      clusters (as evaluated on the current sample) as initial centers. Since only a small fraction 
+//      of the points has changed since the previous clustering, this is usually much cheaper than a 
+//      full search over all numbers of clusters and all trials. 
+//      The full search of cluster() is performed instead if the warm start is not activated, if
+//      no previous partition is available, after maxNconsecutiveWarmStarts consecutive warm starts 
+//      (a refinement cannot change the number of clusters), or if the refined partition fails a quality check,
+//      i.e. if a cluster ends up with less than 2 points or if the BIC value per point became worse 
+//      than the one of the last full search by more than maxRelativeBICdegradation.
+//
+// INPUT:
+//      sample(Ndimensions, Npoints): sample of N-dimensional points
+//      clusterIndices(Npoints): on input, for each point the index of the cluster it belonged to in 
+//                               the previous partition. On output, the updated cluster indices.
+//      clusterSizes(Nclusters): on input, the sizes of the clusters of the previous partition.
+//                               On output, the updated cluster sizes.
+// 
+// OUTPUT:
+//      The number of clusters found
+//
+
+int KmeansClusterer::clusterWithWarmStart(RefArrayXXd sample, vector<int> &clusterIndices, vector<int> &clusterSizes)
+{
+    // Check whether a warm start is possible at all
+
+    bool warmStartIsPossible = warmStartActivated && previousPartitionIsAvailable
+                               && (NconsecutiveWarmStarts < maxNconsecutiveWarmStarts)
+                               && (clusterIndices.size() == static_cast<size_t>(sample.cols()))
+                               && (clusterSizes.size() >= minNclusters) && (clusterSizes.size() <= maxNclusters);
+
+    if (!warmStartIsPossible)
+    {
+        clusterSizes.clear();
+        return cluster(sample, clusterIndices, clusterSizes);
+    }
+
+    Npoints = sample.cols();
+    Nclusters = clusterSizes.size();
+
+    ArrayXXd optimizedSample;
+
+    if (featureProjectionActivated)
+    {
+        optimizedSample = featureProjector.projection(sample);
+    }
+    else
+    {
+        optimizedSample = sample;
+    }
+
+    Ndimensions = optimizedSample.rows();
+
+
+    // If the projected sample changed dimensionality, the previous partition is no longer a good reference
+
+    if (Ndimensions != previousNdimensions)
+    {
+        clusterSizes.clear();
+        return clusterProjectedSample(optimizedSample, clusterIndices, clusterSizes);
+    }
+
+
+    // Compute the barycenters of the previous clusters using the current sample. These are the initial centers.
+
+    ArrayXXd centers = ArrayXXd::Zero(Ndimensions, Nclusters);
+    ArrayXd updatedClusterSizes = ArrayXd::Zero(Nclusters);
+
+    for (int n = 0; n < Npoints; ++n)
+    {
+        centers.col(clusterIndices[n]) += optimizedSample.col(n);
+        updatedClusterSizes(clusterIndices[n]) += 1;
+    }
+
+    bool warmStartIsSuccessful = (updatedClusterSizes > 1).all();
+
+    vector<int> updatedClusterIndices(Npoints);
+    double sumOfDistancesToClosestCenter;
+    double BICvaluePerPoint = numeric_limits<double>::max();
+
+    if (warmStartIsSuccessful)
+    {
+        centers.rowwise() /= updatedClusterSizes.transpose();
+
+
+        // Refine the partition with the k-means iterations. Clusters that become (nearly) empty 
+        // make the convergence fail.
+
+        warmStartIsSuccessful = updateClusterCentersUntilConverged(optimizedSample, centers, updatedClusterSizes, updatedClusterIndices, 
+                                                                   sumOfDistancesToClosestCenter, relTolerance);
+    }
+
+    if (warmStartIsSuccessful)
+    {
+        // Check that the quality of the partition did not degrade significantly with respect to the one
+        // of the last full search, so that the degradations of consecutive warm starts cannot add up
+
+        BICvaluePerPoint = evaluateBICvalue(optimizedSample, centers, updatedClusterSizes, updatedClusterIndices) / Npoints;
+        warmStartIsSuccessful = std::isfinite(BICvaluePerPoint) && 
+                                (BICvaluePerPoint <= previousBICvaluePerPoint + maxRelativeBICdegradation * fabs(previousBICvaluePerPoint));
+    }
+
+    if (!warmStartIsSuccessful)
+    {
+        // The warm start failed the quality check, hence do a full search over the range of number of clusters
+
+        clusterSizes.clear();
+        return clusterProjectedSample(optimizedSample, clusterIndices, clusterSizes);
+    }
+
+
+    // The refined partition is accepted
+
+    clusterIndices = updatedClusterIndices;
+    clusterSizes.resize(Nclusters);
+
+    for (int n = 0; n < Nclusters; ++n)
+    {
+        clusterSizes[n] = updatedClusterSizes(n);
+    }
+
+    NconsecutiveWarmStarts++;
+
+    return Nclusters;
+}
+
@@ -65,3 +65,34 @@ ArrayXd Likelihood::getObservations()
 
 
 
+
+
+
+
+
+
+// Likelihood::logValue()
+//
+// PURPOSE:
+//      Computes the natural logarithm of the likelihood using the scratch arrays of a workspace,
+//      so that no memory is allocated at each call. This is the version called in the 
+//      innermost loops of the nested sampling. The derived classes of the library override it, 
+//      and compute the version without workspace through the workspace of the calling thread.
+//
+// INPUT:
+//      modelParameters:    a one-dimensional array containing the actual
+//                          values of the free parameters that describe the model.
+//      workspace:          the workspace of the calling thread
+//
+// OUTPUT:
+//      a double number containing the natural logarithm of the likelihood
+//
+// REMARK:
+//      The default implementation ignores the workspace and calls the version without it,
+//      so that likelihoods deriving from this class only need to implement the latter.
+//
+
+double Likelihood::logValue(RefArrayXd const modelParameters, EvaluationWorkspace &workspace)
+{
+    return logValue(modelParameters);
+}
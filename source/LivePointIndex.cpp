@@ -0,0 +1,469 @@
+#include "LivePointIndex.h"
+
+
+// LivePointIndex::LivePointIndex()
+//
+// PURPOSE: 
+//      Constructor.
+//
+// INPUT:
+//      metric: the metric used to compute the distances between the points
+//      maxRelativeNupdates: the number of updates (replaced or removed live points) accumulated
+//                           since the last build, relative to the number of live points, above 
+//                           which the k-d tree is rebuilt. Until then, the updated points are kept 
+//                           in a small buffer that is searched by brute force, and the points of 
+//                           the tree that are no longer live points are skipped.
+//      maxNpointsPerLeaf: the maximum number of points contained in a leaf of the k-d tree
+//
+
+LivePointIndex::LivePointIndex(Metric &metric, double maxRelativeNupdates, unsigned int maxNpointsPerLeaf)
+: metric(metric),
+  tree(metric, maxNpointsPerLeaf),
+  maxRelativeNupdates(maxRelativeNupdates),
+  Npoints(0),
+  NupdatesSinceLastBuild(0),
+  NdeletedTreePoints(0),
+  Nbuilds(0)
+{
+    assert(maxRelativeNupdates >= 0.0);
+}
+
+
+
+
+
+
+
+
+
+// LivePointIndex::build()
+//
+// PURPOSE: 
+//      Build the index from scratch for a given set of live points. This takes 
+//      O(Npoints log Npoints) operations.
+//
+// INPUT:
+//      livePoints(Ndimensions, Npoints): the coordinates of the live points
+//
+// OUTPUT:
+//      void
+//
+
+void LivePointIndex::build(RefArrayXXd livePoints)
+{
+    assert(livePoints.cols() > 0);
+
+    this->livePoints = livePoints;
+    Npoints = livePoints.cols();
+
+    tree.build(this->livePoints);
+    ++Nbuilds;
+
+    livePointIndexOfTreePoint.resize(Npoints);
+    treePointIndexOfLivePoint.resize(Npoints);
+
+    for (int n = 0; n < Npoints; ++n)
+    {
+        livePointIndexOfTreePoint[n] = n;
+        treePointIndexOfLivePoint[n] = n;
+    }
+
+    bufferedLivePoints.clear();
+
+    if (bufferedPoints.rows() != livePoints.rows())
+    {
+        bufferedPoints.resize(livePoints.rows(), 0);
+    }
+    NupdatesSinceLastBuild = 0;
+    NdeletedTreePoints = 0;
+}
+
+
+
+
+
+
+
+
+
+// LivePointIndex::rebuildIfNeeded()
+//
+// PURPOSE: 
+//      Rebuild the k-d tree from the current live points when too many updates have 
+//      accumulated since the last build. Rebuilding every maxRelativeNupdates*Npoints updates
+//      keeps the amortized cost of an update at O(log Npoints), while the overhead of the 
+//      queries due to the buffered and deleted points stays a small fraction of their cost.
+//
+// OUTPUT:
+//      void
+//
+
+void LivePointIndex::rebuildIfNeeded()
+{
+    if ((NupdatesSinceLastBuild > maxRelativeNupdates * Npoints) && (Npoints > 0))
+    {
+        ArrayXXd currentLivePoints = livePoints;
+        build(currentLivePoints);
+    }
+}
+
+
+
+
+
+
+
+
+
+// LivePointIndex::deletePoint()
+//
+// PURPOSE: 
+//      Remove a live point from the tree or from the buffer of inserted points, 
+//      without changing the indices of the other live points.
+//
+// INPUT:
+//      livePointIndex: the index of the live point to delete
+//
+// OUTPUT:
+//      void
+//
+
+void LivePointIndex::deletePoint(const int livePointIndex)
+{
+    int treePointIndex = treePointIndexOfLivePoint[livePointIndex];
+
+    if (treePointIndex >= 0)
+    {
+        livePointIndexOfTreePoint[treePointIndex] = -1;
+        ++NdeletedTreePoints;
+    }
+    else
+    {
+        // Move the last buffered point to the position of the deleted one
+
+        int bufferPosition = find(bufferedLivePoints.begin(), bufferedLivePoints.end(), livePointIndex) - bufferedLivePoints.begin();
+        int lastBufferPosition = bufferedLivePoints.size() - 1;
+        bufferedLivePoints[bufferPosition] = bufferedLivePoints[lastBufferPosition];
+        bufferedPoints.col(bufferPosition) = bufferedPoints.col(lastBufferPosition);
+        bufferedLivePoints.pop_back();
+    }
+
+    treePointIndexOfLivePoint[livePointIndex] = -1;
+}
+
+
+
+
+
+
+
+
+
+// LivePointIndex::replacePoint()
+//
+// PURPOSE: 
+//      Replace the coordinates of a live point, as done for the live point with 
+//      the worst likelihood at each iteration of the nesting process.
+//
+// INPUT:
+//      livePointIndex: the index of the live point to replace
+//      newPoint(Ndimensions): the coordinates of the new live point
+//
+// OUTPUT:
+//      void
+//
+
+void LivePointIndex::replacePoint(const int livePointIndex, RefArrayXd newPoint)
+{
+    assert((livePointIndex >= 0) && (livePointIndex < Npoints));
+
+    deletePoint(livePointIndex);
+    livePoints.col(livePointIndex) = newPoint;
+
+
+    // Store the new point in the buffer, whose capacity is doubled when full
+
+    int Nbuffered = bufferedLivePoints.size();
+
+    if (Nbuffered == bufferedPoints.cols())
+    {
+        bufferedPoints.conservativeResize(livePoints.rows(), max(2 * Nbuffered, 16));
+    }
+
+    bufferedPoints.col(Nbuffered) = newPoint;
+    bufferedLivePoints.push_back(livePointIndex);
+
+    ++NupdatesSinceLastBuild;
+    rebuildIfNeeded();
+}
+
+
+
+
+
+
+
+
+
+// LivePointIndex::removePoint()
+//
+// PURPOSE: 
+//      Remove a live point from the index. As in NestedSampler::removeLivePointsFromSample(),
+//      the last live point takes the index of the removed one, so that the indices of the
+//      live points remain contiguous.
+//
+// INPUT:
+//      livePointIndex: the index of the live point to remove
+//
+// OUTPUT:
+//      void
+//
+
+void LivePointIndex::removePoint(const int livePointIndex)
+{
+    assert((livePointIndex >= 0) && (livePointIndex < Npoints));
+
+    int lastLivePointIndex = Npoints-1;
+
+    deletePoint(livePointIndex);
+
+
+    // Move the last live point to the position of the removed one
+
+    if (livePointIndex != lastLivePointIndex)
+    {
+        livePoints.col(livePointIndex) = livePoints.col(lastLivePointIndex);
+        int treePointIndex = treePointIndexOfLivePoint[lastLivePointIndex];
+        treePointIndexOfLivePoint[livePointIndex] = treePointIndex;
+
+        if (treePointIndex >= 0)
+        {
+            livePointIndexOfTreePoint[treePointIndex] = livePointIndex;
+        }
+        else
+        {
+            *find(bufferedLivePoints.begin(), bufferedLivePoints.end(), lastLivePointIndex) = livePointIndex;
+        }
+    }
+
+    treePointIndexOfLivePoint.pop_back();
+    livePoints.conservativeResize(NoChange, lastLivePointIndex);
+    --Npoints;
+
+    ++NupdatesSinceLastBuild;
+    rebuildIfNeeded();
+}
+
+
+
+
+
+
+
+
+
+// LivePointIndex::radiusSearch()
+//
+// PURPOSE: 
+//      Find all the live points within a given distance from a query point.
+//
+// INPUT:
+//      point(Ndimensions): coordinates of the query point
+//      radius: the maximum distance of the neighbours (inclusive)
+//      neighbourIndices: on output, the indices of the live points within the given distance, 
+//                        in no particular order
+//
+// OUTPUT:
+//      void
+//
+
+void LivePointIndex::radiusSearch(RefArrayXd point, const double radius, vector<int> &neighbourIndices)
+{
+    tree.radiusSearch(point, radius, neighbourIndices);
+
+
+    // Convert the indices of the tree into live point indices, skipping the deleted points
+
+    int Nneighbours = 0;
+
+    for (size_t k = 0; k < neighbourIndices.size(); ++k)
+    {
+        int livePointIndex = livePointIndexOfTreePoint[neighbourIndices[k]];
+
+        if (livePointIndex >= 0)
+        {
+            neighbourIndices[Nneighbours++] = livePointIndex;
+        }
+    }
+
+    neighbourIndices.resize(Nneighbours);
+
+
+    // Add the points inserted since the last build
+
+    int Nbuffered = bufferedLivePoints.size();
+
+    if (Nbuffered > 0)
+    {
+        ArrayXd bufferedDistances(Nbuffered);
+        metric.pointToCentersDistances(point, bufferedPoints.leftCols(Nbuffered), bufferedDistances);
+
+        for (int k = 0; k < Nbuffered; ++k)
+        {
+            if (bufferedDistances(k) <= radius)
+            {
+                neighbourIndices.push_back(bufferedLivePoints[k]);
+            }
+        }
+    }
+}
+
+
+
+
+
+
+
+
+
+// LivePointIndex::nearestNeighbours()
+//
+// PURPOSE: 
+//      Find the live points closest to a query point.
+//
+// INPUT:
+//      point(Ndimensions): coordinates of the query point
+//      Nneighbours: the number of nearest neighbours to find
+//      neighbourIndices: on output, the indices of the nearest live points, sorted by increasing distance
+//      neighbourDistances: on output, the distances of the nearest live points to the query point
+//
+// OUTPUT:
+//      void
+//
+
+void LivePointIndex::nearestNeighbours(RefArrayXd point, const int Nneighbours, vector<int> &neighbourIndices, 
+                                       vector<double> &neighbourDistances)
+{
+    assert(Nneighbours > 0);
+
+
+    // Query the tree for more neighbours until Nneighbours of them are live points, 
+    // or all the points of the tree have been retrieved
+
+    int NtreePoints = livePointIndexOfTreePoint.size();
+    int NtreeNeighbours = min(Nneighbours, NtreePoints);
+    int Nbuffered = bufferedLivePoints.size();
+    vector<pair<double, int> > candidates;
+
+    while (true)
+    {
+        tree.nearestNeighbours(point, NtreeNeighbours, neighbourIndices, neighbourDistances);
+        candidates.clear();
+
+        for (size_t k = 0; k < neighbourIndices.size(); ++k)
+        {
+            int livePointIndex = livePointIndexOfTreePoint[neighbourIndices[k]];
+
+            if (livePointIndex >= 0)
+            {
+                candidates.push_back(make_pair(neighbourDistances[k], livePointIndex));
+            }
+        }
+
+        if ((static_cast<int>(candidates.size()) >= Nneighbours) || (NtreeNeighbours == NtreePoints)) break;
+
+        NtreeNeighbours = min(2 * NtreeNeighbours, NtreePoints);
+    }
+
+
+    // Add the points inserted since the last build, and keep the closest ones
+
+    if (Nbuffered > 0)
+    {
+        ArrayXd bufferedDistances(Nbuffered);
+        metric.pointToCentersDistances(point, bufferedPoints.leftCols(Nbuffered), bufferedDistances);
+
+        for (int k = 0; k < Nbuffered; ++k)
+        {
+            candidates.push_back(make_pair(bufferedDistances(k), bufferedLivePoints[k]));
+        }
+    }
+
+    int Nfound = min(Nneighbours, int(candidates.size()));
+    partial_sort(candidates.begin(), candidates.begin() + Nfound, candidates.end());
+
+    neighbourIndices.resize(Nfound);
+    neighbourDistances.resize(Nfound);
+
+    for (int k = 0; k < Nfound; ++k)
+    {
+        neighbourDistances[k] = candidates[k].first;
+        neighbourIndices[k] = candidates[k].second;
+    }
+}
+
+
+
+
+
+
+
+
+
+// LivePointIndex::getNpoints()
+//
+// PURPOSE: 
+//      Get the current number of live points in the index.
+//
+// OUTPUT:
+//      An integer containing the number of live points
+//
+
+int LivePointIndex::getNpoints()
+{
+    return Npoints;
+}
+
+
+
+
+
+
+
+
+
+// LivePointIndex::getNupdatesSinceLastBuild()
+//
+// PURPOSE: 
+//      Get the number of updates accumulated since the last (re)build of the k-d tree.
+//
+// OUTPUT:
+//      An integer containing the number of updates
+//
+
+int LivePointIndex::getNupdatesSinceLastBuild()
+{
+    return NupdatesSinceLastBuild;
+}
+
+
+
+
+
+
+
+
+
+// LivePointIndex::getNbuilds()
+//
+// PURPOSE: 
+//      Get the number of times the k-d tree has been (re)built.
+//
+// OUTPUT:
+//      An integer containing the number of builds
+//
+
+int LivePointIndex::getNbuilds()
+{
+    return Nbuilds;
+}
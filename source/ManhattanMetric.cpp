@@ -5,3 +5,64 @@ double ManhattanMetric::distance(RefArrayXd point1, RefArrayXd point2)
 {
     return (point1-point2).abs().sum();
 }
+
+
+
+
+
+
+
+
+
+// ManhattanMetric::pointToCentersDistances()
+//
+// PURPOSE:
+//      Compute the Manhattan distances between one point and a set of centers.
+//      The Manhattan distance needs no reduction, hence the reduced distance is the distance itself.
+//
+// INPUT:
+//      point(Ndimensions): coordinates of the point
+//      centers(Ndimensions, Ncenters): coordinates of the centers
+//      distances(Ncenters): on output, the distance between the point and each center
+//      reduced: not used
+//
+// OUTPUT:
+//      void
+//
+
+void ManhattanMetric::pointToCentersDistances(RefArrayXd point, RefArrayXXd centers, RefArrayXd distances, bool reduced)
+{
+    distances = (centers.colwise() - point).abs().colwise().sum().transpose();
+}
+
+
+
+
+
+
+
+
+
+// ManhattanMetric::pairwiseDistances()
+//
+// PURPOSE:
+//      Compute the matrix of Manhattan distances between two samples of points.
+//
+// INPUT:
+//      sample1(Ndimensions, Npoints1): coordinates of the first sample of points
+//      sample2(Ndimensions, Npoints2): coordinates of the second sample of points
+//      distances(Npoints1, Npoints2): on output, the distance between each point of sample1 (rows)
+//                                     and each point of sample2 (columns)
+//      reduced: not used
+//
+// OUTPUT:
+//      void
+//
+
+void ManhattanMetric::pairwiseDistances(RefArrayXXd sample1, RefArrayXXd sample2, RefArrayXXd distances, bool reduced)
+{
+    for (int j = 0; j < sample2.cols(); ++j)
+    {
+        distances.col(j) = (sample1.colwise() - sample2.col(j)).abs().colwise().sum().transpose();
+    }
+}
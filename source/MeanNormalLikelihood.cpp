@@ -19,11 +19,14 @@ MeanNormalLikelihood::MeanNormalLikelihood(const RefArrayXd observations, const
 {
     double normalizeFactor;
     
-    assert(observations.size() != uncertainties.size());
+    assert(observations.size() == uncertainties.size());
     normalizeFactor = sqrt(observations.size()/uncertainties.pow(-2).sum());
     normalizedUncertainties = uncertainties/normalizeFactor; 
     weights = normalizedUncertainties.pow(-2);
 
+    unsigned long n = observations.size();
+    logNormalization = lgammal(n/2.) - log(2) - (n/2.)*log(Functions::PI) + 0.5*weights.log().sum();
+
 } // END MeanNormalLikelihood::MeanNormalLikelihood()
 
 
@@ -94,23 +97,43 @@ ArrayXd MeanNormalLikelihood::getNormalizedUncertainties()
 //
 
 double MeanNormalLikelihood::logValue(RefArrayXd modelParameters)
+{
+    return logValue(modelParameters, EvaluationWorkspace::getThreadWorkspace());
+}
+
+
+
+
+
+
+
+
+
+// MeanNormalLikelihood::logValue()
+//
+// PURPOSE:
+//      Same as above, using the arrays of a workspace, so that no memory is allocated.
+//      The normalization term, which only depends on the weights, is computed by the constructor.
+//
+// INPUT:
+//      modelParameters: a one-dimensional array containing the actual
+//      values of the free parameters that describe the model.
+//      workspace: the workspace of the calling thread.
+//
+// OUTPUT:
+//      a double number containing the natural logarithm of the
+//      mean likelihood
+//
+
+double MeanNormalLikelihood::logValue(RefArrayXd modelParameters, EvaluationWorkspace &workspace)
 {
     unsigned long n = observations.size();
-    double lambda0;
-    double lambda;
-    ArrayXd argument;
-    ArrayXd predictions;
+    ArrayXd &predictions = workspace.getPredictions(n);
 
-    predictions.resize(n);
     predictions.setZero();
-    model.predict(predictions, modelParameters);
-    argument = (observations - predictions);
-    argument = argument.square()*weights;
-
-    lambda0 = lgammal(n/2.) - log(2) - (n/2.)*log(Functions::PI) + 0.5*weights.log().sum();
-    lambda = lambda0 - (n/2.)*log(argument.sum());
+    model.predict(predictions, modelParameters, workspace);
 
-    return lambda;
+    return logNormalization - (n/2.)*log(((observations - predictions).square()*weights).sum());
 }
 
 
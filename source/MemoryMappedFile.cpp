@@ -0,0 +1,155 @@
+#include "MemoryMappedFile.h"
+
+
+// MemoryMappedFile::MemoryMappedFile()
+//
+// PURPOSE:
+//      Constructor. Opens the input file and maps its whole content in memory
+//      for reading. The program is stopped if the file cannot be opened or mapped.
+//
+// INPUT:
+//      fileName:   full path of the file to map
+//
+
+MemoryMappedFile::MemoryMappedFile(const string fileName)
+: fileName(fileName),
+  fileDescriptor(-1),
+  data(NULL),
+  size(0)
+{
+    fileDescriptor = open(fileName.c_str(), O_RDONLY);
+
+    if (fileDescriptor < 0)
+    {
+        cerr << "Error opening input file " << fileName << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    struct stat fileStatus;
+
+    if (fstat(fileDescriptor, &fileStatus) != 0)
+    {
+        cerr << "Error reading the size of input file " << fileName << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    size = fileStatus.st_size;
+
+
+    // An empty file cannot be mapped, but it is still a valid file with no content
+
+    if (size > 0)
+    {
+        void *mappedRegion = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+
+        if (mappedRegion == MAP_FAILED)
+        {
+            cerr << "Error mapping input file " << fileName << " in memory" << endl;
+            exit(EXIT_FAILURE);
+        }
+
+        data = static_cast<char*>(mappedRegion);
+
+
+        // The file is mostly read from the beginning to the end
+
+        madvise(mappedRegion, size, MADV_SEQUENTIAL);
+    }
+}
+
+
+
+
+
+
+
+
+
+
+// MemoryMappedFile::~MemoryMappedFile()
+//
+// PURPOSE:
+//      Destructor. Unmaps the file and closes it.
+//
+
+MemoryMappedFile::~MemoryMappedFile()
+{
+    if (data != NULL)
+    {
+        munmap(data, size);
+    }
+
+    if (fileDescriptor >= 0)
+    {
+        close(fileDescriptor);
+    }
+}
+
+
+
+
+
+
+
+
+
+
+// MemoryMappedFile::getData()
+//
+// PURPOSE:
+//      Gets the beginning of the mapped content of the file.
+//
+// OUTPUT:
+//      A pointer to the first byte of the file, NULL if the file is empty.
+//
+
+const char *MemoryMappedFile::getData()
+{
+    return data;
+}
+
+
+
+
+
+
+
+
+
+
+// MemoryMappedFile::getSize()
+//
+// PURPOSE:
+//      Gets the size of the mapped file.
+//
+// OUTPUT:
+//      The number of bytes of the file.
+//
+
+size_t MemoryMappedFile::getSize()
+{
+    return size;
+}
+
+
+
+
+
+
+
+
+
+
+// MemoryMappedFile::getFileName()
+//
+// PURPOSE:
+//      Gets the full path of the mapped file.
+//
+// OUTPUT:
+//      A string containing the full path of the file.
+//
+
+string MemoryMappedFile::getFileName()
+{
+    return fileName;
+}
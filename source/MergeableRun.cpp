@@ -0,0 +1,375 @@
+#include "MergeableRun.h"
+
+
+// MergeableRun::MergeableRun()
+//
+// PURPOSE:
+//      Base constructor. The derived classes set the sizes of the run, and then
+//      call start() to load the first point of the sample.
+//
+// INPUT:
+//      runName:    name of the run, used in the error messages
+//
+
+MergeableRun::MergeableRun(const string runName)
+: runName(runName),
+  Ndimensions(0),
+  Nsamples(0),
+  NlivePoints(0),
+  NfinalLivePoints(0),
+  Nconsumed(0),
+  currentLogLikelihood(0.0),
+  currentNlivePoints(0)
+{
+
+}
+
+
+
+
+
+
+
+
+
+
+// MergeableRun::getRunName()
+//
+// PURPOSE:
+//      Gets the name of the run.
+//
+// OUTPUT:
+//      A string containing the name of the run.
+//
+
+string MergeableRun::getRunName()
+{
+    return runName;
+}
+
+
+
+
+
+
+
+
+
+
+// MergeableRun::getNdimensions()
+//
+// PURPOSE:
+//      Gets the number of free parameters of the run.
+//
+// OUTPUT:
+//      An integer containing the number of dimensions.
+//
+
+int MergeableRun::getNdimensions()
+{
+    return Ndimensions;
+}
+
+
+
+
+
+
+
+
+
+
+// MergeableRun::getNsamples()
+//
+// PURPOSE:
+//      Gets the total number of points of the posterior sample of the run.
+//
+// OUTPUT:
+//      An integer containing the number of points, including the final live points.
+//
+
+long MergeableRun::getNsamples()
+{
+    return Nsamples;
+}
+
+
+
+
+
+
+
+
+
+
+// MergeableRun::getNlivePoints()
+//
+// PURPOSE:
+//      Gets the initial number of live points of the nesting process.
+//
+// OUTPUT:
+//      An integer containing the initial number of live points.
+//
+
+int MergeableRun::getNlivePoints()
+{
+    return NlivePoints;
+}
+
+
+
+
+
+
+
+
+
+
+// MergeableRun::getNfinalLivePoints()
+//
+// PURPOSE:
+//      Gets the number of live points left at the end of the nesting process,
+//      which are appended at the end of the posterior sample.
+//
+// OUTPUT:
+//      An integer containing the number of final live points.
+//
+
+int MergeableRun::getNfinalLivePoints()
+{
+    return NfinalLivePoints;
+}
+
+
+
+
+
+
+
+
+
+
+// MergeableRun::getCurrentNlivePoints()
+//
+// PURPOSE:
+//      Gets the number of live points of the run at the likelihood level of its current point.
+//      This is the number of live points stored by the nesting process at the iteration of each 
+//      dead point, while for the final live points it decreases by one at each point, down to one 
+//      for the last point.
+//
+// OUTPUT:
+//      An integer containing the number of live points, zero if the run is exhausted.
+//
+
+int MergeableRun::getCurrentNlivePoints()
+{
+    long NremainingSamples = Nsamples - Nconsumed;
+
+    if (NremainingSamples > NfinalLivePoints)
+        return currentNlivePoints;
+    else
+        return NremainingSamples;
+}
+
+
+
+
+
+
+
+
+
+
+// MergeableRun::isExhausted()
+//
+// PURPOSE:
+//      Checks whether all the points of the run have been taken.
+//
+// OUTPUT:
+//      True if there are no points left, false otherwise.
+//
+
+bool MergeableRun::isExhausted()
+{
+    return (Nconsumed >= Nsamples);
+}
+
+
+
+
+
+
+
+
+
+
+// MergeableRun::getLogLikelihood()
+//
+// PURPOSE:
+//      Gets the log(Likelihood) of the current point of the run.
+//
+// OUTPUT:
+//      A double containing the log(Likelihood) value.
+//
+
+double MergeableRun::getLogLikelihood()
+{
+    return currentLogLikelihood;
+}
+
+
+
+
+
+
+
+
+
+
+// MergeableRun::getParameters()
+//
+// PURPOSE:
+//      Gets the parameter values of the current point of the run.
+//
+// OUTPUT:
+//      A pointer to Ndimensions values, valid until the next call to next().
+//
+
+const double *MergeableRun::getParameters()
+{
+    return currentParameters.data();
+}
+
+
+
+
+
+
+
+
+
+
+// MergeableRun::next()
+//
+// PURPOSE:
+//      Moves to the next point of the run, in order of increasing likelihood.
+//
+// OUTPUT:
+//      void
+//
+
+void MergeableRun::next()
+{
+    Nconsumed++;
+    loadCurrentSample();
+}
+
+
+
+
+
+
+
+
+
+
+// MergeableRun::start()
+//
+// PURPOSE:
+//      Loads the first point of the run. Called by the derived constructors once the
+//      sizes of the run are known and its input is ready to be read.
+//
+// OUTPUT:
+//      void
+//
+
+void MergeableRun::start()
+{
+    if (NfinalLivePoints > Nsamples || NfinalLivePoints < 0 || NlivePoints < 1)
+    {
+        cerr << "Error: inconsistent numbers of live points in run " << runName << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    currentParameters.resize(Ndimensions);
+    Nconsumed = 0;
+    loadCurrentSample();
+}
+
+
+
+
+
+
+
+
+
+
+// MergeableRun::loadCurrentSample()
+//
+// PURPOSE:
+//      Loads the point with index Nconsumed in order of increasing likelihood. The dead points
+//      are read one at a time, together with their number of live points, while the final live points 
+//      are read all together when the first of them is reached, and then sorted.
+//
+// OUTPUT:
+//      void
+//
+// REMARK:
+//      The program is stopped if the dead points are not sorted by increasing likelihood,
+//      which means that the input is not the posterior sample of a single nested sampling run,
+//      or if a dead point has no live points.
+//
+
+void MergeableRun::loadCurrentSample()
+{
+    if (Nconsumed >= Nsamples)
+        return;
+
+    long NdeadPoints = Nsamples - NfinalLivePoints;
+
+    if (Nconsumed < NdeadPoints)
+    {
+        double previousLogLikelihood = currentLogLikelihood;
+        readNextSample(currentLogLikelihood, currentParameters.data());
+        currentNlivePoints = readNextNlivePoints();
+
+        if (Nconsumed > 0 && currentLogLikelihood < previousLogLikelihood)
+        {
+            cerr << "Error: the points of run " << runName << " are not sorted by increasing likelihood" << endl;
+            exit(EXIT_FAILURE);
+        }
+
+        if (currentNlivePoints < 1)
+        {
+            cerr << "Error: invalid number of live points " << currentNlivePoints << " in run " << runName << endl;
+            exit(EXIT_FAILURE);
+        }
+
+        return;
+    }
+
+    if (Nconsumed == NdeadPoints)
+    {
+        finalLiveSample.resize(Ndimensions, NfinalLivePoints);
+        finalLiveLogLikelihood.resize(NfinalLivePoints);
+
+        for (int i = 0; i < NfinalLivePoints; ++i)
+        {
+            readNextSample(finalLiveLogLikelihood(i), finalLiveSample.col(i).data());
+        }
+
+        finalLiveOrder.resize(NfinalLivePoints);
+
+        for (int i = 0; i < NfinalLivePoints; ++i)
+            finalLiveOrder[i] = i;
+
+        const ArrayXd &logLikelihood = finalLiveLogLikelihood;
+        stable_sort(finalLiveOrder.begin(), finalLiveOrder.end(),
+                    [&logLikelihood](int i, int j) { return logLikelihood(i) < logLikelihood(j); });
+    }
+
+    int index = finalLiveOrder[Nconsumed - NdeadPoints];
+    currentLogLikelihood = finalLiveLogLikelihood(index);
+    copy(finalLiveSample.col(index).data(), finalLiveSample.col(index).data() + Ndimensions, currentParameters.begin());
+}
@@ -0,0 +1,93 @@
+#include "Metric.h"
+
+
+// Metric::pointToCentersDistances()
+//
+// PURPOSE:
+//      Compute the distances between one point and a set of points (e.g. cluster centers)
+//      in a single call. This default implementation simply loops over distance(), derived
+//      classes can override it with a specialized vectorized kernel.
+//
+// INPUT:
+//      point(Ndimensions): coordinates of the point
+//      centers(Ndimensions, Ncenters): coordinates of the set of points
+//      distances(Ncenters): on output, the distance between the point and each of the centers
+//      reduced: if true, return the reduced distances instead, i.e. a cheaper monotonic function 
+//               of the distances that can be used when only their ordering matters 
+//               (e.g. the squared distance for the Euclidean metric). 
+//               Use reducedDistanceToDistance() to convert them back.
+//
+// OUTPUT:
+//      void
+//
+
+void Metric::pointToCentersDistances(RefArrayXd point, RefArrayXXd centers, RefArrayXd distances, bool reduced)
+{
+    for (int i = 0; i < centers.cols(); ++i)
+    {
+        distances(i) = distance(point, centers.col(i));
+    }
+}
+
+
+
+
+
+
+
+
+
+// Metric::pairwiseDistances()
+//
+// PURPOSE:
+//      Compute the matrix of distances between all the points of a first sample and
+//      all the points of a second sample. This default implementation simply loops over 
+//      distance(), derived classes can override it with a specialized vectorized kernel.
+//
+// INPUT:
+//      sample1(Ndimensions, Npoints1): coordinates of the first sample of points
+//      sample2(Ndimensions, Npoints2): coordinates of the second sample of points
+//      distances(Npoints1, Npoints2): on output, the distance between each point of sample1 (rows)
+//                                     and each point of sample2 (columns)
+//      reduced: if true, return the reduced distances instead (see pointToCentersDistances())
+//
+// OUTPUT:
+//      void
+//
+
+void Metric::pairwiseDistances(RefArrayXXd sample1, RefArrayXXd sample2, RefArrayXXd distances, bool reduced)
+{
+    for (int j = 0; j < sample2.cols(); ++j)
+    {
+        for (int i = 0; i < sample1.cols(); ++i)
+        {
+            distances(i, j) = distance(sample1.col(i), sample2.col(j));
+        }
+    }
+}
+
+
+
+
+
+
+
+
+
+// Metric::reducedDistanceToDistance()
+//
+// PURPOSE:
+//      Convert a reduced distance as returned by pointToCentersDistances() or pairwiseDistances()
+//      into the actual distance. By default the reduced distance is the distance itself.
+//
+// INPUT:
+//      reducedDistance: the reduced distance
+//
+// OUTPUT:
+//      The corresponding distance
+//
+
+double Metric::reducedDistanceToDistance(double reducedDistance)
+{
+    return reducedDistance;
+}
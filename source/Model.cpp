@@ -81,3 +81,37 @@ int Model::getNparameters()
 {
     return Nparameters;
 }
+
+
+
+
+
+
+
+
+
+// Model::predict()
+//
+// PURPOSE:
+//      Builds the predictions of the model using the scratch arrays of a workspace, 
+//      so that no memory is allocated at each call.
+//
+// INPUT:
+//      predictions:        one-dimensional array to contain the predictions from the model
+//      modelParameters:    one-dimensional array where each element
+//                          contains the value of a free parameter of the model
+//      workspace:          the workspace of the calling thread. Only its model arrays may be used,
+//                          since the predictions array may belong to the same workspace.
+//
+// OUTPUT:
+//      void
+//
+// REMARK:
+//      The default implementation ignores the workspace and calls the version without it,
+//      which is enough for models that need no scratch arrays.
+//
+
+void Model::predict(RefArrayXd predictions, const RefArrayXd modelParameters, EvaluationWorkspace &workspace)
+{
+    predict(predictions, modelParameters);
+}
@@ -129,6 +129,7 @@ bool MultiEllipsoidSampler::drawWithConstraint(const RefArrayXXd totalSample, co
     }
 
     double sumOfHyperVolumes = accumulate(normalizedHyperVolumes.begin(), normalizedHyperVolumes.end(), 0.0, plus<double>());
+    logBoundingVolumeOfLastDraw = log(sumOfHyperVolumes);
 
     for (int n=0; n < Nellipsoids; ++n)
     {
@@ -280,6 +281,12 @@ bool MultiEllipsoidSampler::drawWithConstraint(const RefArrayXXd totalSample, co
 
     } // end while-loop (newPointIsFound == false)
     
+
+    // Provide the statistics of the draw to the nesting process
+
+    NdrawAttemptsOfLastDraw = NdrawAttempts;
+    clusterIndexOfLastDrawnPoint = clusterIndicesOfEllipsoids[indexOfSelectedEllipsoid];
+
     // Depending on whether we found a new point or not, return true or false.
 
     return newPointIsFound;
@@ -370,6 +377,7 @@ void MultiEllipsoidSampler::computeEllipsoids(RefArrayXXd const totalSample, con
     // Clear whatever was in the ellipsoids collection
 
     ellipsoids.clear();
+    clusterIndicesOfEllipsoids.clear();
 
 
     // Create an Ellipsoid for each cluster (provided it's large enough)
@@ -419,6 +427,7 @@ void MultiEllipsoidSampler::computeEllipsoids(RefArrayXXd const totalSample, con
             // Add ellipsoid at the end of our vector
 
             ellipsoids.push_back(Ellipsoid(sampleOfOneCluster, enlargementFraction));
+            clusterIndicesOfEllipsoids.push_back(i);
         }
     }
 
@@ -127,3 +127,42 @@ int MultiLinearModel::getNpoints()
 {
     return Npoints;
 }
+
+
+
+
+
+
+
+
+
+
+// MultiLinearModel::predictBlock()
+//
+// PURPOSE:
+//      Same as predict(), but only for the points begin, ..., begin + size - 1 of each covariate,
+//      and overwriting the predictions rather than adding to them.
+//      Used by FusedLikelihood to evaluate the model one block at a time, while the block is in the cache.
+//
+// INPUT:
+//      predictions:        pointer to the size elements to contain the predictions
+//      begin:              index of the first point of the block
+//      size:               number of points of the block
+//      modelParameters:    one-dimensional array where each element
+//                          contains the value of a free parameter of the model
+//
+// OUTPUT:
+//      void
+//
+
+void MultiLinearModel::predictBlock(double *predictions, const int begin, const int size, const RefArrayXd modelParameters)
+{
+    Eigen::Map<ArrayXd> predictionsBlock(predictions, size);
+
+    predictionsBlock.setConstant(modelParameters(Nobservables));
+
+    for (int observable = 0; observable < Nobservables; ++observable)
+    {
+        predictionsBlock += covariates.segment(observable*Npoints + begin, size)*modelParameters(observable);
+    }
+}
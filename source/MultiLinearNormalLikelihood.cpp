@@ -21,6 +21,9 @@ MultiLinearNormalLikelihood::MultiLinearNormalLikelihood(const RefArrayXd observ
     Nobservables = model.getNobservables();
     Npoints = model.getNpoints();
     assert(observations.size() || observationsUncertainty.size());
+
+    covariatesVariances = covariatesUncertainties.square();
+    observationsVariance = observationsUncertainty.square();
 }
 
 
@@ -118,27 +121,51 @@ ArrayXd MultiLinearNormalLikelihood::getObservationsUncertainty()
 
 double MultiLinearNormalLikelihood::logValue(RefArrayXd modelParameters)
 {
-    ArrayXd predictions;
-    ArrayXd lambda;
-    ArrayXd lambda0;
-    ArrayXd totalVariance(Npoints);
+    return logValue(modelParameters, EvaluationWorkspace::getThreadWorkspace());
+}
+
+
+
+
+
+
+
+
+
+// MultiLinearNormalLikelihood::logValue()
+//
+// PURPOSE:
+//      Same as above, using the arrays of a workspace, so that no memory is allocated.
+//      The squared uncertainties are computed by the constructor.
+//
+// INPUT:
+//      modelParameters: a one-dimensional array containing the actual
+//      values of the free parameters that describe the model.
+//      workspace: the workspace of the calling thread.
+//
+// OUTPUT:
+//      a double number containing the natural logarithm of the
+//      normal likelihood
+//
+
+double MultiLinearNormalLikelihood::logValue(RefArrayXd modelParameters, EvaluationWorkspace &workspace)
+{
+    ArrayXd &predictions = workspace.getPredictions(observations.size());
+    ArrayXd &totalVariance = workspace.getLikelihoodArray(Npoints);
 
-    predictions.resize(observations.size());
     predictions.setZero();
-    model.predict(predictions, modelParameters);
+    model.predict(predictions, modelParameters, workspace);
 
-    totalVariance = observationsUncertainty.square();
+    totalVariance = observationsVariance;
 
     for (int observable = 0; observable < Nobservables; ++observable)
     {
-        totalVariance += covariatesUncertainties.segment(observable*Npoints, Npoints).square()
+        totalVariance += covariatesVariances.segment(observable*Npoints, Npoints)
                         *modelParameters(observable)*modelParameters(observable);
     }
     
-    lambda0 = -0.5 * log(2.0*Functions::PI) -0.5 * totalVariance.log(); 
-    lambda = lambda0 - 0.5 * ((observations - predictions)*(observations - predictions)) / totalVariance;
-    
-    return lambda.sum();
+    return (-0.5 * log(2.0*Functions::PI) - 0.5 * totalVariance.log() 
+            - 0.5 * (observations - predictions).square() / totalVariance).sum();
 }
 
 
@@ -36,11 +36,30 @@ NestedSampler::NestedSampler(const bool printOnTheScreen, const int initialNlive
   logCumulatedPriorMass(numeric_limits<double>::lowest()),
   logRemainingPriorMass(0.0),
   ratioOfRemainderToCurrentEvidence(numeric_limits<double>::max()),
+  livePointIndex(metric),
+  livePointIndexIsUpToDate(false),
+  NdrawAttemptsOfLastDraw(0),
+  clusterIndexOfLastDrawnPoint(-1),
+  logBoundingVolumeOfLastDraw(numeric_limits<double>::quiet_NaN()),
   Niterations(0),
   updatedNlivePoints(initialNlivePoints),
   initialNlivePoints(initialNlivePoints),
   informationGain(0.0), 
-  logEvidence(numeric_limits<double>::lowest())
+  logEvidence(numeric_limits<double>::lowest()),
+  adaptiveReclusteringActivated(false),
+  minFractionOfClusteringInterval(0.2),
+  maxMultipleOfClusteringInterval(10.0),
+  minNiterationsWithSameClustering(10),
+  maxNiterationsWithSameClustering(500),
+  maxRelativeAcceptanceRateDrop(0.5),
+  maxRelativeBoundingVolumeGrowth(8.0),
+  maxClusterSizeDrift(0.1),
+  NiterationsSinceClustering(0),
+  NdrawAttemptsSinceClustering(0),
+  referenceAcceptanceRate(0.0),
+  recentAcceptanceRate(0.0),
+  referenceLogBoundingVolumeRatio(numeric_limits<double>::quiet_NaN()),
+  recentLogBoundingVolumeRatio(numeric_limits<double>::quiet_NaN())
 {
    // Set the seed of the random generator using the clock
 
@@ -113,7 +132,10 @@ NestedSampler::~NestedSampler()
 //                                            expect any clustering before the algorithm is able to tune in on the island(s) of 
 //                                            high likelihood. Clusters found in the first N initial iterations are therefore 
 //                                            likely purely noise.
-//      NiterationsWithSameClustering:        A new clustering will only happen every N iterations.
+//      NiterationsWithSameClustering:        A new clustering will only happen every N iterations. If the adaptive reclustering
+//                                            is activated (see setAdaptiveReclustering()), this schedule is only used until
+//                                            the first proper clustering, and then sets the minimum and maximum number of 
+//                                            iterations between two clusterings.
 //      maxNdrawAttempts:                     The maximum number of attempts allowed when drawing from a single ellipsoid.
 //      minRatioOfRemainderToCurrentEvidence: The minimum fraction of remainder evidence to gained evidence used to terminate 
 //                                            the nested iteration loop. This value is also used as a tolerance on the final
@@ -227,17 +249,32 @@ void NestedSampler::run(LivePointsReducer &livePointsReducer, const int Ninitial
     }
 
 
-    // Compute the log(Likelihood) for each of our points in the live sample
+    // Compute the log(Likelihood) for each of our points in the live sample.
+    // Each thread evaluates the likelihood with a workspace of its own.
 
     logLikelihood.resize(NlivePoints);
    
-    #pragma omp parallel for
-    for (int i = 0; i < NlivePoints; ++i)
+    #ifdef _OPENMP
+    #pragma omp parallel
+    #endif
     {
-        logLikelihood(i) = likelihood.logValue(nestedSample.col(i));
+        EvaluationWorkspace workspace;
+
+        #ifdef _OPENMP
+        #pragma omp for
+        #endif
+        for (int i = 0; i < NlivePoints; ++i)
+        {
+            logLikelihood(i) = likelihood.logValue(nestedSample.col(i), workspace);
+        }
     }
 
 
+    // The spatial index of the live points is only built when it is first queried (see getLivePointIndex())
+
+    livePointIndexIsUpToDate = false;
+
+
     // Initialize the prior mass interval and cumulate it
 
     double logWidthInPriorMass = log(1.0 - exp(-1.0/NlivePoints));                                      // X_0 - X_1    First width in prior mass
@@ -265,6 +302,39 @@ void NestedSampler::run(LivePointsReducer &livePointsReducer, const int Ninitial
     vector<int> clusterIndices(NlivePoints);        // clusterIndices must have the same number of elements as the number of live points
     vector<int> clusterSizes;                       // The number of live points counted in each cluster is updated everytime one live point
                                                     // is removed from the sample.
+    bool partitionOfLivePointsIsAvailable = false;  // True once a proper clustering of the live points was done
+
+
+    // In the adaptive mode, every decision of reclustering is saved in an output ASCII file, whether
+    // or not a clustering was done, from the minimum number of iterations after the previous clustering on
+
+    ofstream reclusteringFile;
+
+    if (adaptiveReclusteringActivated)
+    {
+        // The bounds of the interval between two clusterings follow the fixed schedule
+
+        minNiterationsWithSameClustering = max(1, static_cast<int>(round(minFractionOfClusteringInterval * NiterationsWithSameClustering)));
+        maxNiterationsWithSameClustering = max(minNiterationsWithSameClustering, 
+                                               static_cast<int>(round(maxMultipleOfClusteringInterval * NiterationsWithSameClustering)));
+
+        File::openOutputFile(reclusteringFile, outputPathPrefix + "reclusteringDecisions.txt");
+        reclusteringFile << "# Reclustering decisions of the adaptive reclustering mode. Every clustering of the live points is saved," << endl;
+        reclusteringFile << "# as well as every iteration at which the partition was kept, from the minimum interval on." << endl;
+        reclusteringFile << "# Minimum and maximum number of iterations between two clusterings: " 
+                         << minNiterationsWithSameClustering << " " << maxNiterationsWithSameClustering << endl;
+        reclusteringFile << "# Column #1: Niterations" << endl;
+        reclusteringFile << "# Column #2: Number of iterations since the previous clustering" << endl;
+        reclusteringFile << "# Column #3: Clustering done (1) or partition kept (0)" << endl;
+        reclusteringFile << "# Column #4: Reason (0 = fixed schedule or partition kept, 1 = maximum interval, 2 = acceptance rate drop, " 
+                         << "3 = bounding volume growth, 4 = cluster size drift)" << endl;
+        reclusteringFile << "# Column #5: Recent acceptance rate of the draws" << endl;
+        reclusteringFile << "# Column #6: Reference acceptance rate of the draws" << endl;
+        reclusteringFile << "# Column #7: log growth of the ratio of bounding volume to remaining prior mass" << endl;
+        reclusteringFile << "# Column #8: Fraction of live points drifted between clusters" << endl;
+        reclusteringFile << "# Column #9: Nclusters" << endl;
+        reclusteringFile << scientific << setprecision(4);
+    }
 
 
     // Start the nested sampling loop. Each iteration, we'll replace the point with the worst likelihood.
@@ -330,9 +400,31 @@ void NestedSampler::run(LivePointsReducer &livePointsReducer, const int Ninitial
                
 
         // Find clusters in our live sample of points. Don't do this every iteration but only
-        // every X iterations, where X is given by 'NiterationsWithSameClustering'.
+        // every X iterations, where X is given by 'NiterationsWithSameClustering'. In the adaptive mode,
+        // once a first partition is available, recluster only when the draws show that it became stale.
         
-        if ((Niterations % NiterationsWithSameClustering) == 0)
+        int reasonForReclustering = 0;
+        bool clusteringIsDue;
+
+        if (adaptiveReclusteringActivated && partitionOfLivePointsIsAvailable)
+        {
+            reasonForReclustering = findReasonForReclustering(clusterSizes);
+            clusteringIsDue = (reasonForReclustering > 0);
+
+            if (!clusteringIsDue && (NiterationsSinceClustering >= minNiterationsWithSameClustering))
+            {
+                reclusteringFile << Niterations << "  " << NiterationsSinceClustering << "  0  0  "
+                                 << recentAcceptanceRate << "  " << referenceAcceptanceRate << "  "
+                                 << recentLogBoundingVolumeRatio - referenceLogBoundingVolumeRatio << "  "
+                                 << computeClusterSizeDrift(clusterSizes) << "  " << Nclusters << endl;
+            }
+        }
+        else
+        {
+            clusteringIsDue = ((Niterations % NiterationsWithSameClustering) == 0);
+        }
+
+        if (clusteringIsDue)
         {
             // Don't do clustering the first N iterations, where N is user-specified. That is, 
             // the first N iterations we assume that there is only 1 cluster containing all the points.
@@ -343,11 +435,39 @@ void NestedSampler::run(LivePointsReducer &livePointsReducer, const int Ninitial
             
             if (Niterations > NinitialIterationsWithoutClustering)
             {
-                // After the first N initial iterations, we do a proper clustering.
+                // After the first N initial iterations, we do a proper clustering. Once a first partition
+                // of the live points is available, the clusterer can refine it instead of starting from scratch,
+                // since only a few live points have been replaced since the previous clustering.
                 
-                clusterSizes.clear();
-                Nclusters = clusterer.cluster(nestedSample, clusterIndices, clusterSizes);
+                double clusterSizeDrift = 0.0;
+
+                if (adaptiveReclusteringActivated && partitionOfLivePointsIsAvailable)
+                {
+                    clusterSizeDrift = computeClusterSizeDrift(clusterSizes);
+                }
+
+                if (partitionOfLivePointsIsAvailable)
+                {
+                    Nclusters = clusterer.clusterWithWarmStart(nestedSample, clusterIndices, clusterSizes);
+                }
+                else
+                {
+                    clusterSizes.clear();
+                    Nclusters = clusterer.cluster(nestedSample, clusterIndices, clusterSizes);
+                }
+
+                partitionOfLivePointsIsAvailable = (clusterSizes.size() == Nclusters);
                 reducedNdimensions = clusterer.getReducedNdimensions();
+
+                if (adaptiveReclusteringActivated)
+                {
+                    reclusteringFile << Niterations << "  " << NiterationsSinceClustering << "  1  " << reasonForReclustering << "  "
+                                     << recentAcceptanceRate << "  " << referenceAcceptanceRate << "  "
+                                     << recentLogBoundingVolumeRatio - referenceLogBoundingVolumeRatio << "  "
+                                     << clusterSizeDrift << "  " << Nclusters << endl;
+
+                    resetReclusteringTelemetry(clusterSizes);
+                }
             }
             else         
             {
@@ -388,6 +508,9 @@ void NestedSampler::run(LivePointsReducer &livePointsReducer, const int Ninitial
 
         ArrayXd drawnPoint = nestedSample.col(indexOfRandomlyChosenLivePoint);
         double logLikelihoodOfDrawnPoint = 0.0;
+        NdrawAttemptsOfLastDraw = 0;
+        clusterIndexOfLastDrawnPoint = -1;
+        logBoundingVolumeOfLastDraw = numeric_limits<double>::quiet_NaN();
 
         bool newPointIsFound = drawWithConstraint(nestedSample, Nclusters, clusterIndices, clusterSizes, 
                                                   drawnPoint, logLikelihoodOfDrawnPoint, maxNdrawAttempts); 
@@ -421,6 +544,14 @@ void NestedSampler::run(LivePointsReducer &livePointsReducer, const int Ninitial
 
         nestedSample.col(indexOfLivePointWithWorstLikelihood) = drawnPoint;
         logLikelihood(indexOfLivePointWithWorstLikelihood) = logLikelihoodOfDrawnPoint;
+
+        if (livePointIndexIsUpToDate)
+            livePointIndex.replacePoint(indexOfLivePointWithWorstLikelihood, drawnPoint);
+
+        if (adaptiveReclusteringActivated)
+        {
+            updateReclusteringTelemetry(clusterIndices[indexOfLivePointWithWorstLikelihood]);
+        }
        
         
         // If we got till here this is not the last iteration possible, hence 
@@ -717,9 +848,18 @@ void NestedSampler::removeLivePointsFromSample(const vector<int> &indicesOfLiveP
         int clusterIndexCopy = clusterIndices[NlivePointsAtCurrentIteration-1];
         clusterIndices[NlivePointsAtCurrentIteration-1] = clusterIndices[indicesOfLivePointsToRemove[m]];
         --clusterSizes[clusterIndices[indicesOfLivePointsToRemove[m]]];
+
+        if (driftedClusterSizes.size() == clusterSizes.size())
+        {
+            --driftedClusterSizes[clusterIndices[indicesOfLivePointsToRemove[m]]];
+        }
+
         clusterIndices[indicesOfLivePointsToRemove[m]] = clusterIndexCopy;
         clusterIndices.pop_back();
 
+        if (livePointIndexIsUpToDate)
+            livePointIndex.removePoint(indicesOfLivePointsToRemove[m]);
+
                 
         // Reduce the current number of live points by one.
                 
@@ -737,6 +877,220 @@ void NestedSampler::removeLivePointsFromSample(const vector<int> &indicesOfLiveP
 
 
 
+// NestedSampler::resetReclusteringTelemetry()
+//
+// PURPOSE:
+//          Reset the statistics of the draws used by the adaptive reclustering, 
+//          right after a new clustering of the live points.
+//
+// INPUT:   
+//          clusterSizes:      A vector of integers containing the sizes of the new clusters
+//
+// OUTPUT:
+//      void
+//
+
+void NestedSampler::resetReclusteringTelemetry(const vector<int> &clusterSizes)
+{
+    NiterationsSinceClustering = 0;
+    NdrawAttemptsSinceClustering = 0;
+    referenceAcceptanceRate = 0.0;
+    recentAcceptanceRate = 0.0;
+    referenceLogBoundingVolumeRatio = numeric_limits<double>::quiet_NaN();
+    recentLogBoundingVolumeRatio = numeric_limits<double>::quiet_NaN();
+    driftedClusterSizes = clusterSizes;
+}
+
+
+
+
+
+
+
+
+
+
+
+// NestedSampler::updateReclusteringTelemetry()
+//
+// PURPOSE:
+//          Update the statistics of the draws used by the adaptive reclustering, after a 
+//          live point was replaced by a new one. The statistics are provided by the sampler
+//          through NdrawAttemptsOfLastDraw, logBoundingVolumeOfLastDraw and clusterIndexOfLastDrawnPoint.
+//          During the first minNiterationsWithSameClustering iterations after a clustering, the 
+//          acceptance rate and the ratio of bounding volume to remaining prior mass are averaged
+//          to set the reference values. Afterwards, they are followed with a moving average
+//          (acceptance rate) and the value of the last draw (volume ratio).
+//          The new point belongs to the cluster of the replaced point, as far as the clusterer is 
+//          concerned, but it may have been drawn from the bound of another cluster. This is counted 
+//          in the drifted sizes of the clusters.
+//
+// INPUT:   
+//          clusterIndexOfReplacedPoint:     The index of the cluster of the replaced live point
+//
+// OUTPUT:
+//      void
+//
+
+void NestedSampler::updateReclusteringTelemetry(const int clusterIndexOfReplacedPoint)
+{
+    NiterationsSinceClustering++;
+    bool referenceIsBeingSet = (NiterationsSinceClustering <= minNiterationsWithSameClustering);
+
+    if (NdrawAttemptsOfLastDraw > 0)
+    {
+        NdrawAttemptsSinceClustering += NdrawAttemptsOfLastDraw;
+
+        if (referenceIsBeingSet)
+        {
+            referenceAcceptanceRate = double(NiterationsSinceClustering) / NdrawAttemptsSinceClustering;
+            recentAcceptanceRate = referenceAcceptanceRate;
+        }
+        else
+        {
+            // Exponential moving average of the number of attempts per draw
+
+            double smoothingFactor = 1.0 / minNiterationsWithSameClustering;
+            double recentMeanNdrawAttempts = 1.0 / recentAcceptanceRate;
+            recentMeanNdrawAttempts += smoothingFactor * (NdrawAttemptsOfLastDraw - recentMeanNdrawAttempts);
+            recentAcceptanceRate = 1.0 / recentMeanNdrawAttempts;
+        }
+    }
+
+    if (std::isfinite(logBoundingVolumeOfLastDraw))
+    {
+        recentLogBoundingVolumeRatio = logBoundingVolumeOfLastDraw - logRemainingPriorMass;
+
+        if (!std::isfinite(referenceLogBoundingVolumeRatio))
+        {
+            referenceLogBoundingVolumeRatio = recentLogBoundingVolumeRatio;
+        }
+        else if (referenceIsBeingSet)
+        {
+            referenceLogBoundingVolumeRatio += (recentLogBoundingVolumeRatio - referenceLogBoundingVolumeRatio) / NiterationsSinceClustering;
+        }
+    }
+
+    const int NdriftedClusters = driftedClusterSizes.size();
+
+    if ((clusterIndexOfLastDrawnPoint >= 0) && (clusterIndexOfLastDrawnPoint < NdriftedClusters) 
+        && (clusterIndexOfReplacedPoint >= 0) && (clusterIndexOfReplacedPoint < NdriftedClusters))
+    {
+        driftedClusterSizes[clusterIndexOfReplacedPoint]--;
+        driftedClusterSizes[clusterIndexOfLastDrawnPoint]++;
+    }
+}
+
+
+
+
+
+
+
+
+
+
+
+// NestedSampler::computeClusterSizeDrift()
+//
+// PURPOSE:
+//          Compute the fraction of live points that moved from one cluster to another since
+//          the last clustering, according to the clusters in which the new points were drawn.
+//
+// INPUT:   
+//          clusterSizes:      A vector of integers containing the sizes of the current clusters
+//
+// OUTPUT:
+//      The fraction of drifted live points, between 0 and 1.
+//
+
+double NestedSampler::computeClusterSizeDrift(const vector<int> &clusterSizes)
+{
+    if (driftedClusterSizes.size() != clusterSizes.size())
+    {
+        return 0.0;
+    }
+
+    int NdriftedLivePoints = 0;
+
+    for (size_t i = 0; i < clusterSizes.size(); ++i)
+    {
+        NdriftedLivePoints += abs(driftedClusterSizes[i] - clusterSizes[i]);
+    }
+
+    return 0.5 * NdriftedLivePoints / NlivePoints;
+}
+
+
+
+
+
+
+
+
+
+
+
+// NestedSampler::findReasonForReclustering()
+//
+// PURPOSE:
+//          Decide whether the live points should be clustered again in the adaptive mode.
+//          A clustering is never done within minNiterationsWithSameClustering iterations from the 
+//          previous one, and always after maxNiterationsWithSameClustering iterations. In between, it is 
+//          done when the partition appears stale, i.e. when the acceptance rate of the draws dropped
+//          by more than maxRelativeAcceptanceRateDrop, when the total volume of the bounds grew by 
+//          more than a factor maxRelativeBoundingVolumeGrowth with respect to the remaining prior mass, 
+//          or when more than a fraction maxClusterSizeDrift of the live points drifted between clusters.
+//
+// INPUT:   
+//          clusterSizes:      A vector of integers containing the sizes of the current clusters
+//
+// OUTPUT:
+//      0 if no clustering is needed, otherwise the reason for the clustering: 1 = maximum interval,
+//      2 = acceptance rate drop, 3 = bounding volume growth, 4 = cluster size drift.
+//
+
+int NestedSampler::findReasonForReclustering(const vector<int> &clusterSizes)
+{
+    if (NiterationsSinceClustering < minNiterationsWithSameClustering)
+    {
+        return 0;
+    }
+
+    if (NiterationsSinceClustering >= maxNiterationsWithSameClustering)
+    {
+        return 1;
+    }
+
+    if ((referenceAcceptanceRate > 0.0) && (recentAcceptanceRate < (1.0 - maxRelativeAcceptanceRateDrop) * referenceAcceptanceRate))
+    {
+        return 2;
+    }
+
+    if (std::isfinite(referenceLogBoundingVolumeRatio) && std::isfinite(recentLogBoundingVolumeRatio) 
+        && (recentLogBoundingVolumeRatio - referenceLogBoundingVolumeRatio > log(maxRelativeBoundingVolumeGrowth)))
+    {
+        return 3;
+    }
+
+    if (computeClusterSizeDrift(clusterSizes) > maxClusterSizeDrift)
+    {
+        return 4;
+    }
+
+    return 0;
+}
+
+
+
+
+
+
+
+
+
+
+
 // NestedSampler::printComputationalTime()
 //
 // PURPOSE:
@@ -1073,10 +1427,11 @@ double NestedSampler::getTerminationFactor()
 //      Get protected data member NlivePointsPerIteration.
 //
 // OUTPUT:
-//      A double containing the Skilling's error on the logEvidence.
+//      A constant reference to the vector containing the number of live points 
+//      used at each iteration of the nesting process.
 //
 
-vector<int> NestedSampler::getNlivePointsPerIteration()
+const vector<int> &NestedSampler::getNlivePointsPerIteration()
 {
     return NlivePointsPerIteration;
 }
@@ -1099,11 +1454,11 @@ vector<int> NestedSampler::getNlivePointsPerIteration()
 //      Get private data member nestedSample.
 //
 // OUTPUT:
-//      An eigen array containing the coordinates of the
+//      A constant reference to the eigen array containing the coordinates of the
 //      current set of live points.
 //
 
-ArrayXXd NestedSampler::getNestedSample()
+const ArrayXXd &NestedSampler::getNestedSample()
 {
     return nestedSample;
 }
@@ -1119,17 +1474,53 @@ ArrayXXd NestedSampler::getNestedSample()
 
 
 
+
+
+// NestedSampler::getLivePointIndex()
+//
+// PURPOSE:
+//      Get the spatial index of the current live points, for neighbour queries, e.g. by a derived sampler.
+//      The index is built at the first call only, and from then on it is updated incrementally 
+//      at each replacement or removal of a live point. A run in which the index is never queried
+//      hence does not spend any time in maintaining it.
+//
+// OUTPUT:
+//      A reference to the LivePointIndex of the current set of live points.
+//
+
+LivePointIndex &NestedSampler::getLivePointIndex()
+{
+    if (!livePointIndexIsUpToDate)
+    {
+        livePointIndex.build(nestedSample);
+        livePointIndexIsUpToDate = true;
+    }
+
+    return livePointIndex;
+}
+
+
+
+
+
+
+
+
+
+
+
+
 // NestedSampler::getLogLikelihood()
 //
 // PURPOSE:
 //      Get private data member logLikelihood.
 //
 // OUTPUT:
-//      An eigen array containing the log(Likelihood) values of the
+//      A constant reference to the eigen array containing the log(Likelihood) values of the
 //      current set of live points.
 //
 
-ArrayXd NestedSampler::getLogLikelihood()
+const ArrayXd &NestedSampler::getLogLikelihood()
 {
     return logLikelihood;
 }
@@ -1322,11 +1713,11 @@ void NestedSampler::setPosteriorSample(ArrayXXd newPosteriorSample)
 //      Get private data member posteriorSample.
 //
 // OUTPUT:
-//      An eigen array containing the coordinates of the
+//      A constant reference to the eigen array containing the coordinates of the
 //      final posterior sample.
 //
 
-ArrayXXd NestedSampler::getPosteriorSample()
+const ArrayXXd &NestedSampler::getPosteriorSample()
 {
     return posteriorSample;
 }
@@ -1374,11 +1765,11 @@ void NestedSampler::setLogLikelihoodOfPosteriorSample(ArrayXd newLogLikelihoodOf
 //      Get private data member logLikelihoodOfPosteriorSample.
 //
 // OUTPUT:
-//      An eigen array containing the log(Likelihood) values of the
+//      A constant reference to the eigen array containing the log(Likelihood) values of the
 //      final posterior sample.
 //
 
-ArrayXd NestedSampler::getLogLikelihoodOfPosteriorSample()
+const ArrayXd &NestedSampler::getLogLikelihoodOfPosteriorSample()
 {
     return logLikelihoodOfPosteriorSample;
 }
@@ -1430,11 +1821,11 @@ void NestedSampler::setLogWeightOfPosteriorSample(ArrayXd newLogWeightOfPosterio
 //      Get private data member logWeightOfPosteriorSample.
 //
 // OUTPUT:
-//      An eigen array containing the log(Weight) values of the
+//      A constant reference to the eigen array containing the log(Weight) values of the
 //      final posterior sample.
 //
 
-ArrayXd NestedSampler::getLogWeightOfPosteriorSample()
+const ArrayXd &NestedSampler::getLogWeightOfPosteriorSample()
 {
     return logWeightOfPosteriorSample;
 }
@@ -1454,11 +1845,11 @@ ArrayXd NestedSampler::getLogWeightOfPosteriorSample()
 //      Get private data member logEvidenceOfPosteriorSample.
 //
 // OUTPUT:
-//      An eigen array containing the cumulated log(Evidence) values for each
+//      A constant reference to the eigen array containing the cumulated log(Evidence) values for each
 //      nested iteration
 //
 
-ArrayXd NestedSampler::getLogEvidenceOfPosteriorSample()
+const ArrayXd &NestedSampler::getLogEvidenceOfPosteriorSample()
 {
     return logEvidenceOfPosteriorSample;
 }
@@ -1479,11 +1870,11 @@ ArrayXd NestedSampler::getLogEvidenceOfPosteriorSample()
 //      Get private data member logMeanLiveEvidenceOfPosteriorSample.
 //
 // OUTPUT:
-//      An eigen array containing the log(MeanLiveEvidence) values remaining at each
+//      A constant reference to the eigen array containing the log(MeanLiveEvidence) values remaining at each
 //      nested iteration
 //
 
-ArrayXd NestedSampler::getLogMeanLiveEvidenceOfPosteriorSample()
+const ArrayXd &NestedSampler::getLogMeanLiveEvidenceOfPosteriorSample()
 {
     return logMeanLiveEvidenceOfPosteriorSample;
 }
@@ -1536,3 +1927,57 @@ string NestedSampler::getOutputPathPrefix()
 {
     return outputPathPrefix;
 }
+
+
+
+
+
+
+
+
+
+
+
+// NestedSampler::setAdaptiveReclustering()
+//
+// PURPOSE:
+//      Activate or deactivate the adaptive reclustering of the live points. Instead of clustering
+//      every NiterationsWithSameClustering iterations, the live points are clustered again only when the 
+//      statistics of the draws show that the current partition became stale (see findReasonForReclustering()). 
+//      All the decisions of the adaptive mode are saved in the file reclusteringDecisions.txt: every clustering,
+//      and every iteration at which the partition was kept, from minNiterationsWithSameClustering iterations 
+//      after the previous clustering on.
+//
+// INPUT:
+//      activated:                          A boolean to activate the adaptive reclustering
+//      minFractionOfClusteringInterval:    The minimum number of iterations between two clusterings, as a fraction (<= 1)
+//                                          of the NiterationsWithSameClustering given to run(). It is also the number
+//                                          of iterations used to set the reference statistics.
+//      maxMultipleOfClusteringInterval:    The maximum number of iterations between two clusterings, as a multiple (>= 1)
+//                                          of the NiterationsWithSameClustering given to run().
+//      maxRelativeAcceptanceRateDrop:      The relative drop of the acceptance rate of the draws (between 0 and 1) 
+//                                          that triggers a clustering
+//      maxRelativeBoundingVolumeGrowth:    The growth factor (> 1) of the ratio of the total volume of the bounds 
+//                                          to the remaining prior mass that triggers a clustering
+//      maxClusterSizeDrift:                The fraction of live points drifted between clusters that triggers a clustering
+//
+// OUTPUT:
+//      void
+//
+
+void NestedSampler::setAdaptiveReclustering(const bool activated, const double minFractionOfClusteringInterval,
+                                            const double maxMultipleOfClusteringInterval, const double maxRelativeAcceptanceRateDrop,
+                                            const double maxRelativeBoundingVolumeGrowth, const double maxClusterSizeDrift)
+{
+    assert((minFractionOfClusteringInterval > 0.0) && (minFractionOfClusteringInterval <= 1.0));
+    assert(maxMultipleOfClusteringInterval >= 1.0);
+    assert((maxRelativeAcceptanceRateDrop > 0.0) && (maxRelativeAcceptanceRateDrop < 1.0));
+    assert(maxRelativeBoundingVolumeGrowth > 1.0);
+
+    adaptiveReclusteringActivated = activated;
+    this->minFractionOfClusteringInterval = minFractionOfClusteringInterval;
+    this->maxMultipleOfClusteringInterval = maxMultipleOfClusteringInterval;
+    this->maxRelativeAcceptanceRateDrop = maxRelativeAcceptanceRateDrop;
+    this->maxRelativeBoundingVolumeGrowth = maxRelativeBoundingVolumeGrowth;
+    this->maxClusterSizeDrift = maxClusterSizeDrift;
+}
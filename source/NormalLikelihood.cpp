@@ -11,12 +11,19 @@
 //      uncertainties: array containing the uncertainties of the observations
 //      model: object specifying the model to be used.
 // 
+// REMARK:
+//      The terms that only depend on the uncertainties are computed here once, 
+//      rather than at each evaluation of the likelihood.
+//
 
 NormalLikelihood::NormalLikelihood(const RefArrayXd observations, const RefArrayXd uncertainties, Model &model)
 : Likelihood(observations, model),
   uncertainties(uncertainties)
 {
     assert(observations.size() || uncertainties.size());
+
+    inverseVariances = uncertainties.square().inverse();
+    logNormalization = -0.5 * uncertainties.size() * log(2.0*Functions::PI) - uncertainties.log().sum();
 }
 
 
@@ -85,18 +92,40 @@ ArrayXd NormalLikelihood::getUncertainties()
 
 double NormalLikelihood::logValue(RefArrayXd modelParameters)
 {
-    ArrayXd predictions;
-    ArrayXd lambda;
-    ArrayXd lambda0;
+    return logValue(modelParameters, EvaluationWorkspace::getThreadWorkspace());
+}
+
+
+
+
+
+
+
+
+
+// NormalLikelihood::logValue()
+//
+// PURPOSE:
+//      Same as above, using the arrays of a workspace, so that no memory is allocated.
+//
+// INPUT:
+//      modelParameters: a one-dimensional array containing the actual
+//      values of the free parameters that describe the model.
+//      workspace: the workspace of the calling thread.
+//
+// OUTPUT:
+//      a double number containing the natural logarithm of the
+//      normal likelihood
+//
+
+double NormalLikelihood::logValue(RefArrayXd modelParameters, EvaluationWorkspace &workspace)
+{
+    ArrayXd &predictions = workspace.getPredictions(observations.size());
     
-    predictions.resize(observations.size());
     predictions.setZero();
-    model.predict(predictions, modelParameters);
-    
-    lambda0 = -0.5 * log(2.0*Functions::PI) -1.0 * uncertainties.log(); 
-    lambda = lambda0 - 0.5 * ((observations - predictions)*(observations - predictions)) / (uncertainties*uncertainties);
+    model.predict(predictions, modelParameters, workspace);
     
-    return lambda.sum();
+    return logNormalization - 0.5 * ((observations - predictions).square() * inverseVariances).sum();
 }
 
 
@@ -104,3 +104,41 @@ void PolynomialModel::predict(RefArrayXd predictions, RefArrayXd const modelPara
 
 
 
+
+
+
+
+
+
+// PolynomialModel::predictBlock()
+//
+// PURPOSE:
+//      Same as predict(), but only for the points begin, ..., begin + size - 1 of the covariates.
+//      The polynomial is computed with Horner's rule, which needs no powers of the covariates.
+//      Used by FusedLikelihood to evaluate the model one block at a time, while the block is in the cache.
+//
+// INPUT:
+//      predictions:        pointer to the size elements to contain the predictions
+//      begin:              index of the first point of the block
+//      size:               number of points of the block
+//      modelParameters:    one-dimensional array where each element
+//                          contains the value of a free parameter of the model
+//
+// OUTPUT:
+//      void
+//
+
+void PolynomialModel::predictBlock(double *predictions, const int begin, const int size, const RefArrayXd modelParameters)
+{
+    Eigen::Map<ArrayXd> predictionsBlock(predictions, size);
+    auto covariatesBlock = covariates.segment(begin, size);
+
+    predictionsBlock.setZero();
+
+    for (int degree = Ndegrees - 1; degree >= 0; --degree)
+    {
+        predictionsBlock = (predictionsBlock + modelParameters(degree)) * covariatesBlock;
+    }
+
+    predictionsBlock += modelParameters(Ndegrees);
+}
@@ -0,0 +1,615 @@
+#include "PosteriorMerger.h"
+
+
+// PosteriorMerger::PosteriorMerger()
+//
+// PURPOSE:
+//      Constructor.
+//
+// INPUT:
+//      bufferSize:     number of points of the merged sample collected in memory before
+//                      writing them to the output files
+//
+
+PosteriorMerger::PosteriorMerger(const int bufferSize)
+: bufferSize(bufferSize),
+  Ndimensions(0),
+  Nsamples(0),
+  NlivePoints(0),
+  logEvidence(numeric_limits<double>::lowest()),
+  logEvidenceError(0.0),
+  informationGain(0.0)
+{
+    assert(bufferSize > 0);
+}
+
+
+
+
+
+
+
+
+
+
+// PosteriorMerger::~PosteriorMerger()
+//
+// PURPOSE:
+//      Destructor. Closes the input of all the runs.
+//
+
+PosteriorMerger::~PosteriorMerger()
+{
+    for (size_t i = 0; i < runs.size(); ++i)
+    {
+        delete runs[i];
+    }
+}
+
+
+
+
+
+
+
+
+
+
+// PosteriorMerger::addRun()
+//
+// PURPOSE:
+//      Adds a run to the list of runs to merge. The run is read from a binary posterior
+//      file if the input starts with the identifier of the binary posterior format,
+//      and from the ASCII output files with the input as path prefix otherwise.
+//
+// INPUT:
+//      inputName:  full path of a binary posterior file, or path prefix of the ASCII
+//                  output files of the run (e.g. "run01/demoFive2DGaussians_")
+//
+// OUTPUT:
+//      void
+//
+
+void PosteriorMerger::addRun(const string inputName)
+{
+    char magicNumber[sizeof(BinaryPosteriorFile::magicNumber)] = {0};
+    ifstream inputFile(inputName.c_str(), ios::in | ios::binary);
+
+    if (inputFile.good())
+    {
+        inputFile.read(magicNumber, sizeof(magicNumber));
+        inputFile.close();
+    }
+
+    MergeableRun *run;
+
+    if (memcmp(magicNumber, BinaryPosteriorFile::magicNumber, sizeof(magicNumber)) == 0)
+        run = new BinaryMergeableRun(inputName);
+    else
+        run = new AsciiMergeableRun(inputName);
+
+    if (!runs.empty() && run->getNdimensions() != Ndimensions)
+    {
+        cerr << "Error: run " << inputName << " has " << run->getNdimensions()
+             << " dimensions, while the previous runs have " << Ndimensions << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    Ndimensions = run->getNdimensions();
+    Nsamples += run->getNsamples();
+    NlivePoints += run->getNlivePoints();
+    runs.push_back(run);
+}
+
+
+
+
+
+
+
+
+
+
+// PosteriorMerger::merge()
+//
+// PURPOSE:
+//      Merges the points of all the runs by increasing likelihood, and computes the weights
+//      and the evidence of the merged sample. The merged sample is written to a binary
+//      posterior file and, if required, to ASCII files like those written by Results.
+//
+// INPUT:
+//      outputPathPrefix:   path prefix of the output files
+//      writeAsciiFiles:    if true, the parameter values, the log(Likelihood) and the log(Weight)
+//                          values are also written in ASCII format
+//
+// OUTPUT:
+//      void
+//
+// REMARK:
+//      The merged sample is equivalent to a single run whose number of live points at each likelihood
+//      level is the sum of those of the runs at that level (Skilling 2006). This is the number of live points
+//      of the nesting process for a run that is still collecting dead points, and decreases by one
+//      at each of its final live points after that. The prior mass is shrunk by exp(-1/N) at each point
+//      with N live points, and the weights are computed with the trapezoidal rule, as in NestedSampler.
+//      The number of live points of each dead point is the one stored by the run, hence runs that
+//      reduced their live points during the nesting process are merged exactly.
+//      The merged binary posterior file stores the number of live points of every point, and has
+//      no final live points, so that it can be merged again with other runs.
+//
+
+void PosteriorMerger::merge(const string outputPathPrefix, const bool writeAsciiFiles)
+{
+    if (runs.empty())
+    {
+        cerr << "Error: no runs to merge" << endl;
+        exit(EXIT_FAILURE);
+    }
+
+
+    // Open the binary posterior file and write a first header with the sizes of the sample.
+    // The evidence is stored in the header again once the merge is complete.
+
+    BinaryPosteriorHeader header;
+    memset(&header, 0, sizeof(BinaryPosteriorHeader));
+    memcpy(header.magicNumber, BinaryPosteriorFile::magicNumber, sizeof(header.magicNumber));
+    header.version = BinaryPosteriorFile::version;
+    header.byteOrderMark = BinaryPosteriorFile::byteOrderMark;
+    header.dataOffset = sizeof(BinaryPosteriorHeader);
+    header.Ndimensions = Ndimensions;
+    header.Nsamples = Nsamples;
+    header.initialNlivePoints = NlivePoints;
+    header.NfinalLivePoints = 0;
+
+    for (size_t i = 0; i < runs.size(); ++i)
+    {
+        header.Niterations += runs[i]->getNsamples() - runs[i]->getNfinalLivePoints();
+        header.minNlivePoints += runs[i]->getNfinalLivePoints();
+    }
+
+    string fullPath = outputPathPrefix + "posterior.bin";
+    ofstream binaryFile(fullPath.c_str(), ios::out | ios::binary);
+
+    if (!binaryFile.good())
+    {
+        cerr << "Error opening output file " << fullPath << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    binaryFile.write(reinterpret_cast<const char*>(&header), sizeof(BinaryPosteriorHeader));
+
+    const streamoff parameterOffset = header.dataOffset;
+    const streamoff logLikelihoodOffset = parameterOffset + Ndimensions * Nsamples * sizeof(double);
+    const streamoff logWeightOffset = logLikelihoodOffset + Nsamples * sizeof(double);
+    const streamoff NlivePointsOffset = logWeightOffset + Nsamples * sizeof(double);
+
+
+    // Open the ASCII files, if required, with the same names and format as those of Results
+
+    vector<ofstream*> asciiFiles;
+    vector<BufferedAsciiWriter*> asciiWriters;
+
+    if (writeAsciiFiles)
+    {
+        // The Ndimensions+2 writers share a total of 16 characters per buffered point, rather than
+        // having that much each, so that their memory does not grow with the number of dimensions.
+
+        const size_t asciiBufferSize = max(static_cast<size_t>(4096), 16 * static_cast<size_t>(bufferSize) / (Ndimensions + 2));
+        asciiFiles.resize(Ndimensions + 2);
+
+        for (int i = 0; i < Ndimensions + 2; ++i)
+        {
+            ostringstream numberString;
+            numberString << setfill('0') << setw(3) << i;
+
+            if (i < Ndimensions)
+                fullPath = outputPathPrefix + "parameter" + numberString.str() + ".txt";
+            else if (i == Ndimensions)
+                fullPath = outputPathPrefix + "logLikelihood.txt";
+            else
+                fullPath = outputPathPrefix + "logWeight.txt";
+
+            asciiFiles[i] = new ofstream;
+            File::openOutputFile(*asciiFiles[i], fullPath);
+
+            if (i == Ndimensions)
+                *asciiFiles[i] << "# Posterior sample from nested sampling" << endl << "# log(Likelihood)" << endl;
+            else if (i == Ndimensions + 1)
+                *asciiFiles[i] << "# Posterior sample from nested sampling" << endl << "# log(Weight) = log(dX)" << endl;
+
+            *asciiFiles[i] << scientific << setprecision(9);
+            asciiWriters.push_back(new BufferedAsciiWriter(*asciiFiles[i], asciiBufferSize));
+        }
+    }
+
+
+    // The buffers of the four blocks of the binary file. The log(Weight) of each point
+    // is known only once the next point is merged, hence its buffer lags behind by one point.
+
+    vector<double> parameterBuffer(Ndimensions * bufferSize);
+    vector<double> logLikelihoodBuffer(bufferSize);
+    vector<double> NlivePointsBuffer(bufferSize);
+    vector<double> logWeightBuffer(bufferSize);
+    long NwrittenPoints = 0;
+    long NwrittenWeights = 0;
+    int NbufferedPoints = 0;
+    int NbufferedWeights = 0;
+    const string terminator = "\n";
+
+
+    // Fill the queue with the first point of each run, the one with lowest likelihood on top
+
+    typedef pair<double, int> QueueElement;
+    priority_queue<QueueElement, vector<QueueElement>, greater<QueueElement> > queue;
+    int currentNlivePoints = 0;
+
+    for (size_t i = 0; i < runs.size(); ++i)
+    {
+        if (!runs[i]->isExhausted())
+            queue.push(QueueElement(runs[i]->getLogLikelihood(), i));
+
+        currentNlivePoints += runs[i]->getCurrentNlivePoints();
+    }
+
+
+    // Merge the points, starting with the whole prior mass X = 1
+
+    double logPriorMassOneBack = 0.0;           // log(X) of the previous point
+    double logPriorMassTwoBack = 0.0;           // log(X) of the point before the previous one
+    double previousLogLikelihood = 0.0;
+    long Nmerged = 0;
+
+    logEvidence = numeric_limits<double>::lowest();
+    informationGain = 0.0;
+
+    while (Nmerged <= Nsamples)
+    {
+        double logPriorMass = 0.0;
+        int runIndex = -1;
+
+        if (Nmerged < Nsamples)
+        {
+            runIndex = queue.top().second;
+            queue.pop();
+            logPriorMass = logPriorMassOneBack - 1.0/currentNlivePoints;
+        }
+
+
+        // Now that the prior mass of the current point is known, compute the weight of the previous point
+        // with the trapezoidal rule, 0.5*(X_(i-1) - X_(i+1)), taking X = 0 after the last point.
+        // Then update the evidence and the information gain as in NestedSampler.
+
+        if (Nmerged > 0)
+        {
+            double logWeight;
+
+            if (Nmerged < Nsamples)
+                logWeight = log(0.5) + Functions::logExpDifference(logPriorMassTwoBack, logPriorMass);
+            else
+                logWeight = log(0.5) + logPriorMassTwoBack;
+
+            double logEvidenceContributionNew = logWeight + previousLogLikelihood;
+            double logEvidenceNew = Functions::logExpSum(logEvidence, logEvidenceContributionNew);
+            informationGain = exp(logEvidenceContributionNew - logEvidenceNew) * previousLogLikelihood
+                            + exp(logEvidence - logEvidenceNew) * (informationGain + logEvidence)
+                            - logEvidenceNew;
+            logEvidence = logEvidenceNew;
+
+            logWeightBuffer[NbufferedWeights++] = logWeight;
+
+            if (writeAsciiFiles)
+            {
+                asciiWriters[Ndimensions+1]->write(logWeight);
+                asciiWriters[Ndimensions+1]->write(terminator);
+            }
+
+            if (NbufferedWeights == bufferSize)
+            {
+                writeBlock(binaryFile, logWeightOffset + NwrittenWeights * sizeof(double), logWeightBuffer, NbufferedWeights);
+                NwrittenWeights += NbufferedWeights;
+                NbufferedWeights = 0;
+            }
+        }
+
+        if (Nmerged == Nsamples)
+            break;
+
+
+        // Store the current point
+
+        MergeableRun *run = runs[runIndex];
+        const double *parameters = run->getParameters();
+        previousLogLikelihood = run->getLogLikelihood();
+
+        copy(parameters, parameters + Ndimensions, parameterBuffer.begin() + NbufferedPoints * Ndimensions);
+        NlivePointsBuffer[NbufferedPoints] = currentNlivePoints;
+        logLikelihoodBuffer[NbufferedPoints++] = previousLogLikelihood;
+
+        if (writeAsciiFiles)
+        {
+            for (int i = 0; i < Ndimensions; ++i)
+            {
+                asciiWriters[i]->write(parameters[i]);
+                asciiWriters[i]->write(terminator);
+            }
+
+            asciiWriters[Ndimensions]->write(previousLogLikelihood);
+            asciiWriters[Ndimensions]->write(terminator);
+        }
+
+        if (NbufferedPoints == bufferSize)
+        {
+            writeBlock(binaryFile, parameterOffset + NwrittenPoints * Ndimensions * sizeof(double),
+                       parameterBuffer, NbufferedPoints * Ndimensions);
+            writeBlock(binaryFile, logLikelihoodOffset + NwrittenPoints * sizeof(double), logLikelihoodBuffer, NbufferedPoints);
+            writeBlock(binaryFile, NlivePointsOffset + NwrittenPoints * sizeof(double), NlivePointsBuffer, NbufferedPoints);
+            NwrittenPoints += NbufferedPoints;
+            NbufferedPoints = 0;
+        }
+
+
+        // Move to the next point of the same run, and update the total number of live points
+
+        currentNlivePoints -= run->getCurrentNlivePoints();
+        run->next();
+        currentNlivePoints += run->getCurrentNlivePoints();
+
+        if (!run->isExhausted())
+            queue.push(QueueElement(run->getLogLikelihood(), runIndex));
+
+        logPriorMassTwoBack = logPriorMassOneBack;
+        logPriorMassOneBack = logPriorMass;
+        Nmerged++;
+    }
+
+
+    // Compute Skilling's error on the log(Evidence), using the total number of live points
+
+    logEvidenceError = sqrt(fabs(informationGain)/NlivePoints);
+
+
+    // Write the points left in the buffers, and the final header
+
+    writeBlock(binaryFile, parameterOffset + NwrittenPoints * Ndimensions * sizeof(double),
+               parameterBuffer, NbufferedPoints * Ndimensions);
+    writeBlock(binaryFile, logLikelihoodOffset + NwrittenPoints * sizeof(double), logLikelihoodBuffer, NbufferedPoints);
+    writeBlock(binaryFile, NlivePointsOffset + NwrittenPoints * sizeof(double), NlivePointsBuffer, NbufferedPoints);
+    writeBlock(binaryFile, logWeightOffset + NwrittenWeights * sizeof(double), logWeightBuffer, NbufferedWeights);
+
+    header.logEvidence = logEvidence;
+    header.logEvidenceError = logEvidenceError;
+    header.informationGain = informationGain;
+    binaryFile.seekp(0);
+    binaryFile.write(reinterpret_cast<const char*>(&header), sizeof(BinaryPosteriorHeader));
+
+    if (!binaryFile.good())
+    {
+        cerr << "Error writing output file " << outputPathPrefix << "posterior.bin" << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    binaryFile.close();
+
+    for (size_t i = 0; i < asciiWriters.size(); ++i)
+    {
+        delete asciiWriters[i];
+        delete asciiFiles[i];
+    }
+
+
+    // Write the evidence and the configuration of the merged sample
+
+    ofstream outputFile;
+    File::openOutputFile(outputFile, outputPathPrefix + "evidenceInformation.txt");
+    outputFile << "# Evidence results from nested sampling" << endl;
+    outputFile << scientific << setprecision(9);
+    outputFile << "# Skilling's log(Evidence)" << setw(40) << "Skilling's Error log(Evidence)"
+    << setw(40) << "Skilling's Information Gain" << endl;
+    outputFile << logEvidence << setw(40) << logEvidenceError << setw(40) << informationGain << endl;
+    outputFile.close();
+
+    File::openOutputFile(outputFile, outputPathPrefix + "mergedConfiguringParameters.txt");
+    outputFile << "# List of configuring parameters deriving from the merging of multiple runs." << endl;
+    outputFile << "# Row #1: Ndimensions" << endl;
+    outputFile << "# Row #2: Nruns" << endl;
+    outputFile << "# Row #3: Total NlivePoints" << endl;
+    outputFile << "# Row #4: Total Nsamples" << endl;
+    outputFile << Ndimensions << endl;
+    outputFile << runs.size() << endl;
+    outputFile << NlivePoints << endl;
+    outputFile << Nsamples << endl;
+    outputFile.close();
+}
+
+
+
+
+
+
+
+
+
+
+// PosteriorMerger::getNruns()
+//
+// PURPOSE:
+//      Gets the number of runs to merge.
+//
+// OUTPUT:
+//      An integer containing the number of runs.
+//
+
+int PosteriorMerger::getNruns()
+{
+    return runs.size();
+}
+
+
+
+
+
+
+
+
+
+
+// PosteriorMerger::getNdimensions()
+//
+// PURPOSE:
+//      Gets the number of free parameters of the runs.
+//
+// OUTPUT:
+//      An integer containing the number of dimensions.
+//
+
+int PosteriorMerger::getNdimensions()
+{
+    return Ndimensions;
+}
+
+
+
+
+
+
+
+
+
+
+// PosteriorMerger::getNsamples()
+//
+// PURPOSE:
+//      Gets the number of points of the merged posterior sample.
+//
+// OUTPUT:
+//      An integer containing the total number of points of the runs.
+//
+
+long PosteriorMerger::getNsamples()
+{
+    return Nsamples;
+}
+
+
+
+
+
+
+
+
+
+
+// PosteriorMerger::getNlivePoints()
+//
+// PURPOSE:
+//      Gets the total number of live points of the runs.
+//
+// OUTPUT:
+//      An integer containing the number of live points.
+//
+
+int PosteriorMerger::getNlivePoints()
+{
+    return NlivePoints;
+}
+
+
+
+
+
+
+
+
+
+
+// PosteriorMerger::getLogEvidence()
+//
+// PURPOSE:
+//      Gets the log(Evidence) of the merged sample, as computed by merge().
+//
+// OUTPUT:
+//      A double containing the log(Evidence).
+//
+
+double PosteriorMerger::getLogEvidence()
+{
+    return logEvidence;
+}
+
+
+
+
+
+
+
+
+
+
+// PosteriorMerger::getLogEvidenceError()
+//
+// PURPOSE:
+//      Gets Skilling's error on the log(Evidence) of the merged sample, as computed by merge().
+//
+// OUTPUT:
+//      A double containing the error on log(Evidence).
+//
+
+double PosteriorMerger::getLogEvidenceError()
+{
+    return logEvidenceError;
+}
+
+
+
+
+
+
+
+
+
+
+// PosteriorMerger::getInformationGain()
+//
+// PURPOSE:
+//      Gets the information gain of the merged sample, as computed by merge().
+//
+// OUTPUT:
+//      A double containing the information gain.
+//
+
+double PosteriorMerger::getInformationGain()
+{
+    return informationGain;
+}
+
+
+
+
+
+
+
+
+
+
+// PosteriorMerger::writeBlock()
+//
+// PURPOSE:
+//      Writes the content of a buffer at a given position of the binary posterior file.
+//
+// INPUT:
+//      outputFile:     the binary posterior file, already opened
+//      offset:         position in the file, in bytes, where the first value is written
+//      buffer:         the values to write
+//      Nvalues:        the number of values of the buffer to write
+//
+// OUTPUT:
+//      void
+//
+
+void PosteriorMerger::writeBlock(ofstream &outputFile, const streamoff offset, const vector<double> &buffer, const size_t Nvalues)
+{
+    if (Nvalues == 0)
+        return;
+
+    outputFile.seekp(offset);
+    outputFile.write(reinterpret_cast<const char*>(buffer.data()), Nvalues * sizeof(double));
+}
@@ -10,13 +10,28 @@
 //      of dimensions to be explicitly printed on the screen.
 //      scalingFactor: a double specifying the value of the scaling of the average eigenvalue (according to the correction
 //      applied by Jolliffe to the Kaiser-Guttman test. A value of 0.7 is set by default.
+//      incrementalUpdateActivated: a boolean specifying whether the principal components found at the previous call
+//      are to be updated with a few subspace iterations, instead of decomposing the full correlation matrix.
+//      NoversamplingDimensions: the number of principal components kept in the basis in addition to the retained ones,
+//      so that components entering the retained set can be found by the update.
+//      NsubspaceIterations: the number of subspace iterations done for each update of the basis.
+//      seed: the seed of the random generator of the new vectors of the basis. If 0, the clock is used.
 //
 
-PrincipalComponentProjector::PrincipalComponentProjector(bool printNdimensions, double scalingFactor)
+PrincipalComponentProjector::PrincipalComponentProjector(bool printNdimensions, double scalingFactor, bool incrementalUpdateActivated,
+                                                         unsigned int NoversamplingDimensions, unsigned int NsubspaceIterations,
+                                                         unsigned int seed)
 : Projector(printNdimensions),
-  scalingFactor(scalingFactor)
+  scalingFactor(scalingFactor),
+  incrementalUpdateActivated(incrementalUpdateActivated),
+  NoversamplingDimensions(NoversamplingDimensions),
+  NsubspaceIterations(NsubspaceIterations),
+  basisIsAvailable(false)
 {
+    // Set the seed of the random generator, using the clock if none is given
 
+    clock_t clockticks = clock();
+    engine.seed(seed != 0 ? seed : clockticks);
 }
 
 
@@ -29,37 +44,24 @@ PrincipalComponentProjector::PrincipalComponentProjector(bool printNdimensions,
 
 
 
-// PrincipalComponentProjector::projection()
+// PrincipalComponentProjector::computeFullBasis()
 //
 // PURPOSE: 
-//      Given a sample of N-dimensional points, use the linear Principal Component Analysis
-//      to identify the principal components (PCs) of the original dataset. Subsequently select
-//      only those component that contain the largest amount of variance in the data through the
-//      Kaiser-Guttman test, modified by Jolliffe (1972) to consider PCs having eigenvalues > 70% of the average eigenvalue.
-//      
+//      Compute the eigenvalues and eigenvectors of the full correlation matrix of the sample, and 
+//      select the principal components that pass the Kaiser-Guttman test, modified by Jolliffe (1972) 
+//      to consider PCs having eigenvalues > 70% of the average eigenvalue. The retained components,
+//      together with NoversamplingDimensions further ones, are stored as the basis.
+//      This takes O(Npoints Ndimensions^2 + Ndimensions^3) operations.
 //
 // INPUT:
-//      sample(Ndimensions, Npoints): sample of N-dimensional points
+//      differenceFromCenters(Ndimensions, Npoints): the coordinates of the points relative to the sample mean
 // 
 // OUTPUT:
-//      The reduced k-dimensional sample, with k <= N, but having the same number of points.
+//      void
 //
 
-ArrayXXd PrincipalComponentProjector::projection(RefArrayXXd sample)
+void PrincipalComponentProjector::computeFullBasis(RefArrayXXd differenceFromCenters)
 {
-    Ndimensions = sample.rows();
-    Npoints = sample.cols();
-  
-    
-    // Evaluate the center of the sample (sample mean) in each dimensions
-    
-    ArrayXd sampleMean(Ndimensions);
-    sampleMean = sample.rowwise().mean();       // Column array containing mean values for each dimension
-    
-    ArrayXXd differenceFromCenters(Ndimensions, Npoints);
-    differenceFromCenters = sample.colwise() - sampleMean;
-
-    
     // Evaluate the covariance matrix of the entire sample (N-dimensional matrix)
     
     double biasFactor = 1.0/(Npoints-1.0);
@@ -93,32 +95,188 @@ ArrayXXd PrincipalComponentProjector::projection(RefArrayXXd sample)
         cerr << "Error in decomposition from PCA correlation matrix." << endl;
         abort();
     }
-    
-
-    // Sort eigenvalues in decreasing order, and eigenvectors accordingly
-
-    ArrayXXd zetaScores(Ndimensions, Npoints);
-    zetaScores = eigenvectors.matrix().transpose() * sample.matrix();
 
 
     // Compute predictions for the given dimension according to the Kaiser-Guttman test modified by Jolliffe
 
     double scaledAverageEigenvalue = scalingFactor*eigenvalues.mean();
     reducedNdimensions = ((eigenvalues - scaledAverageEigenvalue) > 0).count();
-    ArrayXXd reducedSample(reducedNdimensions, Npoints);
+
+
+    // Store the eigenvectors with the largest eigenvalues, in decreasing order of eigenvalue
+
+    int Nbasis = min(reducedNdimensions + int(NoversamplingDimensions), Ndimensions);
+    basis = eigenvectors.rightCols(Nbasis).rowwise().reverse().matrix();
+    basisIsAvailable = true;
+}
+
+
+
+
+
+
+
+
+
+
+
+// PrincipalComponentProjector::updateBasis()
+//
+// PURPOSE: 
+//      Update the basis of principal components found at the previous call, for a sample that 
+//      changed only partially since then (e.g. a few live points replaced). The basis is refined with 
+//      NsubspaceIterations iterations of the subspace (block power) method, followed by a
+//      Rayleigh-Ritz projection of the correlation matrix on the refined basis. The correlation
+//      matrix is never formed: it is only applied to the basis, which takes 
+//      O(Npoints Ndimensions Nbasis) operations, where Nbasis is the number of basis vectors.
+//      Since the trace of the correlation matrix equals Ndimensions, its average eigenvalue is 1,
+//      hence the Kaiser-Guttman test does not need all the eigenvalues.
+//
+// INPUT:
+//      differenceFromCenters(Ndimensions, Npoints): the coordinates of the points relative to the sample mean
+// 
+// OUTPUT:
+//      True if the basis was updated, false if a full decomposition is needed, i.e. if 
+//      all the components of the basis passed the test, so that more components may pass it.
+//
+
+bool PrincipalComponentProjector::updateBasis(RefArrayXXd differenceFromCenters)
+{
+    double biasFactor = 1.0/(Npoints-1.0);
+    VectorXd inverseStandardDeviations = (differenceFromCenters.square().rowwise().sum() * biasFactor).sqrt().inverse().matrix();
+    int Nbasis = basis.cols();
+
+
+    // Refine the basis by repeatedly applying the correlation matrix and orthonormalizing. The 
+    // standardization of the coordinates is applied to the (small) basis rather than to the sample.
+
+    MatrixXd orthonormalBasis = basis;
+
+    for (unsigned int iteration = 0; iteration < NsubspaceIterations; ++iteration)
+    {
+        MatrixXd projectedDifference = differenceFromCenters.matrix().transpose() * (inverseStandardDeviations.asDiagonal() * orthonormalBasis);
+        MatrixXd correlationTimesBasis = inverseStandardDeviations.asDiagonal() * (differenceFromCenters.matrix() * projectedDifference) * biasFactor;
+        HouseholderQR<MatrixXd> decomposition(correlationTimesBasis);
+        orthonormalBasis = decomposition.householderQ() * MatrixXd::Identity(Ndimensions, Nbasis);
+    }
+
+
+    // Decompose the correlation matrix restricted to the basis. Eigenvalues are in increasing order.
+
+    MatrixXd projectedDifference = differenceFromCenters.matrix().transpose() * (inverseStandardDeviations.asDiagonal() * orthonormalBasis);
+    MatrixXd reducedCorrelationMatrix = projectedDifference.transpose() * projectedDifference * biasFactor;
+    SelfAdjointEigenSolver<MatrixXd> eigenSolver(reducedCorrelationMatrix);
+
+    if (eigenSolver.info() != Success)
+    {
+        return false;
+    }
+
+    double scaledAverageEigenvalue = scalingFactor * 1.0;
+    int NretainedDimensions = (eigenSolver.eigenvalues().array() > scaledAverageEigenvalue).count();
+
+    if ((NretainedDimensions == Nbasis) && (Nbasis < Ndimensions))
+    {
+        return false;
+    }
+
+    reducedNdimensions = NretainedDimensions;
+    basis = (orthonormalBasis * eigenSolver.eigenvectors()).rowwise().reverse();
+
+
+    // Adapt the size of the basis to the number of retained components. Missing vectors are 
+    // random, and will be aligned with the principal components by the next update. They are drawn
+    // from the generator of the projector, rather than from the global (unseeded, shared) std::rand().
+
+    int NnewBasis = min(reducedNdimensions + int(NoversamplingDimensions), Ndimensions);
+
+    if (NnewBasis < Nbasis)
+    {
+        basis.conservativeResize(NoChange, NnewBasis);
+    }
+    else if (NnewBasis > Nbasis)
+    {
+        basis.conservativeResize(NoChange, NnewBasis);
+        normal_distribution<double> normal(0.0, 1.0);
+
+        for (int j = Nbasis; j < NnewBasis; ++j)
+        {
+            for (int i = 0; i < Ndimensions; ++i)
+            {
+                basis(i, j) = normal(engine);
+            }
+        }
+    }
+
+    return true;
+}
+
+
+
+
+
+
+
+
+
+
+
+// PrincipalComponentProjector::projection()
+//
+// PURPOSE: 
+//      Given a sample of N-dimensional points, use the linear Principal Component Analysis
+//      to identify the principal components (PCs) of the original dataset. Subsequently select
+//      only those component that contain the largest amount of variance in the data through the
+//      Kaiser-Guttman test, modified by Jolliffe (1972) to consider PCs having eigenvalues > 70% of the average eigenvalue.
+//      If the incremental update is activated, the PCs found at the previous call are updated rather than
+//      recomputed from scratch. Only the retained PCs are used to compute the zeta scores.
+//
+// INPUT:
+//      sample(Ndimensions, Npoints): sample of N-dimensional points
+// 
+// OUTPUT:
+//      The reduced k-dimensional sample, with k <= N, but having the same number of points.
+//
+
+ArrayXXd PrincipalComponentProjector::projection(RefArrayXXd sample)
+{
+    Ndimensions = sample.rows();
+    Npoints = sample.cols();
   
+    
+    // Evaluate the center of the sample (sample mean) in each dimensions
+    
+    ArrayXd sampleMean(Ndimensions);
+    sampleMean = sample.rowwise().mean();       // Column array containing mean values for each dimension
+    
+    ArrayXXd differenceFromCenters(Ndimensions, Npoints);
+    differenceFromCenters = sample.colwise() - sampleMean;
+
 
-    // Consider a subset of the original sample with a number of features (dimensions) equal to reducedNdimensions,
-    // and take the zeta scores corresponding to the largest eigenvalues found, associated to the retained PCs
+    // Find the principal components, updating the previous ones if possible
 
-    reducedSample = zetaScores.block(Ndimensions-reducedNdimensions,0,reducedNdimensions,Npoints);
+    bool basisIsUpdated = false;
+
+    if (incrementalUpdateActivated && basisIsAvailable && (basis.rows() == Ndimensions))
+    {
+        basisIsUpdated = updateBasis(differenceFromCenters);
+    }
+
+    if (!basisIsUpdated)
+    {
+        computeFullBasis(differenceFromCenters);
+    }
 
     if (printNdimensions)
     {
         cout << "Number of effective dimensions from PCA: " << reducedNdimensions << endl;
     }
 
-    // Return the reduced sample with scores orderder by decreasing eigenvalue
 
-    return reducedSample.colwise().reverse();
+    // Return the zeta scores of the retained PCs only, orderded by decreasing eigenvalue
+
+    ArrayXXd reducedSample(reducedNdimensions, Npoints);
+    reducedSample = (basis.leftCols(reducedNdimensions).transpose() * sample.matrix()).array();
+
+    return reducedSample;
 }
@@ -93,6 +93,48 @@ ArrayXd Results::posteriorProbability()
 
 
 
+// Results::getNlivePointsOfDeadPoints()
+//
+// PURPOSE:
+//      Gets the number of live points used to shrink the prior mass at each dead point
+//      of the posterior sample, i.e. at each iteration of the nesting process.
+//
+// OUTPUT:
+//      An Eigen Array with one element per dead point, i.e. per point of the posterior sample
+//      except the final live points.
+// 
+// REMARK:
+//      If the nesting process stopped before storing the number of live points of its last dead point,
+//      the last stored number is used for it, as in simulatePriorVolumes().
+//
+
+ArrayXi Results::getNlivePointsOfDeadPoints()
+{
+    const vector<int> &NlivePointsPerIteration = nestedSampler.getNlivePointsPerIteration();
+    const int NfinalLivePoints = nestedSampler.getNlivePoints();
+    const int NdeadPoints = nestedSampler.getPosteriorSample().cols() - NfinalLivePoints;
+    const int lastNlivePoints = NlivePointsPerIteration.empty() ? NfinalLivePoints : NlivePointsPerIteration.back();
+
+    ArrayXi NlivePointsOfDeadPoints(NdeadPoints);
+
+    for (int i = 0; i < NdeadPoints; ++i)
+    {
+        NlivePointsOfDeadPoints(i) = (i < static_cast<int>(NlivePointsPerIteration.size())) ? NlivePointsPerIteration[i] : lastNlivePoints;
+    }
+
+    return NlivePointsOfDeadPoints;
+}
+
+
+
+
+
+
+
+
+
+
+
 // Results:writeMarginalDistributionToFile()
 //
 // PURPOSE:
@@ -161,7 +203,8 @@ void Results::writeMarginalDistributionToFile(const int parameterNumber)
 // INPUT:
 //      credibleLevel:              a double number providing the desired credible 
 //                                  level to be computed.
-//      skewness:                   the skewness of the sample distribution
+//      skewness:                   the skewness of the sample distribution. It is no longer needed, since the
+//                                  shortest interval is found exactly, and is kept for compatibility.
 //      NinterpolationsPerBin:      an integer containing the number of desired points to interpolate between.
 //                                  two consecutive input data points.
 //      
@@ -173,6 +216,7 @@ void Results::writeMarginalDistributionToFile(const int parameterNumber)
 //      The input number of interpolated points is to be considered as an estimate of the real number of interpolations occurring.
 //      This is because the number of interpolations also depends on the spacing of the input grid for each bin, which is
 //      not required to be regular.
+//      The cost is linear in the number of interpolated points, both for the spline and for the search of the interval.
 //
 
 ArrayXd Results::computeCredibleLimits(const double credibleLevel, const double skewness, const int NinterpolationsPerBin)
@@ -238,138 +282,292 @@ ArrayXd Results::computeCredibleLimits(const double credibleLevel, const double
 
     // Compute the "shortest" credible intervals (CI) and save the corresponding credible limits
 
-    int max = 0;
-    marginalDistributionMode = marginalDistributionInterpolated.maxCoeff(&max);
-    int NbinsLeft = max + 1;
-    int NbinsRight = Ninterpolations - NbinsLeft;
-    ArrayXd marginalDistributionLeft(NbinsLeft);        // Marginal distribution up to modal value (included)
-    ArrayXd parameterValuesLeft(NbinsLeft);             // Parameter range up to modal value (included)
-    ArrayXd marginalDistributionRight(NbinsRight);      // Marginal distribution beyond modal value 
-    ArrayXd parameterValuesRight(NbinsRight);           // Parameter range beyond modal value
-    double limitProbabilityRight = marginalDistributionInterpolated(max);
-    double limitParameterRight = parameterValuesInterpolated(max);
-    double limitProbabilityLeft = limitProbabilityRight;
-    double limitParameterLeft = limitParameterRight;
-
-
-    // Difference distribution to find point belonging to the distribution to the left (right)
-    // of the mode having closest probability to that identified in the part of the
-    // distribution to the right (left) of the mode.
-
-    ArrayXd marginalDifferenceLeft = ArrayXd::Zero(NbinsLeft);          
-    ArrayXd marginalDifferenceRight = ArrayXd::Zero(NbinsRight);          
-                                                
-
-    // Copy left- and right-hand part of total marginal distributon into separate arrays.
-    // Also copy the corresponding parameter values inro separate arrays.
-    // Since parameterValues is already sorted in ascending order this can be done quickly.
-
-    marginalDistributionLeft = marginalDistributionInterpolated.segment(0, NbinsLeft);
-    marginalDistributionRight = marginalDistributionInterpolated.segment(NbinsLeft, NbinsRight);
-    parameterValuesLeft = parameterValuesInterpolated.segment(0, NbinsLeft);
-    parameterValuesRight = parameterValuesInterpolated.segment(NbinsLeft, NbinsRight);
-
-
-    // Count number of steps (bins) in the distribution to the right (left) side of its modal value.
-    // Define the limit probability on the right-(left-)hand distribution and the corresponding 
-    // value of the parameter. Then compute the difference of the left-(right-)hand distribution 
-    // with the right (left) limit probability. Finally find the point in the left (right) part 
-    // having closest probability to the right (left) limit, save its probability and the corresponding 
-    // value of the parameter. Cumulate the probability within the range and repeat the process until 
-    // probability >= probability(credibleLevel). The skenwess is adopted to select the direction 
-    // of the iterative process for a more optimal computation of the shortest CI. 
-    // For skewness < 0, the distribution is asymmetric to the left, hence the step is towards the left side.
-    // For skewness > 0, the distribution is asymmetric to the right, hence the step is towards the right side.
-
-    int min = 0;
+    marginalDistributionMode = marginalDistributionInterpolated.maxCoeff();
+
+
+    // Cumulate the marginal distribution once, so that the probability contained in any 
+    // interval is obtained as a difference of two cumulated values
+
+    ArrayXd cumulatedProbability(Ninterpolations + 1);
+    cumulatedProbability(0) = 0.0;
+
+    for (int j = 0; j < Ninterpolations; ++j)
+    {
+        cumulatedProbability(j+1) = cumulatedProbability(j) + marginalDistributionInterpolated(j);
+    }
+
+
+    // Find the shortest interval containing at least the credible level with a two-pointer sweep.
+    // For each left edge, the right edge is the first point such that the interval contains the credible level.
+    // Since this right edge can only move to the right when the left edge does, both edges scan 
+    // the distribution once, whatever its shape (e.g. with the small wiggles of the cubic spline). 
+    // The interpolated grid is regular, hence the length of an interval is given by its number of points.
+    // Among intervals of the same length, the one containing the largest probability is kept.
+
     double credibleLevelFraction = credibleLevel/100.;
-    double totalProbability = 0.0;
+    int leftIndexOfShortestInterval = 0;
+    int rightIndexOfShortestInterval = Ninterpolations - 1;
+    double probabilityOfShortestInterval = cumulatedProbability(Ninterpolations);
+    int rightIndex = 0;
 
-    if (skewness >= 0.0)
+    for (int leftIndex = 0; leftIndex < Ninterpolations; ++leftIndex)
     {
-        int stepRight = 0;          
-        
-        while (totalProbability < (credibleLevelFraction) && (NbinsLeft + stepRight < Ninterpolations))             
+        rightIndex = std::max(rightIndex, leftIndex);
+
+        while ((rightIndex < Ninterpolations) && 
+               (cumulatedProbability(rightIndex + 1) - cumulatedProbability(leftIndex) < credibleLevelFraction))
         {
-            totalProbability = 0.0;
+            ++rightIndex;
+        }
 
 
-            // Find the probability and the corresponding value of the parameter at the right edge of the interval
+        // No interval starting further to the right can contain the credible level
 
-            limitProbabilityRight = marginalDistributionInterpolated(NbinsLeft + stepRight);  
-            limitParameterRight = parameterValuesInterpolated(NbinsLeft + stepRight);         
+        if (rightIndex == Ninterpolations) break;
 
-            
-            // Find which point in the left part is the closest in probability to that of the right edge.
+        double intervalProbability = cumulatedProbability(rightIndex + 1) - cumulatedProbability(leftIndex);
+        int intervalLength = rightIndex - leftIndex;
+        int shortestIntervalLength = rightIndexOfShortestInterval - leftIndexOfShortestInterval;
+
+        if ((intervalLength < shortestIntervalLength) || 
+            ((intervalLength == shortestIntervalLength) && (intervalProbability > probabilityOfShortestInterval)))
+        {
+            leftIndexOfShortestInterval = leftIndex;
+            rightIndexOfShortestInterval = rightIndex;
+            probabilityOfShortestInterval = intervalProbability;
+        }
+    }
+
+    double limitParameterLeft = parameterValuesInterpolated(leftIndexOfShortestInterval);
+    double limitParameterRight = parameterValuesInterpolated(rightIndexOfShortestInterval);
+
+    ArrayXd credibleLimits(2);
+    credibleLimits << limitParameterLeft, limitParameterRight; 
+    
+    return credibleLimits;
+}
 
-            marginalDifferenceLeft = (marginalDistributionLeft - limitProbabilityRight).abs();                                      
-            limitProbabilityLeft = marginalDifferenceLeft.minCoeff(&min);       
 
 
-            // Save the point and its probability as the left edge of the searching interval
 
-            limitProbabilityLeft = marginalDistributionLeft(min);
-            limitParameterLeft = parameterValuesLeft(min);
 
 
-            // Cumulate the probability within the identified interval
 
-            int intervalSize = NbinsLeft + stepRight - min;
-            totalProbability = marginalDistributionInterpolated.segment(min, intervalSize).sum();
 
 
-            // Move one step further to the right
 
-            ++stepRight;
-        }
+
+
+
+
+// Results::computeScottBinning()
+//
+// PURPOSE:
+//      Computes the bin width and the number of bins for rebinning a marginal distribution,
+//      according to Scott's normal reference rule (most efficient for Gaussian-shaped distributions).
+//
+// INPUT:
+//      secondMoment:       the second moment of the marginal distribution
+//      sampleSize:         the number of points of the posterior sample
+//      parameterMinimum:   the smallest value of the parameter in the sample
+//      parameterMaximum:   the largest value of the parameter in the sample
+//      maxNbins:           the largest number of bins allowed
+//      Nbins:              set to the number of bins
+//      binWidth:           set to the width of the bins. The last bin extends up to parameterMaximum.
+//
+// OUTPUT:
+//      void
+//
+
+void Results::computeScottBinning(const double secondMoment, const int sampleSize, const double parameterMinimum, 
+                                  const double parameterMaximum, const int maxNbins, int &Nbins, double &binWidth)
+{
+    binWidth = 3.5*sqrt(secondMoment)/pow(sampleSize,1.0/3.0);
+    Nbins = floor((parameterMaximum - parameterMinimum)/binWidth) - 1;
+
+    if (Nbins > maxNbins)
+    {
+        // If it happens that the number of bins is too large, reduce it to a fixed value
+
+        Nbins = maxNbins;
+        binWidth = (parameterMaximum - parameterMinimum)/(Nbins*1.0);
     }
-    else
+}
+
+
+
+
+
+
+
+
+
+
+
+// Results::computeKernelDensityEstimate()
+//
+// PURPOSE:
+//      Computes a Gaussian kernel density estimate of a weighted marginal distribution on a regular grid.
+//      The weights are first assigned to the grid by linear binning, and the binned values are then 
+//      convolved with the kernel by means of fast Fourier transforms, so that the cost is O(N + G log G)
+//      for N points and G grid points. The bandwidth is selected with the two-stage direct plug-in 
+//      rule by Sheather & Jones (1991), in the form given by Wand & Jones (1995), where the 
+//      density functionals are themselves estimated from the binned values.
+//
+// INPUT:
+//      parameterValues:        the parameter values of the posterior sample, sorted in ascending order
+//      marginalDistribution:   the posterior probability of each point of the sample
+//      Ngrid:                  the number of grid points
+//      gridValues:             set to the parameter values of the grid, spanning the range of the
+//                              sample, extended by three times the normal reference bandwidth on both sides.
+//      gridProbability:        set to the probability of each grid point, with sum equal to 1.
+//
+// OUTPUT:
+//      void
+//
+// REMARK:
+//      Since the points are weighted, the number of points entering the bandwidth rules is the 
+//      effective sample size 1/sum(w^2) of the normalized weights, rather than the size of the sample.
+//      If the estimated density functionals do not have the expected sign, e.g. for a
+//      too small effective sample, the normal reference bandwidth is used instead.
+//
+
+void Results::computeKernelDensityEstimate(RefArrayXd const parameterValues, RefArrayXd const marginalDistribution, const int Ngrid,
+                                           ArrayXd &gridValues, ArrayXd &gridProbability)
+{
+    int sampleSize = parameterValues.size();
+    assert(marginalDistribution.size() == sampleSize);
+    assert(Ngrid > 1);
+
+    ArrayXd weights = marginalDistribution / marginalDistribution.sum();
+    double effectiveSampleSize = 1.0 / weights.square().sum();
+
+
+    // Estimate the scale of the distribution as the smaller of the standard deviation and of the
+    // interquartile range rescaled to a normal distribution, which is robust against long tails
+
+    double mean = (parameterValues * weights).sum();
+    double standardDeviation = sqrt(((parameterValues - mean).square() * weights).sum());
+    double parameterMinimum = parameterValues(0);
+    double parameterMaximum = parameterValues(sampleSize - 1);
+    double lowerQuartile = parameterMinimum;
+    double upperQuartile = parameterMaximum;
+    double cumulatedWeight = 0.0;
+
+    for (int j = 0; j < sampleSize; ++j)
     {
-        int stepLeft = 0;          
-        
-        while (totalProbability < (credibleLevelFraction) && (stepLeft < NbinsLeft))             
+        double previousWeight = cumulatedWeight;
+        cumulatedWeight += weights(j);
+
+        if (previousWeight < 0.25 && cumulatedWeight >= 0.25)
+            lowerQuartile = parameterValues(j);
+
+        if (previousWeight < 0.75 && cumulatedWeight >= 0.75)
         {
-            totalProbability = 0.0;
+            upperQuartile = parameterValues(j);
+            break;
+        }
+    }
 
+    double scale = standardDeviation;
+    double interquartileScale = (upperQuartile - lowerQuartile)/1.349;
 
-            // Find the probability and the corresponding value of the parameter at the left edge of the interval
+    if (interquartileScale > 0.0 && interquartileScale < scale)
+        scale = interquartileScale;
 
-            limitProbabilityLeft = marginalDistributionInterpolated(NbinsLeft - stepLeft - 1);  
-            limitParameterLeft = parameterValuesInterpolated(NbinsLeft - stepLeft - 1);         
+    if (scale <= 0.0)
+        scale = (parameterMaximum - parameterMinimum)/4.0;
 
-            
-            // Find which point in the right part is the closest in probability to that of the left edge.
+    double normalReferenceBandwidth = 1.059 * scale * pow(effectiveSampleSize, -0.2);
 
-            marginalDifferenceRight = (marginalDistributionRight - limitProbabilityLeft).abs();                                      
-            limitProbabilityRight = marginalDifferenceRight.minCoeff(&min);       
 
+    // Set up the grid and assign each weight to its two neighbouring grid points (linear binning)
 
-            // Save the point and its probability as the right edge of the searching interval
+    double gridMinimum = parameterMinimum - 3.0*normalReferenceBandwidth;
+    double gridMaximum = parameterMaximum + 3.0*normalReferenceBandwidth;
+    double gridStep = (gridMaximum - gridMinimum)/(Ngrid - 1);
+    ArrayXd binnedWeights = ArrayXd::Zero(Ngrid);
 
-            limitProbabilityRight = marginalDistributionRight(min);
-            limitParameterRight = parameterValuesRight(min);
+    for (int j = 0; j < sampleSize; ++j)
+    {
+        double position = (parameterValues(j) - gridMinimum)/gridStep;
+        int index = min(max(static_cast<int>(floor(position)), 0), Ngrid - 2);
+        double fraction = min(max(position - index, 0.0), 1.0);
+
+        binnedWeights(index) += weights(j) * (1.0 - fraction);
+        binnedWeights(index + 1) += weights(j) * fraction;
+    }
+
+    gridValues.resize(Ngrid);
 
+    for (int k = 0; k < Ngrid; ++k)
+        gridValues(k) = gridMinimum + k*gridStep;
 
-            // Cumulate the probability within the identified interval
 
-            int intervalSize = min + stepLeft;
-            totalProbability = marginalDistributionInterpolated.segment(NbinsLeft - stepLeft, intervalSize).sum();
+    // Two-stage plug-in bandwidth. The density functional psi_r = E[f^(r)(X)] is estimated as the sum over the grid 
+    // of the binned weights times their convolution with the r-th derivative of a Gaussian kernel of width g.
+    // The pilot widths g come from the asymptotically optimal values, starting from the normal reference for psi_8.
 
+    const double sqrtPi = sqrt(Functions::PI);
+
+    auto estimateDensityFunctional = [&](const int order, const double pilotBandwidth) -> double
+    {
+        int maxLag = min(static_cast<int>(ceil((4.0 + order)*pilotBandwidth/gridStep)), Ngrid - 1);
+        ArrayXd kernel(maxLag + 1);
+
+        for (int lag = 0; lag <= maxLag; ++lag)
+        {
+            double z = lag*gridStep/pilotBandwidth;
+            double z2 = z*z;
+            double hermitePolynomial;
 
-            // Move one step further to the left
+            if (order == 4)
+                hermitePolynomial = (z2 - 6.0)*z2 + 3.0;
+            else
+                hermitePolynomial = ((z2 - 15.0)*z2 + 45.0)*z2 - 15.0;
 
-            ++stepLeft;
+            kernel(lag) = hermitePolynomial * exp(-0.5*z2) / (sqrt(2.0*Functions::PI) * pow(pilotBandwidth, order + 1));
         }
+
+        ArrayXd convolvedWeights = Functions::symmetricConvolution(binnedWeights, kernel);
+        
+        return (binnedWeights * convolvedWeights).sum();
+    };
+
+    double psi8 = 105.0 / (32.0 * sqrtPi * pow(scale, 9));
+    double pilotBandwidth6 = pow(30.0 / (sqrt(2.0*Functions::PI) * psi8 * effectiveSampleSize), 1.0/9.0);
+    double psi6 = estimateDensityFunctional(6, pilotBandwidth6);
+    double bandwidth = normalReferenceBandwidth;
+
+    if (psi6 < 0.0)
+    {
+        double pilotBandwidth4 = pow(-3.0 * sqrt(2.0/Functions::PI) / (psi6 * effectiveSampleSize), 1.0/7.0);
+        double psi4 = estimateDensityFunctional(4, pilotBandwidth4);
+
+        if (psi4 > 0.0)
+            bandwidth = pow(1.0 / (2.0 * sqrtPi * psi4 * effectiveSampleSize), 0.2);
+    }
+
+
+    // Convolve the binned weights with the Gaussian kernel of the selected bandwidth, truncated at five bandwidths
+
+    int maxLag = min(static_cast<int>(ceil(5.0*bandwidth/gridStep)), Ngrid - 1);
+    ArrayXd kernel(maxLag + 1);
+
+    for (int lag = 0; lag <= maxLag; ++lag)
+    {
+        double z = lag*gridStep/bandwidth;
+        kernel(lag) = exp(-0.5*z*z);
     }
-    
-    ArrayXd credibleLimits(2);
-    credibleLimits << limitParameterLeft, limitParameterRight; 
-    
-    return credibleLimits;
-}
 
+    gridProbability = Functions::symmetricConvolution(binnedWeights, kernel);
 
 
+    // Remove the small negative values due to the round-off errors of the transforms, and normalize to unit sum
+
+    gridProbability = gridProbability.max(0.0);
+    gridProbability /= gridProbability.sum();
+}
 
 
 
@@ -394,6 +592,9 @@ ArrayXd Results::computeCredibleLimits(const double credibleLevel, const double
 //                                  credible level of 68.27 %.
 //      writeMarginalDistribution:  a boolean variable specifying whether the marginal distribution for
 //                                  each parameter has to be written in an output file.
+//      useKernelDensityEstimation: a boolean variable specifying whether the marginal distributions are
+//                                  obtained from a kernel density estimate, rather than from the average
+//                                  of shifted rebinnings.
 //      
 // OUTPUT:
 //      A bidimensional Eigen Array containing all the estimators of the
@@ -406,27 +607,31 @@ ArrayXd Results::computeCredibleLimits(const double credibleLevel, const double
 //      (6) Upper CL
 // 
 
-ArrayXXd Results::parameterEstimation(double credibleLevel, bool writeMarginalDistribution)
+ArrayXXd Results::parameterEstimation(double credibleLevel, bool writeMarginalDistribution, bool useKernelDensityEstimation)
 {
-    int Ndimensions = nestedSampler.getPosteriorSample().rows();
+    const ArrayXXd &posteriorSample = nestedSampler.getPosteriorSample();
+    int Ndimensions = posteriorSample.rows();
     ArrayXd posteriorDistribution = posteriorProbability();
     
     int sampleSize = posteriorDistribution.size();
-    assert(nestedSampler.getPosteriorSample().cols() == sampleSize);
+    assert(posteriorSample.cols() == sampleSize);
     ArrayXXd parameterEstimates(Ndimensions, 7);
+    vector<ArrayXd> parameterValuesRebinnedPerParameter(Ndimensions);
+    vector<ArrayXd> marginalDistributionRebinnedPerParameter(Ndimensions);
 
-    parameterValues.resize(sampleSize);
-    marginalDistribution.resize(sampleSize);
 
+    // Loop over all free parameters to compute the moments and the rebinned marginal distribution of each of them.
+    // The parameters are independent of each other, hence they can be processed in parallel.
 
-    // Loop over all free parameters
-
+    #ifdef _OPENMP
+    #pragma omp parallel for schedule(dynamic)
+    #endif
     for (int i = 0; i < Ndimensions; ++i)
     {
         // Take the information corresponding to the current parameter
 
-        parameterValues = nestedSampler.getPosteriorSample().row(i);
-        marginalDistribution = posteriorDistribution;
+        ArrayXd parameterValues = posteriorSample.row(i);
+        ArrayXd marginalDistribution = posteriorDistribution;
 
 
         // Sort elements of array parameterValues in ascending
@@ -467,109 +672,108 @@ ArrayXXd Results::parameterEstimation(double credibleLevel, bool writeMarginalDi
         // Scott's normal reference rule is adopted (most efficient for Gaussian-shaped distributions)
 
         double binWidth = 0;
+        int Nbins = 0;
         double parameterMaximum = parameterValues.maxCoeff();
         double parameterMinimum = parameterValues.minCoeff();
         
-        binWidth = 3.5*sqrt(secondMoment)/pow(sampleSize,1.0/3.0);
-        int Nbins = floor((parameterMaximum - parameterMinimum)/binWidth) - 1;
-
-        if (Nbins > 1000)
-        {
-            // If it happens that the number of bins is too large, reduce it to a fixed value
-
-            Nbins = 1000;
-            binWidth = (parameterMaximum - parameterMinimum)/(Nbins*1.0);
-        }
-
-
-        // Rebin marginal distribution. This allows to get rid of the
-        // multiple spikes appearing in the final nested sampling posterior. One can then operate on a smoother
-        // shape which allows to derive more reliable credible intervals.
-        // For this purpose simply cumulate initial marginal distribution values within each bin.
-        // This can be done this way because marginal distribution values are probabilities.
-
-        double parameterStart = 0.0;
-        double parameterEnd = 0.0;
-        int binSize;
-        parameterValuesRebinned.resize(Nbins);
-        parameterValuesRebinned.setZero();
-        marginalDistributionRebinned.resize(Nbins);
-        marginalDistributionRebinned.setZero();
+        computeScottBinning(secondMoment, sampleSize, parameterMinimum, parameterMaximum, 1000, Nbins, binWidth);
 
-        int Nshifts = 20;                           // Total number of shifts for the starting point of the rebinning
-        double shiftWidth = binWidth/Nshifts;       // Width of the shift bin
-        ArrayXd parameterValuesRebinnedPerShift(Nbins);
-        parameterValuesRebinnedPerShift.setZero();
-        ArrayXd marginalDistributionRebinnedPerShift(Nbins);
-        marginalDistributionRebinnedPerShift.setZero();
 
+        ArrayXd &rebinnedParameterValues = parameterValuesRebinnedPerParameter[i];
+        ArrayXd &rebinnedMarginalDistribution = marginalDistributionRebinnedPerParameter[i];
 
-        // Do the merging
-        // First loop over the offset (shift) for the starting point of the rebinning.
-        // The larger the number of shifts, the better the averaged result.
+        if (useKernelDensityEstimation && (parameterMaximum > parameterMinimum))
+        {
+            // Smooth the marginal distribution with a Gaussian kernel evaluated on a regular grid.
+            // The grid takes the place of the rebinned distribution for the mode and the credible limits.
 
-        for (int k = 0; k < Nshifts; ++k)
+            computeKernelDensityEstimate(parameterValues, marginalDistribution, 1024, 
+                                         rebinnedParameterValues, rebinnedMarginalDistribution);
+        }
+        else
         {
-            int cumulatedBinSize = 0;
+            // Rebin marginal distribution. This allows to get rid of the
+            // multiple spikes appearing in the final nested sampling posterior. One can then operate on a smoother
+            // shape which allows to derive more reliable credible intervals.
+            // For this purpose simply cumulate initial marginal distribution values within each bin.
+            // This can be done this way because marginal distribution values are probabilities.
+
+            double parameterStart = 0.0;
+            double parameterEnd = 0.0;
+            int binSize;
+            rebinnedParameterValues.resize(Nbins);
+            rebinnedParameterValues.setZero();
+            rebinnedMarginalDistribution.resize(Nbins);
+            rebinnedMarginalDistribution.setZero();
+
+            int Nshifts = 20;                           // Total number of shifts for the starting point of the rebinning
+            double shiftWidth = binWidth/Nshifts;       // Width of the shift bin
+            ArrayXd parameterValuesRebinnedPerShift(Nbins);
+            parameterValuesRebinnedPerShift.setZero();
+            ArrayXd marginalDistributionRebinnedPerShift(Nbins);
+            marginalDistributionRebinnedPerShift.setZero();
+
+
+            // Do the merging
+            // First loop over the offset (shift) for the starting point of the rebinning.
+            // The larger the number of shifts, the better the averaged result.
+
+            for (int k = 0; k < Nshifts; ++k)
+            {
+                int cumulatedBinSize = 0;
             
-            // Now loop over the different bins for collecting marginal probability in each of them.
+                // Now loop over the different bins for collecting marginal probability in each of them.
 
-            for (int j = 0; j < Nbins; ++j)
-            {
-                // Set the left edge of the selected bin
+                for (int j = 0; j < Nbins; ++j)
+                {
+                    // Set the left edge of the selected bin
 
-                parameterStart = parameterMinimum + j*binWidth + k*shiftWidth;
+                    parameterStart = parameterMinimum + j*binWidth + k*shiftWidth;
 
-                // Ensure the right edge is not exceeding the right array boundary
+                    // Ensure the right edge is not exceeding the right array boundary
                 
-                if (j < (Nbins - 1)) 
-                    parameterEnd = parameterMinimum + (j+1)*binWidth + k*shiftWidth;
-                else
-                    parameterEnd = parameterMaximum;
+                    if (j < (Nbins - 1)) 
+                        parameterEnd = parameterMinimum + (j+1)*binWidth + k*shiftWidth;
+                    else
+                        parameterEnd = parameterMaximum;
 
                 
-                // Find the number of array elements belonging to the selected bin and take as parameter value the mid point
+                    // Find the number of array elements belonging to the selected bin and take as parameter value the mid point.
+                    // Since parameterValues is sorted, the bin edges are found with a binary search rather than a full scan.
 
-                binSize = Functions::countArrayIndicesWithinBoundaries(parameterValues, parameterStart, parameterEnd);
-                parameterValuesRebinnedPerShift(j) = (parameterStart + parameterEnd)/2.0;
+                    binSize = Functions::countSortedArrayIndicesWithinBoundaries(parameterValues, parameterStart, parameterEnd);
+                    parameterValuesRebinnedPerShift(j) = (parameterStart + parameterEnd)/2.0;
 
-                if (binSize > 0)
-                {
-                    // At least one point is found in this bin, hence cumulate the marginal distribution values 
-                    // falling inside the selected bin
+                    if (binSize > 0)
+                    {
+                        // At least one point is found in this bin, hence cumulate the marginal distribution values 
+                        // falling inside the selected bin
                     
-                    marginalDistributionRebinnedPerShift(j) = marginalDistribution.segment(cumulatedBinSize, binSize).sum();
-                    cumulatedBinSize += binSize;
-                }
-                else
-                {
-                    // No points are found in this bin, hence set marginal probability to zero
-
-                    marginalDistributionRebinnedPerShift(j) = 0.0;
-                }
+                        marginalDistributionRebinnedPerShift(j) = marginalDistribution.segment(cumulatedBinSize, binSize).sum();
+                        cumulatedBinSize += binSize;
+                    }
+                    else
+                    {
+                        // No points are found in this bin, hence set marginal probability to zero
+
+                        marginalDistributionRebinnedPerShift(j) = 0.0;
+                    }
                 
-            }
+                }
         
             
-            // Cumulate the values of the rebinning into a total array
+                // Cumulate the values of the rebinning into a total array
 
-            parameterValuesRebinned += parameterValuesRebinnedPerShift;
-            marginalDistributionRebinned += marginalDistributionRebinnedPerShift;
-        }
+                rebinnedParameterValues += parameterValuesRebinnedPerShift;
+                rebinnedMarginalDistribution += marginalDistributionRebinnedPerShift;
+            }
 
 
-        // Average all the rebinnings done by the total number of shifts adopted
+            // Average all the rebinnings done by the total number of shifts adopted
         
-        parameterValuesRebinned /= Nshifts;
-        marginalDistributionRebinned /= Nshifts;
-
-
-        // Find the mode value (parameter corresponding to maximum probability value of the rebinned distribution)
-
-        int max = 0;                                    // Subscript corresponding to mode value
-        marginalDistributionMode = marginalDistributionRebinned.maxCoeff(&max);
-        double parameterMode = parameterValuesRebinned(max);
-        parameterEstimates(i,2) = parameterMode;
+            rebinnedParameterValues /= Nshifts;
+            rebinnedMarginalDistribution /= Nshifts;
+        }
 
         
         // Save the second moment of the distribution
@@ -577,25 +781,44 @@ ArrayXXd Results::parameterEstimation(double credibleLevel, bool writeMarginalDi
         parameterEstimates(i,3) = secondMoment;
 
 
-        // Compute third moment and skewness of the sample distribution
+        // Compute third moment and skewness of the sample distribution, and save the skewness
         
         double thirdMoment = ((parameterValues - parameterMean).pow(3) * marginalDistribution).sum();
         double skewness = thirdMoment/pow(secondMoment,3.0/2.0);
+        parameterEstimates(i,6) = skewness;
+
+    }   // END for loop over the parameters
+
+
+    // Loop again over all free parameters to derive the mode and the credible limits from 
+    // the rebinned marginal distributions. This is done sequentially because it works on the 
+    // interpolated marginal distribution stored in the class.
+
+    for (int i = 0; i < Ndimensions; ++i)
+    {
+        parameterValuesRebinned = parameterValuesRebinnedPerParameter[i];
+        marginalDistributionRebinned = marginalDistributionRebinnedPerParameter[i];
+
+
+        // Find the mode value (parameter corresponding to maximum probability value of the rebinned distribution)
+
+        int max = 0;                                    // Subscript corresponding to mode value
+        marginalDistributionMode = marginalDistributionRebinned.maxCoeff(&max);
+        double parameterMode = parameterValuesRebinned(max);
+        parameterEstimates(i,2) = parameterMode;
 
         
         // Compute shortest credible intervals (CI) and save their corresponding limiting values (credible limits)
 
+        // The grid of a kernel density estimate is already fine enough, hence it needs no further interpolation
+
         ArrayXd credibleLimits(2);
-        credibleLimits = computeCredibleLimits(credibleLevel, skewness);
+        int NinterpolationsPerBin = useKernelDensityEstimation ? 1 : 10;
+        credibleLimits = computeCredibleLimits(credibleLevel, parameterEstimates(i,6), NinterpolationsPerBin);
         
         parameterEstimates(i,4) = credibleLimits(0);
         parameterEstimates(i,5) = credibleLimits(1);
 
-
-        // Save the skewness of the distribution
-
-        parameterEstimates(i,6) = skewness;
-
         
         // If required, save the interpolated marginal distribution in an output file
 
@@ -603,9 +826,7 @@ ArrayXXd Results::parameterEstimation(double credibleLevel, bool writeMarginalDi
         {
             writeMarginalDistributionToFile(i);
         }
-
-        
-    }   // END for loop over the parameters
+    }
 
     return parameterEstimates;
 }
@@ -637,8 +858,7 @@ ArrayXXd Results::parameterEstimation(double credibleLevel, bool writeMarginalDi
 void Results::writeParametersToFile(string fileName, string outputFileExtension)
 {
     string pathPrefix = nestedSampler.getOutputPathPrefix() + fileName;
-    ArrayXXd posteriorSample = nestedSampler.getPosteriorSample();
-    File::arrayXXdRowsToFiles(posteriorSample, pathPrefix, outputFileExtension);
+    File::arrayXXdRowsToFiles(nestedSampler.getPosteriorSample(), pathPrefix, outputFileExtension);
 }
 
 
@@ -677,7 +897,7 @@ void Results::writeLogLikelihoodToFile(string fileName)
     outputFile << "# log(Likelihood)" << endl;
     outputFile << scientific << setprecision(9);
     
-    ArrayXd logLikelihoodOfPosteriorSample = nestedSampler.getLogLikelihoodOfPosteriorSample();
+    const ArrayXd &logLikelihoodOfPosteriorSample = nestedSampler.getLogLikelihoodOfPosteriorSample();
     File::arrayXdToFile(outputFile, logLikelihoodOfPosteriorSample);
     outputFile.close();
 }
@@ -719,7 +939,7 @@ void Results::writeLogWeightsToFile(string fileName)
     outputFile << "# log(Weight) = log(dX)" << endl;
     outputFile << scientific << setprecision(9);
     
-    ArrayXd logWeightOfPosteriorSample = nestedSampler.getLogWeightOfPosteriorSample();
+    const ArrayXd &logWeightOfPosteriorSample = nestedSampler.getLogWeightOfPosteriorSample();
     File::arrayXdToFile(outputFile, logWeightOfPosteriorSample);
     outputFile.close();
 }
@@ -736,6 +956,53 @@ void Results::writeLogWeightsToFile(string fileName)
 
 
 
+// Results::writeNlivePointsPerIterationToFile()
+//
+// PURPOSE:
+//      writes the number of live points at each iteration of the nesting process, i.e. 
+//      the number of live points used to shrink the prior mass at each dead point of the posterior sample,
+//      into an ASCII file of one column format. The final live points, appended at the end of the
+//      posterior sample, are not included. Their number is stored in the computation parameters.
+//
+// INPUT:
+//      fileName:   a string variable containing the file name of the output file to be saved.
+//
+// OUTPUT:
+//      void
+// 
+
+void Results::writeNlivePointsPerIterationToFile(string fileName)
+{
+    string fullPath = nestedSampler.getOutputPathPrefix() + fileName;
+
+    ofstream outputFile;
+    File::openOutputFile(outputFile, fullPath);
+            
+    outputFile << "# Posterior sample from nested sampling" << endl;
+    outputFile << "# Number of live points at each dead point" << endl;
+    
+    ArrayXi NlivePointsPerIteration = getNlivePointsOfDeadPoints();
+    
+    for (int i = 0; i < NlivePointsPerIteration.size(); ++i)
+    {
+        outputFile << NlivePointsPerIteration(i) << endl;
+    }
+    
+    outputFile.close();
+}
+
+
+
+
+
+
+
+
+
+
+
+
+
 // Results::writeEvidenceInformationToFile()
 //
 // PURPOSE:
@@ -837,7 +1104,7 @@ void Results::writePosteriorProbabilityToFile(string fileName)
 
 void Results::writeLogEvidenceToFile(string fileName)
 {
-    ArrayXd logEvidence = nestedSampler.getLogEvidenceOfPosteriorSample();
+    const ArrayXd &logEvidence = nestedSampler.getLogEvidenceOfPosteriorSample();
     string fullPath = nestedSampler.getOutputPathPrefix() + fileName;
     
     ofstream outputFile;
@@ -880,7 +1147,7 @@ void Results::writeLogEvidenceToFile(string fileName)
 
 void Results::writeLogMeanLiveEvidenceToFile(string fileName)
 {
-    ArrayXd logMeanLiveEvidence = nestedSampler.getLogMeanLiveEvidenceOfPosteriorSample();
+    const ArrayXd &logMeanLiveEvidence = nestedSampler.getLogMeanLiveEvidenceOfPosteriorSample();
     string fullPath = nestedSampler.getOutputPathPrefix() + fileName;
     
     ofstream outputFile;
@@ -916,16 +1183,21 @@ void Results::writeLogMeanLiveEvidenceToFile(string fileName)
 //                                  to a credible level of 68.27 %.
 //      writeMarginalDistribution:  a boolean variable specifying whether the marginal distribution for
 //                                  each parameter has to be written in an output file.
+//      useKernelDensityEstimation: a boolean variable specifying whether the marginal distributions are
+//                                  obtained from a kernel density estimate with a plug-in bandwidth 
+//                                  (see computeKernelDensityEstimate()), instead of the average of 20 shifted
+//                                  rebinnings. Default is false.
 //      
 // OUTPUT:
 //      void.
 // 
 
-void Results::writeParametersSummaryToFile(string fileName, const double credibleLevel, const bool writeMarginalDistribution)
+void Results::writeParametersSummaryToFile(string fileName, const double credibleLevel, const bool writeMarginalDistribution,
+                                           const bool useKernelDensityEstimation)
 {
     // Compute estimators for all the free parameters
 
-    ArrayXXd parameterEstimates = parameterEstimation(credibleLevel, writeMarginalDistribution);
+    ArrayXXd parameterEstimates = parameterEstimation(credibleLevel, writeMarginalDistribution, useKernelDensityEstimation);
 
 
     // Write output ASCII file
@@ -937,6 +1209,10 @@ void Results::writeParametersSummaryToFile(string fileName, const double credibl
     outputFile << "# Summary of Parameter Estimation from nested sampling" << endl;
     outputFile << "# Credible intervals are the shortest credible intervals" << endl; 
     outputFile << "# according to the usual definition" << endl;
+
+    if (useKernelDensityEstimation)
+        outputFile << "# Mode and credible limits from Gaussian kernel density estimates of the marginal distributions" << endl;
+
     outputFile << "# Credible level: " << fixed << setprecision(2) << credibleLevel << " %" << endl;
     outputFile << "# Column #1: I Moment (Mean)" << endl;
     outputFile << "# Column #2: Median" << endl;
@@ -954,3 +1230,756 @@ void Results::writeParametersSummaryToFile(string fileName, const double credibl
 
 
 
+
+
+
+
+
+
+
+
+// Results::writePosteriorToBinaryFile()
+//
+// PURPOSE:
+//      Writes the whole posterior sample from the nested sampling, i.e. the parameter values,
+//      the log(Likelihood) and the log(Weight) values, together with the evidence summary and the 
+//      main parameters of the run, in a single binary file. The file can be read back without any
+//      parsing by means of the class BinaryPosteriorFile, which also describes its layout.
+//
+// INPUT:
+//      fileName:   a string variable containing the file name of the output file to be saved.
+//
+// OUTPUT:
+//      void
+//
+// REMARK:
+//      Values are saved in full double precision, in the byte order of the machine.
+//
+
+void Results::writePosteriorToBinaryFile(string fileName)
+{
+    const ArrayXXd &posteriorSample = nestedSampler.getPosteriorSample();
+    const ArrayXd &logLikelihoodOfPosteriorSample = nestedSampler.getLogLikelihoodOfPosteriorSample();
+    const ArrayXd &logWeightOfPosteriorSample = nestedSampler.getLogWeightOfPosteriorSample();
+    assert(logLikelihoodOfPosteriorSample.size() == posteriorSample.cols());
+    assert(logWeightOfPosteriorSample.size() == posteriorSample.cols());
+
+
+    // Fill in the header of the file
+
+    BinaryPosteriorHeader header;
+    memset(&header, 0, sizeof(BinaryPosteriorHeader));
+    memcpy(header.magicNumber, BinaryPosteriorFile::magicNumber, sizeof(header.magicNumber));
+    header.version = BinaryPosteriorFile::version;
+    header.byteOrderMark = BinaryPosteriorFile::byteOrderMark;
+    header.dataOffset = sizeof(BinaryPosteriorHeader);
+    header.Ndimensions = posteriorSample.rows();
+    header.Nsamples = posteriorSample.cols();
+    header.logEvidence = nestedSampler.getLogEvidence();
+    header.logEvidenceError = nestedSampler.getLogEvidenceError();
+    header.informationGain = nestedSampler.getInformationGain();
+    header.Niterations = nestedSampler.getNiterations();
+    header.initialNlivePoints = nestedSampler.getInitialNlivePoints();
+    header.minNlivePoints = nestedSampler.getMinNlivePoints();
+    header.terminationFactor = nestedSampler.getTerminationFactor();
+    header.computationalTime = nestedSampler.getComputationalTime();
+    header.NfinalLivePoints = nestedSampler.getNlivePoints();
+
+
+    // The number of live points of each dead point, as a double like the other data blocks
+
+    ArrayXd NlivePointsPerIteration = getNlivePointsOfDeadPoints().cast<double>();
+
+
+    // Write the header followed by the four data blocks
+
+    string fullPath = nestedSampler.getOutputPathPrefix() + fileName;
+    ofstream outputFile(fullPath.c_str(), ios::out | ios::binary);
+
+    if (!outputFile.good())
+    {
+        cerr << "Error opening output file " << fullPath << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    outputFile.write(reinterpret_cast<const char*>(&header), sizeof(BinaryPosteriorHeader));
+    outputFile.write(reinterpret_cast<const char*>(posteriorSample.data()), posteriorSample.size()*sizeof(double));
+    outputFile.write(reinterpret_cast<const char*>(logLikelihoodOfPosteriorSample.data()), 
+                     logLikelihoodOfPosteriorSample.size()*sizeof(double));
+    outputFile.write(reinterpret_cast<const char*>(logWeightOfPosteriorSample.data()), 
+                     logWeightOfPosteriorSample.size()*sizeof(double));
+    outputFile.write(reinterpret_cast<const char*>(NlivePointsPerIteration.data()), 
+                     NlivePointsPerIteration.size()*sizeof(double));
+
+    if (!outputFile.good())
+    {
+        cerr << "Error writing output file " << fullPath << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    outputFile.close();
+}
+
+
+
+
+
+
+
+
+
+
+
+// Results::writeEqualWeightPosteriorToFile()
+//
+// PURPOSE:
+//      Writes an equal-weight posterior sample, drawn from the weighted posterior sample 
+//      of the nested sampling by systematic resampling, to an ASCII file with one row per draw
+//      and one column per free parameter. The header of the file reports the Kish effective sample
+//      size of the weighted sample and the expected fraction of duplicated points among the draws.
+//
+// INPUT:
+//      fileName:   a string variable containing the file name of the output file to be saved.
+//      Ndraws:     number of draws. If 0, the effective sample size, rounded to an integer, is used.
+//      seed:       seed of the random generator. If 0, the clock is used.
+//
+// OUTPUT:
+//      void
+//
+
+void Results::writeEqualWeightPosteriorToFile(string fileName, const int Ndraws, const unsigned int seed)
+{
+    string fullPath = nestedSampler.getOutputPathPrefix() + fileName;
+
+    ofstream outputFile;
+    File::openOutputFile(outputFile, fullPath);
+    
+    resampleToEqualWeights(outputFile, nestedSampler.getPosteriorSample(), nestedSampler.getLogLikelihoodOfPosteriorSample(),
+                           nestedSampler.getLogWeightOfPosteriorSample(), Ndraws, seed);
+    outputFile.close();
+}
+
+
+
+
+
+
+
+
+
+
+// Results::writeEqualWeightPosteriorToFile()
+//
+// PURPOSE:
+//      Same as above, but for a posterior sample read from a binary posterior file, e.g. 
+//      the one of a previous run or of a merge of multiple runs, without a NestedSampler.
+//
+// INPUT:
+//      posteriorFile:  the binary posterior file, whose sample is read in place
+//      fullPath:       a string variable containing the full path of the output file to be saved.
+//      Ndraws:         number of draws. If 0, the effective sample size, rounded to an integer, is used.
+//      seed:           seed of the random generator. If 0, the clock is used.
+//
+// OUTPUT:
+//      void
+//
+// REMARK:
+//      Static function. The parameter values are read once, in the order of the file.
+//
+
+void Results::writeEqualWeightPosteriorToFile(BinaryPosteriorFile &posteriorFile, string fullPath, const int Ndraws, const unsigned int seed)
+{
+    ofstream outputFile;
+    File::openOutputFile(outputFile, fullPath);
+    
+    resampleToEqualWeights(outputFile, posteriorFile.getPosteriorSample(), posteriorFile.getLogLikelihood(),
+                           posteriorFile.getLogWeight(), Ndraws, seed);
+    outputFile.close();
+}
+
+
+
+
+
+
+
+
+
+
+// Results::resampleToEqualWeights()
+//
+// PURPOSE:
+//      Draws an equal-weight sample from a weighted posterior sample by systematic resampling,
+//      and writes it to an output stream. The probability of each point is proportional to
+//      exp(log(Weight) + log(Likelihood)), and is normalized in logarithmic scale so that
+//      no overflow or underflow occurs.
+//
+// INPUT:
+//      outputFile:         output stream, already opened and checked for sanity
+//      posteriorSample:    parameter values, one column per point
+//      logLikelihood:      log(Likelihood) values of the points
+//      logWeight:          log(Weight) values of the points
+//      Ndraws:             number of draws. If 0, the effective sample size, rounded to an integer, is used.
+//      seed:               seed of the random generator. If 0, the clock is used.
+//
+// OUTPUT:
+//      void
+//
+// REMARK:
+//      Systematic resampling uses a single random number u in [0,1): draw k selects the point whose
+//      cumulated expected number of draws first exceeds k + u. The number of draws of each point hence 
+//      differs from its expected value by less than one, and the whole sample is selected in one pass 
+//      over the points, in O(N). The draws follow the order of the posterior sample, i.e. they are
+//      sorted by increasing likelihood.
+//
+
+void Results::resampleToEqualWeights(ofstream &outputFile, ConstRefArrayXXd posteriorSample, ConstRefArrayXd logLikelihood,
+                                     ConstRefArrayXd logWeight, int Ndraws, const unsigned int seed)
+{
+    const ptrdiff_t Nsamples = logLikelihood.size();
+    assert(logWeight.size() == Nsamples);
+    assert(posteriorSample.cols() == Nsamples);
+    assert(Nsamples > 0);
+
+
+    // Compute the normalization of the probabilities and the Kish effective sample size, 
+    // (sum w)^2 / (sum w^2), relative to the largest log(Weight) + log(Likelihood)
+
+    double maxLogProbability = (logWeight + logLikelihood).maxCoeff();
+    double sumOfProbabilities = 0.0;
+    double sumOfSquaredProbabilities = 0.0;
+
+    for (ptrdiff_t i = 0; i < Nsamples; ++i)
+    {
+        double probability = exp(logWeight(i) + logLikelihood(i) - maxLogProbability);
+        sumOfProbabilities += probability;
+        sumOfSquaredProbabilities += probability * probability;
+    }
+
+    double logNormalization = maxLogProbability + log(sumOfProbabilities);
+    double effectiveSampleSize = sumOfProbabilities * sumOfProbabilities / sumOfSquaredProbabilities;
+
+    if (Ndraws <= 0)
+        Ndraws = max(1L, lround(effectiveSampleSize));
+
+
+    // A point with an expected number of draws m is drawn at least once if m >= 1,
+    // and with probability m otherwise, hence the expected number of distinct points
+
+    double expectedNdistinctPoints = 0.0;
+
+    for (ptrdiff_t i = 0; i < Nsamples; ++i)
+    {
+        expectedNdistinctPoints += min(1.0, Ndraws * exp(logWeight(i) + logLikelihood(i) - logNormalization));
+    }
+
+    double duplicationRate = 1.0 - expectedNdistinctPoints / Ndraws;
+
+    outputFile << "# Equal-weight posterior sample from nested sampling, obtained by systematic resampling" << endl;
+    outputFile << "# Number of draws: " << Ndraws << endl;
+    outputFile << scientific << setprecision(9);
+    outputFile << "# Kish effective sample size: " << effectiveSampleSize << endl;
+    outputFile << "# Expected duplication rate: " << duplicationRate << endl;
+    outputFile << "# One row per draw, one column per free parameter" << endl;
+
+
+    // Draw the sample in a single pass over the points
+
+    mt19937 engine(seed != 0 ? seed : clock());
+    uniform_real_distribution<double> uniform(0.0, 1.0);
+    double offset = uniform(engine);
+    double cumulatedNdraws = 0.0;
+    int Ndrawn = 0;
+    const int Ndimensions = posteriorSample.rows();
+    const string separator = "  ";
+    const string terminator = "\n";
+    BufferedAsciiWriter writer(outputFile);
+
+    for (ptrdiff_t i = 0; i < Nsamples; ++i)
+    {
+        cumulatedNdraws += Ndraws * exp(logWeight(i) + logLikelihood(i) - logNormalization);
+
+
+        // Round-off errors could leave the last draw out. Since Ndrawn + offset < Ndraws
+        // for all draws, setting the exact total at the last point includes all of them.
+
+        if (i == Nsamples-1)
+            cumulatedNdraws = Ndraws;
+
+        while (Ndrawn < Ndraws && Ndrawn + offset < cumulatedNdraws)
+        {
+            for (int j = 0; j < Ndimensions-1; ++j)
+            {
+                writer.write(posteriorSample(j, i));
+                writer.write(separator);
+            }
+
+            writer.write(posteriorSample(Ndimensions-1, i));
+            writer.write(terminator);
+            Ndrawn++;
+        }
+
+        if (Ndrawn == Ndraws)
+            break;
+    }
+}
+
+
+
+
+
+
+
+
+
+
+
+// Results::writeEvidenceUncertaintyToFile()
+//
+// PURPOSE:
+//      Estimates the uncertainty on the log(Evidence), on the information gain and on the mean and
+//      standard deviation of each free parameter, by simulating the shrinkage of the prior volume
+//      many times for the same sequence of dead points (see simulatePriorVolumes()). This is more
+//      robust than Skilling's error sqrt(H/N), and does not require repeating the whole run.
+//      The results are written to an ASCII file of two columns, with the mean and the 
+//      standard deviation over the simulations. The rows are: (1) log(Evidence), (2) information gain,
+//      then the mean and the standard deviation of each free parameter in turn.
+//
+// INPUT:
+//      fileName:       a string variable containing the file name of the output file to be saved.
+//      Nsimulations:   number of simulated sequences of prior volumes.
+//      seed:           seed of the random generator. If 0, the clock is used.
+//
+// OUTPUT:
+//      void
+//
+
+void Results::writeEvidenceUncertaintyToFile(string fileName, const int Nsimulations, const unsigned int seed)
+{
+    ArrayXXd simulatedEstimates = simulatePriorVolumes(nestedSampler.getPosteriorSample(), nestedSampler.getLogLikelihoodOfPosteriorSample(),
+                                                       nestedSampler.getNlivePointsPerIteration(), nestedSampler.getNlivePoints(), 
+                                                       Nsimulations, seed);
+
+
+    // Compute mean and standard deviation of each estimate over the simulations
+
+    ArrayXXd summary(simulatedEstimates.cols(), 2);
+
+    for (int j = 0; j < simulatedEstimates.cols(); ++j)
+    {
+        double mean = simulatedEstimates.col(j).mean();
+        summary(j,0) = mean;
+        summary(j,1) = sqrt((simulatedEstimates.col(j) - mean).square().sum() / max(1, Nsimulations - 1));
+    }
+
+
+    // Write output ASCII file
+
+    string fullPath = nestedSampler.getOutputPathPrefix() + fileName;
+    ofstream outputFile;
+    File::openOutputFile(outputFile, fullPath);
+
+    outputFile << "# Uncertainties from " << Nsimulations << " simulations of the prior volume shrinkage of nested sampling" << endl;
+    outputFile << scientific << setprecision(9);
+    outputFile << "# log(Evidence) of the run: " << nestedSampler.getLogEvidence() 
+               << " +/- " << nestedSampler.getLogEvidenceError() << " (Skilling's error)" << endl;
+    outputFile << "# Column #1: Mean over the simulations" << endl;
+    outputFile << "# Column #2: Standard deviation over the simulations" << endl;
+    outputFile << "# Row #1: log(Evidence)" << endl;
+    outputFile << "# Row #2: Information gain" << endl;
+    outputFile << "# Rows #3 onwards: posterior mean and posterior standard deviation of each free parameter in turn" << endl;
+    File::arrayXXdToFile(outputFile, summary);
+    outputFile.close();
+}
+
+
+
+
+
+
+
+
+
+
+// Results::simulatePriorVolumes()
+//
+// PURPOSE:
+//      Simulates the statistical uncertainty of nested sampling. The prior volume enclosed by the 
+//      likelihood contour of dead point i is X_i = t_1 t_2 ... t_i, where the shrinkage factors t_k 
+//      are independent and distributed as Beta(N_k, 1), with N_k the number of live points at iteration k. 
+//      The run only uses the expected values of log(t_k). Here the factors are instead drawn again 
+//      for each simulation, and the log(Evidence), the posterior probabilities and the moments of the 
+//      parameters are recomputed for the simulated volumes.
+//
+// INPUT:
+//      posteriorSample:            parameter values, one column per point, dead points first
+//      logLikelihood:              log(Likelihood) values of the points
+//      NlivePointsPerIteration:    number of live points at each iteration of the nesting process.
+//                                  If shorter than the number of dead points, the last value, or
+//                                  NfinalLivePoints if empty, is used for the remaining iterations.
+//      NfinalLivePoints:           number of live points appended at the end of the posterior sample
+//      Nsimulations:               number of simulations
+//      seed:                       seed of the random generator. If 0, the clock is used.
+//
+// OUTPUT:
+//      A bidimensional Eigen Array with one row per simulation. The columns are log(Evidence), 
+//      information gain, and then the posterior mean and standard deviation of each free parameter in turn.
+//
+// REMARKS:
+//      The final live points are treated as if the nesting process went on without replacing 
+//      them, i.e. they are taken in order of increasing likelihood, with N_k decreasing from 
+//      NfinalLivePoints down to 1. The weights follow the same trapezoidal rule as the nesting process.
+//      Simulation s uses its own random generator, seeded with seed + s, so that the results do not
+//      depend on the number of threads. The simulations are independent, hence done in parallel.
+//      Static function.
+//
+
+ArrayXXd Results::simulatePriorVolumes(ConstRefArrayXXd posteriorSample, ConstRefArrayXd logLikelihood, 
+                                       const vector<int> &NlivePointsPerIteration, const int NfinalLivePoints, 
+                                       const int Nsimulations, const unsigned int seed)
+{
+    const int Nsamples = logLikelihood.size();
+    const int Ndimensions = posteriorSample.rows();
+    assert(posteriorSample.cols() == Nsamples);
+    assert(Nsimulations > 0);
+
+    if (NfinalLivePoints < 1 || NfinalLivePoints > Nsamples)
+    {
+        cerr << "Error: inconsistent number of final live points for the simulation of the prior volumes." << endl;
+        exit(EXIT_FAILURE);
+    }
+
+
+    // Order the points by increasing likelihood, which only requires sorting the final live points,
+    // and set the number of live points of each iteration
+
+    const int NdeadPoints = Nsamples - NfinalLivePoints;
+    vector<int> order(Nsamples);
+
+    for (int i = 0; i < Nsamples; ++i)
+        order[i] = i;
+
+    stable_sort(order.begin() + NdeadPoints, order.end(),
+                [&logLikelihood](int i, int j) { return logLikelihood(i) < logLikelihood(j); });
+
+    ArrayXd NlivePoints(Nsamples);
+    int lastNlivePoints = NlivePointsPerIteration.empty() ? NfinalLivePoints : NlivePointsPerIteration.back();
+
+    for (int i = 0; i < NdeadPoints; ++i)
+        NlivePoints(i) = (i < static_cast<int>(NlivePointsPerIteration.size())) ? NlivePointsPerIteration[i] : lastNlivePoints;
+
+    for (int i = NdeadPoints; i < Nsamples; ++i)
+        NlivePoints(i) = Nsamples - i;
+
+
+    // Copy the points in this order once, so that the moments of all parameters are matrix-vector products
+
+    ArrayXd orderedLogLikelihood(Nsamples);
+    ArrayXXd orderedSample(Ndimensions, Nsamples);
+
+    for (int i = 0; i < Nsamples; ++i)
+    {
+        orderedLogLikelihood(i) = logLikelihood(order[i]);
+        orderedSample.col(i) = posteriorSample.col(order[i]);
+    }
+
+    ArrayXXd orderedSampleSquared = orderedSample.square();
+    ArrayXd inverseNlivePoints = NlivePoints.inverse();
+    ArrayXXd simulatedEstimates(Nsimulations, 2 + 2*Ndimensions);
+    const unsigned int baseSeed = (seed != 0) ? seed : clock();
+
+    #ifdef _OPENMP
+    #pragma omp parallel for schedule(static)
+    #endif
+    for (int s = 0; s < Nsimulations; ++s)
+    {
+        mt19937 engine(baseSeed + s);
+        exponential_distribution<double> exponential(1.0);
+
+
+        // Since t_k ~ Beta(N_k, 1), log(t_k) = log(u)/N_k, with u uniform in (0,1), and -log(u) ~ Exp(1)
+
+        ArrayXd logShrinkage(Nsamples);
+        
+        for (int i = 0; i < Nsamples; ++i)
+            logShrinkage(i) = exponential(engine);
+
+        logShrinkage *= -inverseNlivePoints;
+
+        ArrayXd logPriorVolume(Nsamples + 2);                   // log(X_(i-1)), with X_(-1) = 1 and X_N = 0
+        logPriorVolume(0) = 0.0;
+        
+        for (int i = 0; i < Nsamples; ++i)
+            logPriorVolume(i+1) = logPriorVolume(i) + logShrinkage(i);
+        
+        logPriorVolume(Nsamples + 1) = -numeric_limits<double>::infinity();
+
+
+        // Trapezoidal rule, 0.5*(X_(i-1) - X_(i+1)), in logarithmic scale, and log-sum-exp of the evidence
+
+        ArrayXd logPosterior = log(0.5) + logPriorVolume.head(Nsamples) 
+                               + (1.0 - (logPriorVolume.tail(Nsamples) - logPriorVolume.head(Nsamples)).exp()).log()
+                               + orderedLogLikelihood;
+        double maxLogPosterior = logPosterior.maxCoeff();
+        ArrayXd posterior = (logPosterior - maxLogPosterior).exp();
+        double sumOfPosterior = posterior.sum();
+        double logEvidence = maxLogPosterior + log(sumOfPosterior);
+        posterior /= sumOfPosterior;
+
+        simulatedEstimates(s,0) = logEvidence;
+        simulatedEstimates(s,1) = (posterior * orderedLogLikelihood).sum() - logEvidence;
+
+
+        // Moments of the parameters for the simulated posterior probabilities
+
+        ArrayXd parameterMean = (orderedSample.matrix() * posterior.matrix()).array();
+        ArrayXd parameterSecondMoment = (orderedSampleSquared.matrix() * posterior.matrix()).array();
+
+        for (int j = 0; j < Ndimensions; ++j)
+        {
+            simulatedEstimates(s, 2 + 2*j) = parameterMean(j);
+            simulatedEstimates(s, 3 + 2*j) = sqrt(max(0.0, parameterSecondMoment(j) - parameterMean(j)*parameterMean(j)));
+        }
+    }
+
+    return simulatedEstimates;
+}
+
+
+
+
+
+
+
+
+
+
+// Results::writeJointMarginalDistributionsToFile()
+//
+// PURPOSE:
+//      Computes the joint marginal distributions of pairs of free parameters, i.e. the weighted 
+//      2D histograms of a corner plot, and writes them in a single binary file. The bins of each 
+//      parameter follow Scott's normal reference rule, as for the 1D marginal distributions, 
+//      with at most maxNbins bins per parameter.
+//
+// INPUT:
+//      fileName:           a string variable containing the file name of the output file to be saved.
+//      parameterPairs:     the pairs of parameter numbers to consider. If empty, all the 
+//                          Ndimensions*(Ndimensions-1)/2 pairs (i,j) with i < j are considered.
+//      maxNbins:           the largest number of bins per parameter (at most 65535).
+//
+// OUTPUT:
+//      void
+//
+// REMARK:
+//      File layout (native byte order): the number of grids as a uint64_t, followed by each grid 
+//      as a JointMarginalHeader and Nbins1*Nbins2 doubles, row after row (i.e. Nbins2 values per bin
+//      of the first parameter). Each value is the posterior probability contained in the bin.
+//      The last bin of each parameter extends up to the largest value of the parameter.
+//
+//      The bin of each point is computed once for every parameter, so that the sample itself is read
+//      only once. The histograms are then filled in tiles of pairs whose grids fit in the cache, 
+//      each tile by one pass over blocks of points. When OpenMP is enabled, each thread fills its own copy
+//      of the tile from a subset of the blocks, and the copies are summed in thread order at the end,
+//      so that the output is reproducible for a given number of threads.
+//
+
+void Results::writeJointMarginalDistributionsToFile(string fileName, vector<pair<int, int> > parameterPairs, const int maxNbins)
+{
+    const ArrayXXd &posteriorSample = nestedSampler.getPosteriorSample();
+    const int Ndimensions = posteriorSample.rows();
+    const int sampleSize = posteriorSample.cols();
+    ArrayXd posteriorDistribution = posteriorProbability();
+    assert((maxNbins > 0) && (maxNbins <= 65535));
+
+
+    // Take all the pairs of parameters, if none is given
+
+    if (parameterPairs.empty())
+    {
+        for (int i = 0; i < Ndimensions; ++i)
+            for (int j = i+1; j < Ndimensions; ++j)
+                parameterPairs.push_back(make_pair(i, j));
+    }
+
+    for (size_t k = 0; k < parameterPairs.size(); ++k)
+    {
+        if ((parameterPairs[k].first < 0) || (parameterPairs[k].first >= Ndimensions) 
+            || (parameterPairs[k].second < 0) || (parameterPairs[k].second >= Ndimensions))
+        {
+            cerr << "Error: invalid pair of parameters (" << parameterPairs[k].first << ", " 
+                 << parameterPairs[k].second << ") for a posterior sample of " << Ndimensions << " dimensions" << endl;
+            exit(EXIT_FAILURE);
+        }
+    }
+
+
+    // Compute the binning of each parameter from its second moment and its range
+
+    ArrayXd parameterMean = (posteriorSample.matrix() * posteriorDistribution.matrix()).array();
+    ArrayXd secondMoment = ((posteriorSample.colwise() - parameterMean).square().matrix() * posteriorDistribution.matrix()).array();
+    ArrayXd parameterMinimum = posteriorSample.rowwise().minCoeff();
+    ArrayXd parameterMaximum = posteriorSample.rowwise().maxCoeff();
+    vector<int> Nbins(Ndimensions);
+    ArrayXd binWidth(Ndimensions);
+
+    for (int i = 0; i < Ndimensions; ++i)
+    {
+        computeScottBinning(secondMoment(i), sampleSize, parameterMinimum(i), parameterMaximum(i), maxNbins, Nbins[i], binWidth(i));
+
+        if (Nbins[i] < 1 || !(binWidth(i) > 0.0))
+        {
+            // A parameter with a narrow range (or a constant one) gets a single bin
+
+            Nbins[i] = 1;
+            binWidth(i) = parameterMaximum(i) - parameterMinimum(i);
+        }
+    }
+
+
+    // Find the bin of each point for each parameter, in a single pass over the sample.
+    // The bins of a parameter are stored contiguously, one row of sampleSize values per parameter.
+
+    vector<uint16_t> binIndices(static_cast<size_t>(Ndimensions) * sampleSize);
+
+    #ifdef _OPENMP
+    #pragma omp parallel for schedule(static)
+    #endif
+    for (int n = 0; n < sampleSize; ++n)
+    {
+        for (int i = 0; i < Ndimensions; ++i)
+        {
+            int binIndex = 0;
+
+            if (Nbins[i] > 1)
+                binIndex = min(Nbins[i] - 1, max(0, static_cast<int>((posteriorSample(i,n) - parameterMinimum(i)) / binWidth(i))));
+
+            binIndices[static_cast<size_t>(i) * sampleSize + n] = binIndex;
+        }
+    }
+
+
+    // Open the output file
+
+    string fullPath = nestedSampler.getOutputPathPrefix() + fileName;
+    ofstream outputFile(fullPath.c_str(), ios::out | ios::binary);
+
+    if (!outputFile.good())
+    {
+        cerr << "Error opening output file " << fullPath << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    uint64_t Ngrids = parameterPairs.size();
+    outputFile.write(reinterpret_cast<const char*>(&Ngrids), sizeof(uint64_t));
+
+
+    // Fill the histograms in tiles of pairs of about 1 MB, and blocks of points
+
+    const size_t maxNcellsPerTile = 131072;
+    const int NpointsPerBlock = 8192;
+    const int Nblocks = (sampleSize + NpointsPerBlock - 1) / NpointsPerBlock;
+    size_t firstPair = 0;
+    int Nthreads = 1;
+
+    #ifdef _OPENMP
+    Nthreads = omp_get_max_threads();
+    #endif
+
+    while (firstPair < parameterPairs.size())
+    {
+        // Collect the pairs of the tile, at least one
+
+        vector<size_t> gridOffsets(1, 0);
+        size_t lastPair = firstPair;
+
+        while (lastPair < parameterPairs.size())
+        {
+            size_t Ncells = static_cast<size_t>(Nbins[parameterPairs[lastPair].first]) * Nbins[parameterPairs[lastPair].second];
+
+            if ((lastPair > firstPair) && (gridOffsets.back() + Ncells > maxNcellsPerTile))
+                break;
+
+            gridOffsets.push_back(gridOffsets.back() + Ncells);
+            lastPair++;
+        }
+
+        // Each thread fills its own copy of the tile, so that the copies can be summed in thread order
+
+        vector<ArrayXd> partialHistograms(Nthreads, ArrayXd::Zero(gridOffsets.back()));
+
+        #ifdef _OPENMP
+        #pragma omp parallel num_threads(Nthreads)
+        #endif
+        {
+            int thread = 0;
+
+            #ifdef _OPENMP
+            thread = omp_get_thread_num();
+            #endif
+
+            #ifdef _OPENMP
+            #pragma omp for schedule(static)
+            #endif
+            for (int block = 0; block < Nblocks; ++block)
+            {
+                int firstPoint = block * NpointsPerBlock;
+                int NpointsInBlock = min(NpointsPerBlock, sampleSize - firstPoint);
+                const double *probabilities = posteriorDistribution.data() + firstPoint;
+
+                for (size_t k = firstPair; k < lastPair; ++k)
+                {
+                    double *histogram = partialHistograms[thread].data() + gridOffsets[k - firstPair];
+                    const uint16_t *binIndices1 = &binIndices[static_cast<size_t>(parameterPairs[k].first) * sampleSize + firstPoint];
+                    const uint16_t *binIndices2 = &binIndices[static_cast<size_t>(parameterPairs[k].second) * sampleSize + firstPoint];
+                    const int Nbins2 = Nbins[parameterPairs[k].second];
+
+                    for (int n = 0; n < NpointsInBlock; ++n)
+                    {
+                        histogram[binIndices1[n] * Nbins2 + binIndices2[n]] += probabilities[n];
+                    }
+                }
+            }
+        }
+
+        ArrayXd tileHistograms = partialHistograms[0];
+
+        for (int thread = 1; thread < Nthreads; ++thread)
+            tileHistograms += partialHistograms[thread];
+
+
+        // Write the grids of the tile
+
+        for (size_t k = firstPair; k < lastPair; ++k)
+        {
+            int parameterNumber1 = parameterPairs[k].first;
+            int parameterNumber2 = parameterPairs[k].second;
+
+            JointMarginalHeader header;
+            header.parameterNumber1 = parameterNumber1;
+            header.parameterNumber2 = parameterNumber2;
+            header.Nbins1 = Nbins[parameterNumber1];
+            header.Nbins2 = Nbins[parameterNumber2];
+            header.minimum1 = parameterMinimum(parameterNumber1);
+            header.binWidth1 = binWidth(parameterNumber1);
+            header.maximum1 = parameterMaximum(parameterNumber1);
+            header.minimum2 = parameterMinimum(parameterNumber2);
+            header.binWidth2 = binWidth(parameterNumber2);
+            header.maximum2 = parameterMaximum(parameterNumber2);
+
+            outputFile.write(reinterpret_cast<const char*>(&header), sizeof(JointMarginalHeader));
+            outputFile.write(reinterpret_cast<const char*>(tileHistograms.data() + gridOffsets[k - firstPair]), 
+                             header.Nbins1 * header.Nbins2 * sizeof(double));
+        }
+
+        firstPair = lastPair;
+    }
+
+    if (!outputFile.good())
+    {
+        cerr << "Error writing output file " << fullPath << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    outputFile.close();
+}
@@ -65,9 +65,7 @@ void SuperGaussianModel::predict(RefArrayXd predictions, RefArrayXd const modelP
 {
     // Define useful variables;
 
-    ArrayXd position;
-    position.resize(predictions.size());
-    position.setZero();
+    double position;
     double argument; 
 
     
@@ -77,14 +75,14 @@ void SuperGaussianModel::predict(RefArrayXd predictions, RefArrayXd const modelP
     double halfWidthOfPlateau = modelParameters(1);
     double standardDeviation = modelParameters(2);
     double amplitude = modelParameters(3);
-    
-    position = covariates - meanValue;
 
     // Perform a loop over all the covariates to compute proper value of the super Gaussian function
 
     for (int i=0; i < covariates.size(); ++i)
     {
-        if (fabs(position(i)) < halfWidthOfPlateau)
+        position = covariates(i) - meanValue;
+
+        if (fabs(position) < halfWidthOfPlateau)
         {   
             // If the point is inside the region of the plateau, set its value to the exact amplitude of the super Gaussian
             
@@ -94,7 +92,7 @@ void SuperGaussianModel::predict(RefArrayXd predictions, RefArrayXd const modelP
         {
             // If the point is outside the region of the plateau, set its prediction value to that of a Gaussian function 
             
-            argument = -0.5 * pow((fabs(position(i)) - halfWidthOfPlateau)/standardDeviation,2);
+            argument = -0.5 * pow((fabs(position) - halfWidthOfPlateau)/standardDeviation,2);
             predictions(i) = exp(argument)*amplitude;
         }
     }
@@ -0,0 +1,553 @@
+#include "WindowedModeProfileModel.h"
+
+
+// WindowedModeProfileModel::WindowedModeProfileModel()
+//
+// PURPOSE:
+//      Constructor. Initializes model computation.
+//
+// INPUT:
+//      covariates:             one-dimensional array containing the frequencies of the spectrum,
+//                              sorted in ascending order and (nearly) evenly spaced.
+//      Nmodes:                 the number of mode profiles of the model
+//      NlinewidthsInWindow:    half width of the window in which the narrow part of each profile is evaluated,
+//                              in units of its linewidth (see predict()).
+//      profileWithAmplitude:   if true, the profiles are parametrized as in Functions::modeProfileWithAmplitude(),
+//                              otherwise as in Functions::modeProfile().
+//
+
+WindowedModeProfileModel::WindowedModeProfileModel(const RefArrayXd covariates, const int Nmodes, const double NlinewidthsInWindow,
+                                                   const bool profileWithAmplitude)
+: Model(covariates),
+  Nmodes(Nmodes),
+  NlinewidthsInWindow(NlinewidthsInWindow),
+  profileWithAmplitude(profileWithAmplitude)
+{
+    Nparameters = 3*Nmodes + 1;
+    maxNcoarsePoints = min(static_cast<int>(covariates.size()), 65536);
+
+    if (covariates.size() < 2)
+    {
+        cerr << "Error: the frequency grid of the windowed mode profile model needs at least two points." << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    for (int i = 1; i < covariates.size(); ++i)
+    {
+        if (covariates(i) < covariates(i-1))
+        {
+            cerr << "Error: the frequency grid of the windowed mode profile model is not sorted in ascending order." << endl;
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    if (!(covariates(covariates.size() - 1) > covariates(0)))
+    {
+        cerr << "Error: the frequency grid of the windowed mode profile model has a null range." << endl;
+        exit(EXIT_FAILURE);
+    }
+
+
+    // A thousandth of the mean frequency resolution, below which a profile falls between the bins anyway
+
+    minLinewidth = 1.0e-3 * (covariates(covariates.size() - 1) - covariates(0)) / (covariates.size() - 1);
+}
+
+
+
+
+
+
+
+
+
+
+// WindowedModeProfileModel::~WindowedModeProfileModel()
+//
+// PURPOSE:
+//      Destructor.
+//
+
+WindowedModeProfileModel::~WindowedModeProfileModel()
+{
+
+}
+
+
+
+
+
+
+
+
+
+
+// WindowedModeProfileModel::getNmodes()
+//
+// PURPOSE:
+//      Get the protected data member Nmodes.
+//
+// OUTPUT:
+//      An integer containing the number of mode profiles.
+//
+
+int WindowedModeProfileModel::getNmodes()
+{
+    return Nmodes;
+}
+
+
+
+
+
+
+
+
+
+
+// WindowedModeProfileModel::getNlinewidthsInWindow()
+//
+// PURPOSE:
+//      Get the protected data member NlinewidthsInWindow.
+//
+// OUTPUT:
+//      A double containing the half width of the windows, in units of linewidth.
+//
+
+double WindowedModeProfileModel::getNlinewidthsInWindow()
+{
+    return NlinewidthsInWindow;
+}
+
+
+
+
+
+
+
+
+
+
+// WindowedModeProfileModel::predict()
+//
+// PURPOSE:
+//      Builds the predictions of a sum of Lorentzian profiles over a flat background, 
+//      using the scratch arrays of the workspace of the calling thread.
+//
+// INPUT:
+//      predictions:        one-dimensional array to contain the predictions
+//                          from the model
+//      modelParameters:    one-dimensional array where each element
+//                          contains the value of a free parameter of the model.
+//                          The order is centroid, height (or amplitude), linewidth of each mode in turn,
+//                          and then the background level, as the last parameter.
+//
+// OUTPUT:
+//      void
+//
+
+void WindowedModeProfileModel::predict(RefArrayXd predictions, const RefArrayXd modelParameters)
+{
+    predict(predictions, modelParameters, EvaluationWorkspace::getThreadWorkspace());
+}
+
+
+
+
+
+
+
+
+
+
+// WindowedModeProfileModel::predict()
+//
+// PURPOSE:
+//      Same as above, using the scratch arrays of the given workspace.
+//      Each Lorentzian profile, with window half width s = NlinewidthsInWindow*linewidth, is split into
+//      a broad part, smooth on the scale s (see computeBroadPart()), and a narrow part, the difference of 
+//      the profile and of its broad part. The broad parts of all the modes are summed on a coarse grid, 
+//      with a spacing of s/8 for the narrowest window, and then linearly interpolated. The narrow part of 
+//      each mode is computed exactly inside its window, and neglected outside. The cost is hence 
+//      O(Nbins + Nmodes*(Ncoarse + window size + log Nbins)) rather than O(Nmodes*Nbins).
+//      The coarse grid has at most maxNcoarsePoints points. If this limit makes its spacing larger than s/8
+//      for some modes, the windows of these modes are widened to 8 coarse spacings, so that their broad parts 
+//      remain smooth on the coarse grid.
+//
+// INPUT:
+//      predictions:        one-dimensional array to contain the predictions
+//                          from the model
+//      modelParameters:    one-dimensional array where each element
+//                          contains the value of a free parameter of the model.
+//      workspace:          the workspace of the calling thread, for the coarse grid.
+//
+// OUTPUT:
+//      void
+//
+// REMARK:
+//      Outside its window, the neglected narrow part of a profile is below a fraction 1/2^NbroadTerms of the profile itself.
+//      Linewidths that are not positive, e.g. drawn from a prior that allows them, are raised to minLinewidth
+//      (see getLinewidth()), so that the predictions remain finite and the sampler is not stopped.
+//
+
+void WindowedModeProfileModel::predict(RefArrayXd predictions, const RefArrayXd modelParameters, EvaluationWorkspace &workspace)
+{
+    const int Nbins = covariates.size();
+    const double *frequencies = covariates.data();
+    const double frequencyMinimum = covariates(0);
+    const double background = modelParameters(3*Nmodes);
+
+
+    // Set the coarse grid according to the narrowest window
+
+    int NcoarsePoints;
+    double coarseSpacing;
+    double minAllowedHalfWindow = setCoarseGrid(modelParameters, NcoarsePoints, coarseSpacing);
+
+    ArrayXd &coarseArray = workspace.getModelArray(0, maxNcoarsePoints);
+    auto coarsePrediction = coarseArray.head(NcoarsePoints);
+
+
+    // Sum the broad parts of all the modes on the coarse grid
+
+    coarsePrediction.setConstant(background);
+
+    for (int mode = 0; mode < Nmodes; ++mode)
+    {
+        double centroid = modelParameters(3*mode);
+        double linewidth = getLinewidth(modelParameters, mode);
+        double height = modelParameters(3*mode + 1);
+
+        if (profileWithAmplitude)
+            height = height*height/(Functions::PI * linewidth);
+
+        double halfWindow = max(NlinewidthsInWindow * linewidth, minAllowedHalfWindow);
+        double scale = height*linewidth*linewidth/4.0;
+        double delta = halfWindow*halfWindow - linewidth*linewidth/4.0;
+
+        for (int j = 0; j < NcoarsePoints; ++j)
+        {
+            double distance = frequencyMinimum + j*coarseSpacing - centroid;
+            coarsePrediction(j) += computeBroadPart(distance*distance, scale, halfWindow*halfWindow, delta);
+        }
+    }
+
+
+    // Interpolate linearly the broad parts on the frequency grid
+
+    for (int i = 0; i < Nbins; ++i)
+    {
+        double position = (frequencies[i] - frequencyMinimum) / coarseSpacing;
+        int index = min(static_cast<int>(position), NcoarsePoints - 2);
+        double fraction = position - index;
+        
+        predictions(i) = (1.0 - fraction)*coarsePrediction(index) + fraction*coarsePrediction(index + 1);
+    }
+
+
+    // Add the narrow part of each mode inside its window
+
+    for (int mode = 0; mode < Nmodes; ++mode)
+    {
+        double centroid = modelParameters(3*mode);
+        double linewidth = getLinewidth(modelParameters, mode);
+        double height = modelParameters(3*mode + 1);
+
+        if (profileWithAmplitude)
+            height = height*height/(Functions::PI * linewidth);
+
+        double halfWindow = max(NlinewidthsInWindow * linewidth, minAllowedHalfWindow);
+        int beginIndex = lower_bound(frequencies, frequencies + Nbins, centroid - halfWindow) - frequencies;
+        int endIndex = upper_bound(frequencies, frequencies + Nbins, centroid + halfWindow) - frequencies;
+
+        double scale = height*linewidth*linewidth/4.0;
+        double delta = halfWindow*halfWindow - linewidth*linewidth/4.0;
+
+        for (int i = beginIndex; i < endIndex; ++i)
+        {
+            double distanceSquared = (frequencies[i] - centroid)*(frequencies[i] - centroid);
+            predictions(i) += scale/(distanceSquared + linewidth*linewidth/4.0) 
+                            - computeBroadPart(distanceSquared, scale, halfWindow*halfWindow, delta);
+        }
+    }
+}
+
+
+
+
+
+
+
+
+
+
+// WindowedModeProfileModel::predictBlock()
+//
+// PURPOSE:
+//      Same as predict(), but only for the bins begin, ..., begin + size - 1 of the frequency grid.
+//      Used by FusedLikelihood to evaluate the model one block at a time, while the block is in the cache.
+//      Only the points of the coarse grid that the block needs are computed, one after the other
+//      as the bins of the block reach them, and only the windows that overlap the block are visited.
+//      The predictions are identical to those of predict(), and no memory is allocated, so that
+//      several threads can predict different blocks at the same time.
+//
+// INPUT:
+//      predictions:        pointer to the size elements to contain the predictions
+//      begin:              index of the first bin of the block
+//      size:               number of bins of the block
+//      modelParameters:    one-dimensional array where each element
+//                          contains the value of a free parameter of the model
+//
+// OUTPUT:
+//      void
+//
+// REMARK:
+//      Each block also computes the two coarse points around its first bin, so that the cost
+//      of the broad parts grows by 2*Nmodes evaluations per block with respect to predict().
+//
+
+void WindowedModeProfileModel::predictBlock(double *predictions, const int begin, const int size, const RefArrayXd modelParameters)
+{
+    const int end = begin + size;
+    const double *frequencies = covariates.data();
+    const double frequencyMinimum = covariates(0);
+
+    int NcoarsePoints;
+    double coarseSpacing;
+    double minAllowedHalfWindow = setCoarseGrid(modelParameters, NcoarsePoints, coarseSpacing);
+
+
+    // Interpolate linearly the broad parts on the bins of the block. As the frequencies are sorted,
+    // the coarse interval of the bins can only move forward.
+
+    int index = -1;
+    double leftCoarsePrediction = 0.0;
+    double rightCoarsePrediction = 0.0;
+
+    for (int i = begin; i < end; ++i)
+    {
+        double position = (frequencies[i] - frequencyMinimum) / coarseSpacing;
+        int newIndex = min(static_cast<int>(position), NcoarsePoints - 2);
+
+        if (newIndex != index)
+        {
+            if ((index >= 0) && (newIndex == index + 1))
+                leftCoarsePrediction = rightCoarsePrediction;
+            else
+                leftCoarsePrediction = sumBroadParts(newIndex, modelParameters, coarseSpacing, minAllowedHalfWindow);
+
+            rightCoarsePrediction = sumBroadParts(newIndex + 1, modelParameters, coarseSpacing, minAllowedHalfWindow);
+            index = newIndex;
+        }
+
+        double fraction = position - index;
+        predictions[i - begin] = (1.0 - fraction)*leftCoarsePrediction + fraction*rightCoarsePrediction;
+    }
+
+
+    // Add the narrow part of each mode whose window overlaps the block
+
+    for (int mode = 0; mode < Nmodes; ++mode)
+    {
+        double centroid = modelParameters(3*mode);
+        double linewidth = getLinewidth(modelParameters, mode);
+        double height = modelParameters(3*mode + 1);
+        double halfWindow = max(NlinewidthsInWindow * linewidth, minAllowedHalfWindow);
+
+        if ((centroid + halfWindow < frequencies[begin]) || (centroid - halfWindow > frequencies[end - 1]))
+            continue;
+
+        if (profileWithAmplitude)
+            height = height*height/(Functions::PI * linewidth);
+
+        int beginIndex = lower_bound(frequencies + begin, frequencies + end, centroid - halfWindow) - frequencies;
+        int endIndex = upper_bound(frequencies + begin, frequencies + end, centroid + halfWindow) - frequencies;
+
+        double scale = height*linewidth*linewidth/4.0;
+        double delta = halfWindow*halfWindow - linewidth*linewidth/4.0;
+
+        for (int i = beginIndex; i < endIndex; ++i)
+        {
+            double distanceSquared = (frequencies[i] - centroid)*(frequencies[i] - centroid);
+            predictions[i - begin] += scale/(distanceSquared + linewidth*linewidth/4.0) 
+                                    - computeBroadPart(distanceSquared, scale, halfWindow*halfWindow, delta);
+        }
+    }
+}
+
+
+
+
+
+
+
+
+
+
+// WindowedModeProfileModel::getLinewidth()
+//
+// PURPOSE:
+//      Gets the linewidth of a mode from the free parameters, raised to minLinewidth if it is smaller.
+//
+// INPUT:
+//      modelParameters:    one-dimensional array where each element
+//                          contains the value of a free parameter of the model
+//      mode:               the number of the mode
+//
+// OUTPUT:
+//      The linewidth of the mode, at least minLinewidth.
+//
+// REMARK:
+//      A linewidth that is not positive, or not a number, would make the predictions infinite or not a number.
+//      It is replaced by minLinewidth, whose profile is narrower than the bins and adds no power but at most
+//      one spike, so that the point is merely given a low likelihood.
+//
+
+inline double WindowedModeProfileModel::getLinewidth(const RefArrayXd modelParameters, const int mode)
+{
+    double linewidth = modelParameters(3*mode + 2);
+
+    if (linewidth > minLinewidth)
+        return linewidth;
+    else
+        return minLinewidth;
+}
+
+
+
+
+
+
+
+
+
+
+// WindowedModeProfileModel::setCoarseGrid()
+//
+// PURPOSE:
+//      Sets the coarse grid of the broad parts according to the narrowest window, with a spacing 
+//      of 1/NcoarseSpacingsInHalfWindow of its half width, and at most maxNcoarsePoints points.
+//
+// INPUT:
+//      modelParameters:    one-dimensional array where each element
+//                          contains the value of a free parameter of the model
+//      NcoarsePoints:      on output, the number of points of the coarse grid
+//      coarseSpacing:      on output, the spacing of the coarse grid
+//
+// OUTPUT:
+//      The smallest window half width allowed by the coarse grid. Narrower windows are widened to it.
+//
+
+double WindowedModeProfileModel::setCoarseGrid(const RefArrayXd modelParameters, int &NcoarsePoints, double &coarseSpacing)
+{
+    const double frequencyMinimum = covariates(0);
+    const double frequencyMaximum = covariates(covariates.size() - 1);
+
+    double minHalfWindow = frequencyMaximum - frequencyMinimum;
+
+    for (int mode = 0; mode < Nmodes; ++mode)
+    {
+        double linewidth = getLinewidth(modelParameters, mode);
+        minHalfWindow = min(minHalfWindow, NlinewidthsInWindow * linewidth);
+    }
+
+    NcoarsePoints = static_cast<int>(ceil(NcoarseSpacingsInHalfWindow * (frequencyMaximum - frequencyMinimum) / minHalfWindow)) + 1;
+    NcoarsePoints = max(2, min(NcoarsePoints, maxNcoarsePoints));
+    coarseSpacing = (frequencyMaximum - frequencyMinimum) / (NcoarsePoints - 1);
+
+    return NcoarseSpacingsInHalfWindow * coarseSpacing;
+}
+
+
+
+
+
+
+
+
+
+
+// WindowedModeProfileModel::sumBroadParts()
+//
+// PURPOSE:
+//      Computes the background plus the broad parts of all the modes at one point of the coarse grid,
+//      adding the modes in the same order as predict(), so that the result is the same.
+//
+// INPUT:
+//      coarseIndex:            index of the point of the coarse grid
+//      modelParameters:        one-dimensional array where each element
+//                              contains the value of a free parameter of the model
+//      coarseSpacing:          the spacing of the coarse grid
+//      minAllowedHalfWindow:   the smallest window half width allowed by the coarse grid
+//
+// OUTPUT:
+//      The sum of the broad parts at the coarse point.
+//
+
+double WindowedModeProfileModel::sumBroadParts(const int coarseIndex, const RefArrayXd modelParameters, const double coarseSpacing,
+                                               const double minAllowedHalfWindow)
+{
+    const double frequencyMinimum = covariates(0);
+    double coarsePrediction = modelParameters(3*Nmodes);
+
+    for (int mode = 0; mode < Nmodes; ++mode)
+    {
+        double centroid = modelParameters(3*mode);
+        double linewidth = getLinewidth(modelParameters, mode);
+        double height = modelParameters(3*mode + 1);
+
+        if (profileWithAmplitude)
+            height = height*height/(Functions::PI * linewidth);
+
+        double halfWindow = max(NlinewidthsInWindow * linewidth, minAllowedHalfWindow);
+        double scale = height*linewidth*linewidth/4.0;
+        double delta = halfWindow*halfWindow - linewidth*linewidth/4.0;
+        double distance = frequencyMinimum + coarseIndex*coarseSpacing - centroid;
+
+        coarsePrediction += computeBroadPart(distance*distance, scale, halfWindow*halfWindow, delta);
+    }
+
+    return coarsePrediction;
+}
+
+
+
+
+
+
+
+
+
+
+// WindowedModeProfileModel::computeBroadPart()
+//
+// PURPOSE:
+//      Computes the broad part of a Lorentzian profile scale/(d^2 + w^2/4), as the first terms of the 
+//      expansion scale/u * sum_j (delta/u)^j, with u = d^2 + s^2 and delta = s^2 - w^2/4, whose 
+//      full sum is the profile itself. The remainder, i.e. the narrow part, falls off as 1/d^(2*NbroadTerms + 2)
+//      and is at most a fraction 1/2^NbroadTerms of the profile beyond the window half width s.
+//
+// INPUT:
+//      distanceSquared:        the squared distance d^2 from the centroid
+//      scale:                  the height times w^2/4
+//      halfWindowSquared:      the squared window half width s^2
+//      delta:                  s^2 - w^2/4
+//
+// OUTPUT:
+//      The value of the broad part at the given distance.
+//
+
+inline double WindowedModeProfileModel::computeBroadPart(const double distanceSquared, const double scale, 
+                                                         const double halfWindowSquared, const double delta)
+{
+    double inverseU = 1.0/(distanceSquared + halfWindowSquared);
+    double ratio = delta*inverseU;
+    double sum = 1.0;
+
+    for (int j = 1; j < NbroadTerms; ++j)
+    {
+        sum = 1.0 + ratio*sum;
+    }
+
+    return scale*inverseU*sum;
+}
@@ -45,7 +45,6 @@ int main(int argc, char *argv[])
     // ----- Read input data -----
     // ---------------------------
 
-    unsigned long Nrows;
     int Ncols;
     int Nobservables;       // Number of independent covariates of the dataset
     int Npoints;            // Number of data points for each covariate (must be all the same)
@@ -55,11 +54,8 @@ int main(int argc, char *argv[])
     string inputFileName(argv[1]);
     string outputPathPrefix = "GaussianFit_";
 
-    ifstream inputFile;
-    File::openInputFile(inputFile, inputFileName);
-    File::sniffFile(inputFile, Nrows, Ncols);
-    data = File::arrayXXdFromFile(inputFile, Nrows, Ncols);
-    inputFile.close();
+    data = File::arrayXXdFromFile(inputFileName);
+    Ncols = data.cols();
 
     Nobservables = Ncols - 2;
 
@@ -92,6 +88,7 @@ int main(int argc, char *argv[])
 
     // ---- Read prior hyper parameters for resolved modes -----
     string inputFileNamePrior(argv[2]);
+    ifstream inputFile;
     File::openInputFile(inputFile, inputFileNamePrior);
     File::sniffFile(inputFile, Nparameters, Ncols);
     ArrayXXd hyperParameters;
@@ -45,18 +45,14 @@ int main(int argc, char *argv[])
     // ----- Read input data -----
     // ---------------------------
 
-    unsigned long Nrows;
     int Ncols;
     ArrayXXd data;
     string baseInputDirName = "";
     string inputFileName(argv[1]);
     string outputPathPrefix = "PolynomialFit_";
 
-    ifstream inputFile;
-    File::openInputFile(inputFile, inputFileName);
-    File::sniffFile(inputFile, Nrows, Ncols);
-    data = File::arrayXXdFromFile(inputFile, Nrows, Ncols);
-    inputFile.close();
+    data = File::arrayXXdFromFile(inputFileName);
+    Ncols = data.cols();
 
 
     // Creating arrays for each data type
@@ -76,6 +72,7 @@ int main(int argc, char *argv[])
 
     // ---- Read prior hyper parameters for resolved modes -----
     string inputFileNamePrior(argv[2]);
+    ifstream inputFile;
     File::openInputFile(inputFile, inputFileNamePrior);
     File::sniffFile(inputFile, Nparameters, Ncols);
     ArrayXXd hyperParameters;
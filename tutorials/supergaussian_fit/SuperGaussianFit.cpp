@@ -45,7 +45,6 @@ int main(int argc, char *argv[])
     // ----- Read input data -----
     // ---------------------------
 
-    unsigned long Nrows;
     int Ndimensions;              // Number of parameters for which prior distributions are defined
     int Ncols;
     ArrayXXd data;
@@ -54,11 +53,8 @@ int main(int argc, char *argv[])
     string inputFileName(argv[1]);
     string outputPathPrefix = "SuperGaussianFit_";
 
-    ifstream inputFile;
-    File::openInputFile(inputFile, inputFileName);
-    File::sniffFile(inputFile, Nrows, Ncols);
-    data = File::arrayXXdFromFile(inputFile, Nrows, Ncols);
-    inputFile.close();
+    data = File::arrayXXdFromFile(inputFileName);
+    Ncols = data.cols();
 
 
     // Creating arrays for each data type
@@ -77,6 +73,7 @@ int main(int argc, char *argv[])
 
     // ---- Read prior hyper parameters for resolved modes -----
     string inputFileNamePrior(argv[2]);
+    ifstream inputFile;
     File::openInputFile(inputFile, inputFileNamePrior);
     File::sniffFile(inputFile, Nparameters, Ncols);
     ArrayXXd hyperParameters;